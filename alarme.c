@@ -0,0 +1,97 @@
+#include "bitdoglab.h"
+#include "alarme.h"
+#include "core1_worker.h"
+#include "metricas.h"
+
+static async_context_t *ctx;
+static async_at_time_worker_t alarme_worker;
+static alarme_sequenciador_t sequenciador;
+static absolute_time_t proximo_passo;
+static bool ativo;
+static alarme_observador_fn observador;
+static alarme_padrao_t padrao_atual = ALARME_SIRENE;
+static tom_t tom_atual = TOM_TEMPORAL3;
+static uint16_t unidades_ms[NUM_PADROES_ALARME] = {
+    ALARME_UNIDADE_SIRENE_MS, ALARME_UNIDADE_PULSO_MS, ALARME_UNIDADE_SOS_MS,
+};
+
+// Cada passo só troca as saídas e agenda o próximo em tempo absoluto (sem deriva)
+static void alarme_worker_fn(async_context_t *context, async_at_time_worker_t *worker) {
+    if (!ativo) return;
+    bool ligado;
+    uint32_t duracao = alarme_sequenciador_avancar(&sequenciador, &ligado);
+    core1_definir_saida(LED_RED, ligado);
+    if (tom_atual == TOM_CONTINUO) core1_definir_saida(BUZZER, ligado);
+    proximo_passo = delayed_by_ms(proximo_passo, duracao);
+    async_context_add_at_time_worker_at(context, worker, proximo_passo);
+}
+
+// Sirene gira o giroflex; pulso e SOS piscam a matriz inteira
+static matriz_padrao_t alarme_padrao_matriz(void) {
+    return padrao_atual == ALARME_SIRENE ? MATRIZ_GIRO : MATRIZ_ESTROBO;
+}
+
+void alarme_iniciar(async_context_t *context) {
+    ctx = context;
+    alarme_worker.do_work = alarme_worker_fn;
+}
+
+void alarme_observar(alarme_observador_fn fn) {
+    observador = fn;
+}
+
+void alarme_ativar(void) {
+    if (ativo) return;
+    ativo = true;
+    METRICA_CONTAR(MC_ALARME_ATIVACOES);
+    alarme_sequenciador_init(&sequenciador, padrao_atual, unidades_ms[padrao_atual]);
+    core1_mostrar_tela(TELA_EVACUAR);
+    core1_mostrar_matriz(alarme_padrao_matriz());
+    // Os demais tons são sequenciados pelo PWM no core1, independentes deste worker
+    if (tom_atual != TOM_CONTINUO) core1_tocar_tom(tom_atual);
+    proximo_passo = get_absolute_time();
+    async_context_add_at_time_worker_at(ctx, &alarme_worker, proximo_passo);
+    if (observador) observador(true);
+}
+
+void alarme_desativar(void) {
+    bool estava = ativo;
+    if (ativo) async_context_remove_at_time_worker(ctx, &alarme_worker);
+    ativo = false;
+    core1_definir_saida(LED_RED, 0);
+    core1_definir_saida(BUZZER, 0);
+    core1_mostrar_tela(TELA_REPOUSO);
+    core1_mostrar_matriz(MATRIZ_REPOUSO);
+    if (estava && observador) observador(false);
+}
+
+bool alarme_esta_ativo(void) {
+    return ativo;
+}
+
+// Com o alarme tocando, a sequência recomeça na hora do início do novo padrão
+void alarme_definir_padrao(alarme_padrao_t padrao, uint16_t unidade_ms) {
+    if (padrao >= NUM_PADROES_ALARME) return;
+    unidade_ms = alarme_unidade_valida(padrao, unidade_ms);
+    unidades_ms[padrao] = unidade_ms;
+    padrao_atual = padrao;
+    if (!ativo) return;
+    alarme_sequenciador_init(&sequenciador, padrao, unidade_ms);
+    core1_mostrar_matriz(alarme_padrao_matriz());
+}
+
+alarme_padrao_t alarme_padrao(void) {
+    return padrao_atual;
+}
+
+void alarme_definir_tom(tom_t tom) {
+    if (tom >= NUM_TONS) return;
+    tom_atual = tom;
+    if (!ativo) return;
+    if (tom != TOM_CONTINUO) core1_tocar_tom(tom);
+    else core1_definir_saida(BUZZER, 0); // o worker volta a ligar no próximo passo
+}
+
+tom_t alarme_tom(void) {
+    return tom_atual;
+}
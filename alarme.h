@@ -0,0 +1,27 @@
+#ifndef ALARME_H
+#define ALARME_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pico/async_context.h"
+#include "alarme_seq.h"
+#include "sirene_seq.h"
+
+// Chamado a cada transição real do alarme, venha ela de HTTP, botões, microfone ou da malha
+typedef void (*alarme_observador_fn)(bool ativo);
+
+// As funções abaixo rodam no async_context (callbacks do lwIP ou workers)
+void alarme_iniciar(async_context_t *context);
+void alarme_observar(alarme_observador_fn fn);
+void alarme_ativar(void);
+void alarme_desativar(void);
+bool alarme_esta_ativo(void);
+
+void alarme_definir_padrao(alarme_padrao_t padrao, uint16_t unidade_ms);
+alarme_padrao_t alarme_padrao(void);
+
+// Tom do buzzer durante o alarme; TOM_CONTINUO faz o buzzer acompanhar o padrão de luz
+void alarme_definir_tom(tom_t tom);
+tom_t alarme_tom(void);
+
+#endif
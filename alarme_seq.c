@@ -0,0 +1,65 @@
+#include <string.h>
+#include "alarme_seq.h"
+
+#define NUM_PASSOS(v) ((uint8_t)(sizeof(v) / sizeof((v)[0])))
+
+typedef struct {
+    uint8_t ligado;
+    uint8_t unidades;
+} alarme_passo_t;
+
+static const alarme_passo_t PASSOS_SIRENE[] = {{1, 1}, {0, 1}};
+static const alarme_passo_t PASSOS_PULSO[] = {{1, 1}, {0, 4}};
+static const alarme_passo_t PASSOS_SOS[] = {
+    {1, 1}, {0, 1}, {1, 1}, {0, 1}, {1, 1}, {0, 3}, // S
+    {1, 3}, {0, 1}, {1, 3}, {0, 1}, {1, 3}, {0, 3}, // O
+    {1, 1}, {0, 1}, {1, 1}, {0, 1}, {1, 1}, {0, 7}, // S + pausa entre palavras
+};
+
+static const struct {
+    const char *nome;
+    const alarme_passo_t *passos;
+    uint8_t num_passos;
+    uint16_t unidade_padrao_ms;
+} PADROES[NUM_PADROES_ALARME] = {
+    [ALARME_SIRENE] = {"sirene", PASSOS_SIRENE, NUM_PASSOS(PASSOS_SIRENE), ALARME_UNIDADE_SIRENE_MS},
+    [ALARME_PULSO] = {"pulso", PASSOS_PULSO, NUM_PASSOS(PASSOS_PULSO), ALARME_UNIDADE_PULSO_MS},
+    [ALARME_SOS] = {"sos", PASSOS_SOS, NUM_PASSOS(PASSOS_SOS), ALARME_UNIDADE_SOS_MS},
+};
+
+void alarme_sequenciador_init(alarme_sequenciador_t *s, alarme_padrao_t padrao, uint16_t unidade_ms) {
+    s->padrao = padrao;
+    s->unidade_ms = unidade_ms;
+    s->indice = 0;
+}
+
+uint32_t alarme_sequenciador_avancar(alarme_sequenciador_t *s, bool *ligado) {
+    const alarme_passo_t *passo = &PADROES[s->padrao].passos[s->indice];
+    *ligado = passo->ligado;
+    if (++s->indice >= PADROES[s->padrao].num_passos) s->indice = 0;
+    return (uint32_t)passo->unidades * s->unidade_ms;
+}
+
+uint32_t alarme_unidades_ciclo(alarme_padrao_t padrao) {
+    if (padrao >= NUM_PADROES_ALARME) return 0;
+    uint32_t total = 0;
+    for (int i = 0; i < PADROES[padrao].num_passos; i++) total += PADROES[padrao].passos[i].unidades;
+    return total;
+}
+
+uint16_t alarme_unidade_valida(alarme_padrao_t padrao, uint16_t unidade_ms) {
+    if (unidade_ms == 0 && padrao < NUM_PADROES_ALARME) unidade_ms = PADROES[padrao].unidade_padrao_ms;
+    if (unidade_ms > ALARME_UNIDADE_MAX_MS) return ALARME_UNIDADE_MAX_MS;
+    return unidade_ms < ALARME_UNIDADE_MIN_MS ? ALARME_UNIDADE_MIN_MS : unidade_ms;
+}
+
+const char *alarme_nome_padrao(alarme_padrao_t padrao) {
+    return padrao < NUM_PADROES_ALARME ? PADROES[padrao].nome : "";
+}
+
+alarme_padrao_t alarme_padrao_por_nome(const char *nome, int len) {
+    for (int i = 0; i < NUM_PADROES_ALARME; i++) {
+        if ((int)strlen(PADROES[i].nome) == len && strncmp(PADROES[i].nome, nome, len) == 0) return i;
+    }
+    return NUM_PADROES_ALARME;
+}
@@ -0,0 +1,46 @@
+#ifndef ALARME_SEQ_H
+#define ALARME_SEQ_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Padrões de luz do alarme: só tabelas e aritmética, sem SDK, para rodar também no host
+
+typedef enum {
+    ALARME_SIRENE, // liga/desliga simétrico
+    ALARME_PULSO,  // pulso curto seguido de pausa longa
+    ALARME_SOS,    // ... --- ... em código Morse
+    NUM_PADROES_ALARME
+} alarme_padrao_t;
+
+// Duração base de cada padrão (ms por unidade de passo)
+#define ALARME_UNIDADE_SIRENE_MS 500
+#define ALARME_UNIDADE_PULSO_MS 200
+#define ALARME_UNIDADE_SOS_MS 150
+#define ALARME_UNIDADE_MIN_MS 20
+#define ALARME_UNIDADE_MAX_MS 2000 // SOS leva 34 unidades: pouco mais de um minuto por ciclo
+
+// Sequenciador puro: não toca em hardware nem em timers
+typedef struct {
+    alarme_padrao_t padrao;
+    uint16_t unidade_ms;
+    uint8_t indice;
+} alarme_sequenciador_t;
+
+void alarme_sequenciador_init(alarme_sequenciador_t *s, alarme_padrao_t padrao, uint16_t unidade_ms);
+
+// Devolve o nível do passo atual em *ligado e sua duração em ms, e avança
+uint32_t alarme_sequenciador_avancar(alarme_sequenciador_t *s, bool *ligado);
+
+// Unidades de um ciclo completo do padrão (o período é isto vezes unidade_ms)
+uint32_t alarme_unidades_ciclo(alarme_padrao_t padrao);
+
+// 0 escolhe a unidade padrão; fora de [ALARME_UNIDADE_MIN_MS, ALARME_UNIDADE_MAX_MS] é levada à faixa
+uint16_t alarme_unidade_valida(alarme_padrao_t padrao, uint16_t unidade_ms);
+
+const char *alarme_nome_padrao(alarme_padrao_t padrao);
+
+// Procura o padrão pelo nome; retorna NUM_PADROES_ALARME se não existir
+alarme_padrao_t alarme_padrao_por_nome(const char *nome, int len);
+
+#endif
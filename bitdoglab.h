@@ -0,0 +1,19 @@
+#ifndef BITDOGLAB_H
+#define BITDOGLAB_H
+
+// Pinos da placa BitDogLab usados pelo firmware
+#define LED_RED 13
+#define LED_GREEN 11
+#define LED_BLUE 12
+#define BUZZER 10
+#define BOTAO_A 5 // ativos em nível baixo, com pull-up interno
+#define BOTAO_B 6
+#define MATRIZ_LED 7 // matriz WS2812 5x5
+
+#define MICROFONE 28 // saída analógica do microfone de eletreto
+#define MICROFONE_ADC 2
+
+#define I2C_SDA 14 // display SSD1306 em i2c1
+#define I2C_SCL 15
+
+#endif
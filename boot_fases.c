@@ -0,0 +1,28 @@
+#include <stdio.h>
+#include "boot_fases.h"
+
+static const char *const NOMES[NUM_BOOT_FASES] = {
+    "stdio", "core1 lancado", "sinal local", "display", "cyw43",
+    "ap", "dhcp+dns", "http escutando", "primeira resposta",
+};
+
+// 0 = fase ainda não alcançada; nenhuma fase acontece no primeiro microssegundo
+static volatile uint32_t marcas_us[NUM_BOOT_FASES];
+
+void boot_marcar(boot_fase_t fase) {
+    if (marcas_us[fase]) return;
+    marcas_us[fase] = time_us_32();
+    // O stdio fica com o core0; as fases do core1 aparecem só no resumo
+    if (get_core_num() == 0) {
+        printf("boot: %-18s %7lu us\n", NOMES[fase], (unsigned long)marcas_us[fase]);
+    }
+    if (fase == BOOT_PRIMEIRA_RESPOSTA) boot_imprimir();
+}
+
+// Instantes absolutos: as fases do core1 correm em paralelo com as do core0
+void boot_imprimir(void) {
+    for (int i = 0; i < NUM_BOOT_FASES; i++) {
+        if (marcas_us[i]) printf("boot: %-18s %7lu us\n", NOMES[i], (unsigned long)marcas_us[i]);
+        else printf("boot: %-18s      --\n", NOMES[i]);
+    }
+}
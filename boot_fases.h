@@ -0,0 +1,26 @@
+#ifndef BOOT_FASES_H
+#define BOOT_FASES_H
+
+#include "pico/stdlib.h"
+
+// Instantes de cada fase da partida, em us desde o reset. Cada fase guarda só a
+// primeira marca, de qualquer núcleo; o core0 imprime a sua na hora e o resumo
+// sai junto com a primeira resposta HTTP (ou pela tecla 'b').
+
+typedef enum {
+    BOOT_STDIO,
+    BOOT_CORE1_LANCADO,
+    BOOT_SINAL_LOCAL,       // core1: matriz mostrando a cruz de partida
+    BOOT_DISPLAY,           // core1: SSD1306 iniciado e tela "INICIANDO" desenhada
+    BOOT_CYW43,             // firmware do Wi-Fi carregado
+    BOOT_AP,
+    BOOT_DHCP_DNS,
+    BOOT_HTTP_ESCUTANDO,
+    BOOT_PRIMEIRA_RESPOSTA,
+    NUM_BOOT_FASES
+} boot_fase_t;
+
+void boot_marcar(boot_fase_t fase);
+void boot_imprimir(void);
+
+#endif
@@ -0,0 +1,73 @@
+#include "botao_gestos.h"
+
+// Diferenças com sinal toleram a volta do contador de 32 bits (~71 min)
+static bool venceu(uint32_t agora, uint32_t prazo) {
+    return (int32_t)(agora - prazo) >= 0;
+}
+
+void botao_init(botao_t *b) {
+    b->bruto = false;
+    b->estavel = false;
+    b->ignorar_soltura = false;
+    b->cliques = 0;
+    b->t_borda = b->t_pressao = b->t_soltura = b->t_decisao = 0;
+}
+
+void botao_borda(botao_t *b, bool pressionado, uint32_t t_us) {
+    if (pressionado == b->bruto) return;
+    b->bruto = pressionado;
+    b->t_borda = t_us;
+}
+
+static void considerar_prazo(uint32_t prazo, uint32_t *prazo_us, bool *tem_prazo) {
+    if (!*tem_prazo || (int32_t)(prazo - *prazo_us) < 0) *prazo_us = prazo;
+    *tem_prazo = true;
+}
+
+botao_gesto_t botao_avaliar(botao_t *b, uint32_t agora_us, uint32_t *prazo_us, bool *tem_prazo) {
+    botao_gesto_t gesto = GESTO_NENHUM;
+    *tem_prazo = false;
+
+    // Mudança aceita só depois de um período sem bordas; o instante é o da própria borda
+    if (b->bruto != b->estavel && venceu(agora_us, b->t_borda + BOTAO_DEBOUNCE_US)) {
+        b->estavel = b->bruto;
+        if (b->estavel) {
+            b->t_pressao = b->t_borda;
+            b->ignorar_soltura = false;
+            if (b->cliques && !venceu(b->t_pressao, b->t_soltura + BOTAO_DUPLO_US)) {
+                b->ignorar_soltura = true;
+                b->t_decisao = b->t_pressao;
+                gesto = GESTO_DUPLO;
+            } else if (b->cliques) {
+                // A janela venceu enquanto esta pressão ainda quicava: o clique anterior vale
+                b->t_decisao = b->t_soltura + BOTAO_DUPLO_US;
+                gesto = GESTO_CLIQUE;
+            }
+            b->cliques = 0;
+        } else {
+            b->t_soltura = b->t_borda;
+            if (!b->ignorar_soltura) b->cliques = 1;
+        }
+    }
+
+    // Soltura ainda em debounce não vira pressão longa: decide quando o nível assentar
+    if (gesto == GESTO_NENHUM && b->estavel && b->bruto && !b->ignorar_soltura &&
+        venceu(agora_us, b->t_pressao + BOTAO_LONGO_US)) {
+        b->ignorar_soltura = true;
+        b->cliques = 0;
+        b->t_decisao = b->t_pressao + BOTAO_LONGO_US;
+        gesto = GESTO_LONGO;
+    }
+
+    if (gesto == GESTO_NENHUM && b->cliques && !b->estavel && b->bruto == b->estavel &&
+        venceu(agora_us, b->t_soltura + BOTAO_DUPLO_US)) {
+        b->cliques = 0;
+        b->t_decisao = b->t_soltura + BOTAO_DUPLO_US;
+        gesto = GESTO_CLIQUE;
+    }
+
+    if (b->bruto != b->estavel) considerar_prazo(b->t_borda + BOTAO_DEBOUNCE_US, prazo_us, tem_prazo);
+    if (b->estavel && !b->ignorar_soltura) considerar_prazo(b->t_pressao + BOTAO_LONGO_US, prazo_us, tem_prazo);
+    if (b->cliques && !b->estavel) considerar_prazo(b->t_soltura + BOTAO_DUPLO_US, prazo_us, tem_prazo);
+    return gesto;
+}
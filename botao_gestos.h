@@ -0,0 +1,48 @@
+#ifndef BOTAO_GESTOS_H
+#define BOTAO_GESTOS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Reconhecimento de gestos a partir de bordas brutas com carimbo de tempo.
+// Só aritmética, sem SDK: o debounce é decidido por prazos, nunca por espera ativa.
+
+#ifndef BOTAO_DEBOUNCE_US
+#define BOTAO_DEBOUNCE_US 20000  // nível precisa ficar estável por este tempo
+#endif
+#ifndef BOTAO_LONGO_US
+#define BOTAO_LONGO_US 1000000
+#endif
+#ifndef BOTAO_DUPLO_US
+#define BOTAO_DUPLO_US 350000    // intervalo máximo entre soltar e pressionar de novo
+#endif
+
+typedef enum {
+    GESTO_NENHUM,
+    GESTO_CLIQUE, // emitido só quando a janela de duplo expira
+    GESTO_DUPLO,  // emitido na segunda pressão, sem esperar a soltura
+    GESTO_LONGO,  // emitido ao completar o tempo, com o botão ainda pressionado
+} botao_gesto_t;
+
+typedef struct {
+    bool bruto;           // último nível visto nas bordas (true = pressionado)
+    bool estavel;         // nível aceito após o debounce
+    bool ignorar_soltura; // a pressão já virou DUPLO ou LONGO
+    uint8_t cliques;      // pressão curta aguardando a janela de duplo
+    uint32_t t_borda;
+    uint32_t t_pressao;
+    uint32_t t_soltura;
+    uint32_t t_decisao;   // instante que decidiu o último gesto (para medir latência)
+} botao_t;
+
+void botao_init(botao_t *b);
+
+// Registra uma borda bruta. Antes, avalie o botão no instante t_us para não perder
+// gestos que venceram entre a borda anterior e esta.
+void botao_borda(botao_t *b, bool pressionado, uint32_t t_us);
+
+// Emite no máximo um gesto vencido até agora_us; chame até retornar GESTO_NENHUM.
+// *prazo_us recebe o próximo instante em que vale reavaliar (se *tem_prazo).
+botao_gesto_t botao_avaliar(botao_t *b, uint32_t agora_us, uint32_t *prazo_us, bool *tem_prazo);
+
+#endif
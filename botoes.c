@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "bitdoglab.h"
+#include "botoes.h"
+#include "spsc_ring.h"
+
+typedef struct {
+    uint8_t pino;
+    uint8_t pressionado;
+    uint32_t t_us;
+} botoes_evento_t;
+
+static const uint PINOS[] = {BOTAO_A, BOTAO_B};
+#define NUM_BOTOES count_of(PINOS)
+
+static botoes_evento_t fila_dados[BOTOES_FILA_TAM];
+static spsc_ring_t fila;
+static volatile uint32_t descartados;
+
+static botao_t botoes[NUM_BOTOES];
+static async_context_t *ctx;
+static async_when_pending_worker_t worker_bordas;
+static async_at_time_worker_t worker_prazo;
+static botoes_acao_fn acao_fn;
+
+static uint32_t acoes;
+static uint32_t latencia_max_us;
+static uint64_t latencia_total_us;
+
+// Produtor único: a IRQ de GPIO do core0
+static void botoes_irq(uint gpio, uint32_t eventos) {
+    // Ativo em nível baixo. O nível lido agora vale mais que a máscara, que pode
+    // trazer as duas bordas de um quique
+    botoes_evento_t e = {gpio, !gpio_get(gpio), time_us_32()};
+    if (!spsc_ring_push(&fila, &e)) descartados++;
+    async_context_set_work_pending(ctx, &worker_bordas);
+}
+
+static void botoes_emitir(int i, uint32_t agora_us, uint32_t *prazo, bool *tem_prazo) {
+    uint32_t p;
+    bool tem;
+    botao_gesto_t gesto;
+    while ((gesto = botao_avaliar(&botoes[i], agora_us, &p, &tem)) != GESTO_NENHUM) {
+        acao_fn(PINOS[i], gesto);
+        uint32_t latencia = time_us_32() - botoes[i].t_decisao;
+        latencia_total_us += latencia;
+        if (latencia > latencia_max_us) latencia_max_us = latencia;
+        acoes++;
+    }
+    if (tem && (!*tem_prazo || (int32_t)(p - *prazo) < 0)) {
+        *prazo = p;
+        *tem_prazo = true;
+    }
+}
+
+// Consome as bordas na ordem e reagenda o worker para o prazo mais próximo
+static void botoes_processar(void) {
+    botoes_evento_t e;
+    uint32_t prazo = 0;
+    bool tem_prazo = false;
+    while (spsc_ring_pop(&fila, &e)) {
+        for (uint i = 0; i < NUM_BOTOES; i++) {
+            if (PINOS[i] != e.pino) continue;
+            // Gestos vencidos antes desta borda saem primeiro; o prazo só importa no fim
+            botoes_emitir(i, e.t_us, &prazo, &tem_prazo);
+            botao_borda(&botoes[i], e.pressionado, e.t_us);
+        }
+    }
+    tem_prazo = false;
+    uint32_t agora = time_us_32();
+    for (uint i = 0; i < NUM_BOTOES; i++) {
+        // Com a fila cheia a IRQ perde a borda mais nova, e uma soltura perdida viraria
+        // GESTO_LONGO: o nível lido agora corrige o que faltou antes de decidir
+        botao_borda(&botoes[i], !gpio_get(PINOS[i]), agora);
+        botoes_emitir(i, agora, &prazo, &tem_prazo);
+    }
+
+    async_context_remove_at_time_worker(ctx, &worker_prazo);
+    if (tem_prazo) {
+        int32_t espera = (int32_t)(prazo - agora);
+        async_context_add_at_time_worker_at(ctx, &worker_prazo, delayed_by_us(get_absolute_time(), espera > 0 ? espera : 0));
+    }
+}
+
+static void botoes_worker_bordas(async_context_t *context, async_when_pending_worker_t *w) {
+    botoes_processar();
+}
+
+static void botoes_worker_prazo(async_context_t *context, async_at_time_worker_t *w) {
+    botoes_processar();
+}
+
+void botoes_iniciar(async_context_t *context, botoes_acao_fn acao) {
+    ctx = context;
+    acao_fn = acao;
+    spsc_ring_init(&fila, fila_dados, BOTOES_FILA_TAM, sizeof(botoes_evento_t));
+    worker_bordas.do_work = botoes_worker_bordas;
+    worker_prazo.do_work = botoes_worker_prazo;
+    async_context_add_when_pending_worker(ctx, &worker_bordas);
+
+    for (uint i = 0; i < NUM_BOTOES; i++) {
+        botao_init(&botoes[i]);
+        gpio_init(PINOS[i]);
+        gpio_set_dir(PINOS[i], GPIO_IN);
+        gpio_pull_up(PINOS[i]);
+        gpio_set_irq_enabled_with_callback(PINOS[i], GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, true, botoes_irq);
+    }
+}
+
+void botoes_imprimir_stats(void) {
+    printf("botoes: %lu acoes, latencia media %lu us, max %lu us, %lu bordas descartadas\n",
+        (unsigned long)acoes, (unsigned long)(acoes ? latencia_total_us / acoes : 0),
+        (unsigned long)latencia_max_us, (unsigned long)descartados);
+}
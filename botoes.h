@@ -0,0 +1,20 @@
+#ifndef BOTOES_H
+#define BOTOES_H
+
+#include "pico/async_context.h"
+#include "botao_gestos.h"
+
+// Botões A e B da placa. A IRQ de GPIO só carimba a borda e a coloca numa fila sem
+// trava; debounce e gestos rodam num worker do async_context guiado por prazos.
+
+#define BOTOES_FILA_TAM 16 // potência de 2
+
+typedef void (*botoes_acao_fn)(uint pino, botao_gesto_t gesto);
+
+// acao é chamada no contexto do async_context (mesmo dos callbacks do lwIP)
+void botoes_iniciar(async_context_t *context, botoes_acao_fn acao);
+
+// Tempo entre a borda que decidiu o gesto e o fim da ação
+void botoes_imprimir_stats(void);
+
+#endif
@@ -0,0 +1,219 @@
+#include <stdio.h>
+#include <string.h>
+#include "pico/multicore.h"
+#include "hardware/i2c.h"
+#include "hardware/sync.h"
+#include "bitdoglab.h"
+#include "core1_worker.h"
+#include "spsc_ring.h"
+#include "ssd1306.h"
+#include "sirene.h"
+#include "matriz.h"
+#include "metricas.h"
+#include "boot_fases.h"
+#include "diario.h"
+
+static core1_cmd_t fila_dados[CORE1_FILA_TAM];
+static spsc_ring_t fila;
+
+// Espelho no core0 das saídas pedidas, um bit por GPIO
+static volatile uint32_t saidas_pedidas;
+static rgb_cor_t cor_pedida;
+static uint32_t descartados;
+
+// Estatísticas escritas só pelo core1
+static volatile uint32_t executados;
+static volatile uint32_t telas_desenhadas;
+static volatile uint32_t latencia_max_us;
+static volatile uint64_t latencia_total_us;
+
+static uint8_t ssd[ssd1306_buffer_length];
+static struct render_area frame_area;
+static uint16_t origem_alarme;
+
+static void desenhar_tela(tela_t tela) {
+    memset(ssd, 0, ssd1306_buffer_length);
+    if (tela == TELA_EVACUAR) {
+        ssd1306_draw_string_scaled(ssd, 20, 30, "EVACUAR", 2);
+        if (origem_alarme) {
+            char linha[12];
+            snprintf(linha, sizeof(linha), "NO %u", origem_alarme);
+            ssd1306_draw_string_scaled(ssd, 36, 54, linha, 1);
+        }
+    } else if (tela == TELA_INICIANDO) {
+        ssd1306_draw_string_scaled(ssd, 10, 30, "INICIANDO", 2);
+    } else {
+        ssd1306_draw_string_scaled(ssd, 0, 0, "IIIIIIIIIIIIIIIIIIIIIIIIIII", 1);
+        ssd1306_draw_string_scaled(ssd, 20, 20, "SISTEMA", 2);
+        ssd1306_draw_string_scaled(ssd, 50, 35, "EM", 2);
+        ssd1306_draw_string_scaled(ssd, 20, 50, "REPOUSO", 2);
+    }
+    METRICA_INICIO(inicio);
+    int ret = render_on_display(ssd, &frame_area);
+    METRICA_REGISTRAR(MH_DISPLAY_FLUSH, inicio);
+    if (ret < 0) diario_registrar(DIARIO_DISPLAY_FALHA, tela, 0, (uint32_t)ret);
+    METRICA_SOMAR(MC_DISPLAY_BYTES, ssd1306_buffer_length);
+    telas_desenhadas++;
+}
+
+// Liga/desliga de um canal vira uma cor fixa com os outros canais preservados
+static uint8_t *canal_da_cor(rgb_cor_t *cor, uint pino) {
+    switch (pino) {
+        case LED_RED: return &cor->r;
+        case LED_GREEN: return &cor->g;
+        case LED_BLUE: return &cor->b;
+        default: return NULL;
+    }
+}
+
+// Roda enquanto o core0 carrega o firmware do cyw43: o sinal de partida mais barato
+// (matriz por PIO/DMA) vem primeiro e o display, preso ao I2C, por último
+static void init_hardware() {
+    matriz_iniciar();
+    matriz_definir_padrao(MATRIZ_INICIANDO);
+    sirene_iniciar(); // antes dos LEDs: o verde usa a fatia configurada pela sirene
+    led_rgb_iniciar();
+    boot_marcar(BOOT_SINAL_LOCAL);
+
+    i2c_init(i2c1, ssd1306_i2c_clock * 1000);
+    gpio_set_function(I2C_SDA, GPIO_FUNC_I2C);
+    gpio_set_function(I2C_SCL, GPIO_FUNC_I2C);
+    gpio_pull_up(I2C_SDA);
+    gpio_pull_up(I2C_SCL);
+    ssd1306_init();
+
+    frame_area.start_column = 0;
+    frame_area.end_column = ssd1306_width - 1;
+    frame_area.start_page = 0;
+    frame_area.end_page = ssd1306_n_pages - 1;
+    calculate_render_area_buffer_length(&frame_area);
+    desenhar_tela(TELA_INICIANDO);
+    boot_marcar(BOOT_DISPLAY);
+}
+
+static void core1_main() {
+    init_hardware();
+    int tela_atual = TELA_INICIANDO;
+    int tela_pedida = TELA_INICIANDO; // até o core0 pedir outra com a rede no ar
+
+    while (true) {
+        // Esvazia a fila; só a última tela pedida é desenhada
+        core1_cmd_t cmd;
+        while (spsc_ring_pop(&fila, &cmd)) {
+            uint32_t latencia = time_us_32() - cmd.enviado_us;
+            latencia_total_us += latencia;
+            if (latencia > latencia_max_us) latencia_max_us = latencia;
+            executados++;
+            if (cmd.tipo == CORE1_CMD_SAIDA && cmd.alvo == BUZZER) {
+                if (cmd.valor) sirene_tocar(TOM_CONTINUO);
+                else sirene_parar();
+            } else if (cmd.tipo == CORE1_CMD_SAIDA) {
+                rgb_cor_t cor = led_rgb_cor();
+                uint8_t *canal = canal_da_cor(&cor, cmd.alvo);
+                if (canal) {
+                    *canal = cmd.valor ? 255 : 0;
+                    led_rgb_aplicar(cor, RGB_FIXO, 0);
+                }
+            } else if (cmd.tipo == CORE1_CMD_COR) {
+                led_rgb_aplicar(cmd.rgb, cmd.alvo, cmd.valor);
+            } else if (cmd.tipo == CORE1_CMD_MATRIZ) {
+                matriz_definir_padrao(cmd.valor);
+            } else if (cmd.tipo == CORE1_CMD_TOM) {
+                sirene_tocar(cmd.valor);
+            } else if (cmd.tipo == CORE1_CMD_TELA) {
+                tela_pedida = cmd.valor;
+            } else if (cmd.tipo == CORE1_CMD_ORIGEM && cmd.valor != origem_alarme) {
+                origem_alarme = cmd.valor;
+                tela_atual = -1; // redesenha mesmo sem troca de tela
+            }
+        }
+        if (tela_pedida != tela_atual) {
+            desenhar_tela(tela_pedida);
+            tela_atual = tela_pedida;
+        }
+
+        // Dorme até a próxima campainha; campainhas extras apenas causam uma volta vazia
+        multicore_fifo_pop_blocking();
+        multicore_fifo_drain();
+    }
+}
+
+// Produtor único = core0. Contextos do core0 (lwIP, timers, main) são serializados
+// desabilitando interrupções só durante o push.
+static bool core1_enviar(core1_cmd_t *cmd) {
+    cmd->enviado_us = time_us_32();
+    uint32_t irq = save_and_disable_interrupts();
+    bool ok = spsc_ring_push(&fila, cmd);
+    if (ok && cmd->tipo == CORE1_CMD_SAIDA) {
+        if (cmd->valor) saidas_pedidas |= 1u << cmd->alvo;
+        else saidas_pedidas &= ~(1u << cmd->alvo);
+        uint8_t *canal = canal_da_cor(&cor_pedida, cmd->alvo);
+        if (canal) *canal = cmd->valor ? 255 : 0;
+    } else if (ok && cmd->tipo == CORE1_CMD_COR) {
+        cor_pedida = cmd->rgb;
+        uint32_t bits = (cor_pedida.r ? 1u << LED_RED : 0) | (cor_pedida.g ? 1u << LED_GREEN : 0) |
+                        (cor_pedida.b ? 1u << LED_BLUE : 0);
+        saidas_pedidas = (saidas_pedidas & ~(1u << LED_RED | 1u << LED_GREEN | 1u << LED_BLUE)) | bits;
+    } else if (ok && cmd->tipo == CORE1_CMD_TOM) {
+        saidas_pedidas |= 1u << BUZZER;
+    } else if (!ok) {
+        descartados++;
+    }
+    restore_interrupts(irq);
+
+    // Fila cheia no FIFO significa que o core1 já tem campainhas pendentes
+    if (ok && multicore_fifo_wready()) multicore_fifo_push_blocking(0);
+    return ok;
+}
+
+void core1_worker_iniciar(void) {
+    spsc_ring_init(&fila, fila_dados, CORE1_FILA_TAM, sizeof(core1_cmd_t));
+    multicore_launch_core1(core1_main);
+}
+
+bool core1_definir_saida(uint pino, bool valor) {
+    core1_cmd_t cmd = {.tipo = CORE1_CMD_SAIDA, .alvo = pino, .valor = valor};
+    return core1_enviar(&cmd);
+}
+
+bool core1_mostrar_tela(tela_t tela) {
+    core1_cmd_t cmd = {.tipo = CORE1_CMD_TELA, .valor = tela};
+    return core1_enviar(&cmd);
+}
+
+bool core1_tocar_tom(tom_t tom) {
+    core1_cmd_t cmd = {.tipo = CORE1_CMD_TOM, .valor = tom};
+    return core1_enviar(&cmd);
+}
+
+bool core1_definir_cor(rgb_cor_t cor, rgb_efeito_t efeito, uint16_t duracao_ms) {
+    core1_cmd_t cmd = {.tipo = CORE1_CMD_COR, .alvo = efeito, .valor = duracao_ms, .rgb = cor};
+    return core1_enviar(&cmd);
+}
+
+bool core1_mostrar_matriz(matriz_padrao_t padrao) {
+    core1_cmd_t cmd = {.tipo = CORE1_CMD_MATRIZ, .valor = padrao};
+    return core1_enviar(&cmd);
+}
+
+bool core1_mostrar_origem(uint16_t no) {
+    core1_cmd_t cmd = {.tipo = CORE1_CMD_ORIGEM, .valor = no};
+    return core1_enviar(&cmd);
+}
+
+bool core1_saida(uint pino) {
+    return (saidas_pedidas >> pino) & 1;
+}
+
+// Cor alvo pedida; durante um fade ou pulso o LED ainda pode estar no caminho
+rgb_cor_t core1_cor(void) {
+    return cor_pedida;
+}
+
+void core1_imprimir_stats(void) {
+    uint32_t n = executados;
+    printf("core1: %lu comandos, %lu telas, %lu descartados, fila %lu, latencia media %lu us, max %lu us\n",
+        (unsigned long)n, (unsigned long)telas_desenhadas, (unsigned long)descartados,
+        (unsigned long)spsc_ring_ocupacao(&fila),
+        (unsigned long)(n ? latencia_total_us / n : 0), (unsigned long)latencia_max_us);
+}
@@ -0,0 +1,55 @@
+#ifndef CORE1_WORKER_H
+#define CORE1_WORKER_H
+
+#include <stdbool.h>
+#include "pico/stdlib.h"
+#include "sirene_seq.h"
+#include "led_rgb.h"
+#include "matriz_quadros.h"
+
+// O core1 é dono do SSD1306, dos LEDs, do buzzer e da matriz WS2812. O core0 só posta registros
+// pequenos numa fila SPSC; o FIFO entre núcleos serve apenas de campainha.
+
+#define CORE1_FILA_TAM 32 // potência de 2
+
+typedef enum {
+    TELA_REPOUSO,
+    TELA_EVACUAR,
+    TELA_INICIANDO,
+} tela_t;
+
+typedef enum {
+    CORE1_CMD_SAIDA, // alvo = pino, valor = nível
+    CORE1_CMD_TELA,  // valor = tela_t
+    CORE1_CMD_TOM,   // valor = tom_t tocado no buzzer por PWM
+    CORE1_CMD_COR,   // alvo = rgb_efeito_t, valor = duração em ms, rgb = cor
+    CORE1_CMD_MATRIZ, // valor = matriz_padrao_t
+    CORE1_CMD_ORIGEM, // valor = nó que disparou o alarme, mostrado na tela de evacuação (0 = nenhum)
+} core1_cmd_tipo_t;
+
+typedef struct {
+    uint8_t tipo;
+    uint8_t alvo;
+    uint16_t valor;
+    rgb_cor_t rgb;
+    uint32_t enviado_us; // para medir a latência entre núcleos
+} core1_cmd_t;
+
+void core1_worker_iniciar(void);
+
+// Chamadas apenas no core0, de qualquer contexto (inclusive IRQ); nunca bloqueiam.
+// Para os LEDs, nível 1 é brilho máximo no canal e 0 apaga o canal.
+bool core1_definir_saida(uint pino, bool valor);
+bool core1_definir_cor(rgb_cor_t cor, rgb_efeito_t efeito, uint16_t duracao_ms);
+bool core1_mostrar_tela(tela_t tela);
+bool core1_tocar_tom(tom_t tom); // core1_definir_saida(BUZZER, 0) silencia
+bool core1_mostrar_matriz(matriz_padrao_t padrao);
+bool core1_mostrar_origem(uint16_t no);
+
+// Último nível pedido para o pino (pode ainda não ter sido aplicado pelo core1)
+bool core1_saida(uint pino);
+rgb_cor_t core1_cor(void);
+
+void core1_imprimir_stats(void);
+
+#endif
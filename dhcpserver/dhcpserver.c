@@ -34,6 +34,8 @@
 
 #include "cyw43_config.h"
 #include "dhcpserver.h"
+#include "metricas.h"
+#include "diario.h"
 #include "lwip/udp.h"
 
 #define DHCPDISCOVER    (1)
@@ -211,6 +213,8 @@ static void dhcp_server_process(void *arg, struct udp_pcb *upcb, struct pbuf *p,
         goto ignore_request;
     }
 
+    METRICA_CONTAR(msgtype[2] == DHCPDISCOVER ? MC_DHCP_DISCOVER : msgtype[2] == DHCPREQUEST ? MC_DHCP_REQUEST : MC_DHCP_OUTROS);
+
     switch (msgtype[2]) {
         case DHCPDISCOVER: {
             int yi = DHCPS_MAX_IP;
@@ -274,6 +278,8 @@ static void dhcp_server_process(void *arg, struct udp_pcb *upcb, struct pbuf *p,
             printf("DHCPS: client connected: MAC=%02x:%02x:%02x:%02x:%02x:%02x IP=%u.%u.%u.%u\n",
                 dhcp_msg.chaddr[0], dhcp_msg.chaddr[1], dhcp_msg.chaddr[2], dhcp_msg.chaddr[3], dhcp_msg.chaddr[4], dhcp_msg.chaddr[5],
                 dhcp_msg.yiaddr[0], dhcp_msg.yiaddr[1], dhcp_msg.yiaddr[2], dhcp_msg.yiaddr[3]);
+            diario_registrar(DIARIO_DHCP_LEASE, dhcp_msg.yiaddr[3], dhcp_msg.chaddr[0] << 8 | dhcp_msg.chaddr[1],
+                (uint32_t)dhcp_msg.chaddr[2] << 24 | dhcp_msg.chaddr[3] << 16 | dhcp_msg.chaddr[4] << 8 | dhcp_msg.chaddr[5]);
             break;
         }
 
@@ -289,6 +295,7 @@ static void dhcp_server_process(void *arg, struct udp_pcb *upcb, struct pbuf *p,
     *opt++ = DHCP_OPT_END;
     struct netif *nif = ip_current_input_netif();
     dhcp_socket_sendto(&d->udp, nif, &dhcp_msg, opt - (uint8_t *)&dhcp_msg, 0xffffffff, PORT_DHCP_CLIENT);
+    METRICA_CONTAR(MC_DHCP_RESPOSTAS);
 
 ignore_request:
     pbuf_free(p);
@@ -29,7 +29,9 @@
 #include "lwip/ip_addr.h"
 
 #define DHCPS_BASE_IP (16)
+#ifndef DHCPS_MAX_IP
 #define DHCPS_MAX_IP (8)
+#endif
 
 typedef struct _dhcp_server_lease_t {
     uint8_t mac[6];
@@ -0,0 +1,115 @@
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "diario.h"
+
+typedef struct {
+    _Atomic uint32_t cabeca; // próximo índice a reservar
+    diario_registro_t registros[DIARIO_REGISTROS];
+} diario_faixa_t;
+
+static diario_faixa_t faixas[DIARIO_NUCLEOS];
+
+static uint32_t reservar(diario_faixa_t *f) {
+#if defined(__ARM_ARCH_6M__)
+    // O M0+ não tem LDREX/STREX; como cada núcleo tem a sua faixa, mascarar as IRQs
+    // pelas duas instruções do incremento já basta
+    uint32_t irq = save_and_disable_interrupts();
+    uint32_t i = atomic_load_explicit(&f->cabeca, memory_order_relaxed);
+    atomic_store_explicit(&f->cabeca, i + 1, memory_order_relaxed);
+    restore_interrupts(irq);
+    return i;
+#else
+    return atomic_fetch_add_explicit(&f->cabeca, 1, memory_order_relaxed);
+#endif
+}
+
+// Contextos do mesmo núcleo só se interrompem em pilha: um registro só sairia misturado se
+// quem interrompe escrevesse uma volta inteira do anel no meio da escrita interrompida
+void diario_registrar(diario_tipo_t tipo, uint8_t origem, uint16_t arg16, uint32_t arg32) {
+    diario_faixa_t *f = &faixas[get_core_num()];
+    uint32_t i = reservar(f);
+    diario_registro_t *r = &f->registros[i & (DIARIO_REGISTROS - 1)];
+    atomic_store_explicit(&r->seq, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&r->t_us, time_us_32(), memory_order_relaxed);
+    atomic_store_explicit(&r->tipo_origem_arg16, (uint32_t)tipo | (uint32_t)origem << 8 | (uint32_t)arg16 << 16,
+        memory_order_relaxed);
+    atomic_store_explicit(&r->arg32, arg32, memory_order_relaxed);
+    atomic_store_explicit(&r->seq, i + 1, memory_order_release);
+}
+
+// Cópia otimista: vale só se a sequência for a esperada antes e depois
+static bool ler(const diario_faixa_t *f, uint32_t i, uint32_t palavras[4]) {
+    const diario_registro_t *r = &f->registros[i & (DIARIO_REGISTROS - 1)];
+    uint32_t seq = atomic_load_explicit(&r->seq, memory_order_acquire);
+    if (seq != i + 1) return false;
+    palavras[0] = seq;
+    palavras[1] = atomic_load_explicit(&r->t_us, memory_order_relaxed);
+    palavras[2] = atomic_load_explicit(&r->tipo_origem_arg16, memory_order_relaxed);
+    palavras[3] = atomic_load_explicit(&r->arg32, memory_order_relaxed);
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&r->seq, memory_order_relaxed) == seq;
+}
+
+static void faixa_iniciar(diario_cursor_t *c) {
+    c->fim = atomic_load_explicit(&faixas[c->nucleo].cabeca, memory_order_acquire);
+    c->pos = c->fim > DIARIO_REGISTROS ? c->fim - DIARIO_REGISTROS : 0;
+}
+
+void diario_cursor_iniciar(diario_cursor_t *c) {
+    c->nucleo = 0;
+    c->cabecalho = false;
+    c->perdidos = 0;
+    faixa_iniciar(c);
+}
+
+static void escrever_u32(char *p, uint32_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+    p[2] = v >> 16;
+    p[3] = v >> 24;
+}
+
+int diario_gerar(void *ctx, char *buf, int max) {
+    diario_cursor_t *c = (diario_cursor_t*)ctx;
+    int n = 0;
+    if (!c->cabecalho) {
+        if (max < DIARIO_CABECALHO_TAM) return 0;
+        memcpy(buf, "BDJ1", 4);
+        buf[4] = DIARIO_REGISTROS & 0xff;
+        buf[5] = DIARIO_REGISTROS >> 8;
+        buf[6] = DIARIO_TAM_REGISTRO;
+        buf[7] = 0;
+        n = DIARIO_CABECALHO_TAM;
+        c->cabecalho = true;
+    }
+    while (max - n >= DIARIO_TAM_REGISTRO) {
+        if (c->pos == c->fim) {
+            if (c->nucleo + 1 >= DIARIO_NUCLEOS) break;
+            c->nucleo++;
+            faixa_iniciar(c);
+            continue;
+        }
+        // Quem ficou para trás de uma volta inteira já foi sobrescrito
+        uint32_t cabeca = atomic_load_explicit(&faixas[c->nucleo].cabeca, memory_order_acquire);
+        if (cabeca - c->pos > DIARIO_REGISTROS) {
+            uint32_t novo = cabeca - DIARIO_REGISTROS;
+            c->perdidos += novo - c->pos;
+            c->pos = novo;
+            if ((int32_t)(c->pos - c->fim) >= 0) {
+                c->pos = c->fim;
+                continue;
+            }
+        }
+        uint32_t p[4];
+        if (!ler(&faixas[c->nucleo], c->pos++, p)) {
+            c->perdidos++;
+            continue;
+        }
+        p[2] |= (uint32_t)c->nucleo << 7;
+        for (int i = 0; i < 4; i++) escrever_u32(buf + n + 4 * i, p[i]);
+        n += DIARIO_TAM_REGISTRO;
+    }
+    return n;
+}
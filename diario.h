@@ -0,0 +1,66 @@
+#ifndef DIARIO_H
+#define DIARIO_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Diário binário de eventos em RAM: um anel de tamanho fixo por núcleo, escrito sem trava
+// por IRQs, callbacks do lwIP e o laço principal. Cada registro tem 16 bytes e é publicado
+// pelo número de sequência, escrito por último; quem lê confere a sequência antes e depois
+// da cópia e descarta o que foi sobrescrito no meio. Exportado em /diario (ver host/diario_ler.c).
+
+#ifndef DIARIO_REGISTROS
+#define DIARIO_REGISTROS 128 // por núcleo, potência de 2
+#endif
+#define DIARIO_NUCLEOS 2
+#define DIARIO_TAM_REGISTRO 16
+#define DIARIO_CABECALHO_TAM 8 // "BDJ1", registros por núcleo (u16) e tamanho do registro (u16)
+
+typedef enum {
+    DIARIO_PARTIDA = 1,
+    DIARIO_ALARME_LIGADO,   // origem = diario_fonte_t; vindo da malha, arg16 = nó e arg32 = relógio
+    DIARIO_ALARME_DESLIGADO,
+    DIARIO_HTTP_COMANDO,    // origem = diario_fonte_t, arg32 = IP do cliente (ordem de rede)
+    DIARIO_DHCP_LEASE,      // origem = último octeto do IP, arg16 e arg32 = MAC
+    DIARIO_DISPLAY_FALHA,   // arg32 = retorno do i2c_write_blocking
+    DIARIO_TESTE,           // livre para as ferramentas do host
+} diario_tipo_t;
+
+typedef enum {
+    DIARIO_FONTE_HTTP,
+    DIARIO_FONTE_WS,
+    DIARIO_FONTE_API,
+    DIARIO_FONTE_BOTAO,
+    DIARIO_FONTE_SOM,
+    DIARIO_FONTE_MALHA,
+    DIARIO_FONTE_SERIAL,
+    DIARIO_FONTE_TEMPERATURA,
+} diario_fonte_t;
+
+// Palavras relaxadas: no M0+ são ldr/str simples, e no host o estresse roda sem corrida de dados
+typedef struct {
+    _Atomic uint32_t seq;   // índice + 1 quando completo; 0 durante a escrita
+    _Atomic uint32_t t_us;
+    _Atomic uint32_t tipo_origem_arg16; // tipo | origem << 8 | arg16 << 16
+    _Atomic uint32_t arg32;
+} diario_registro_t;
+
+// Pode ser chamada de qualquer contexto, nos dois núcleos; nunca bloqueia
+void diario_registrar(diario_tipo_t tipo, uint8_t origem, uint16_t arg16, uint32_t arg32);
+
+// Cursor de exportação: percorre o que havia em cada núcleo no momento em que chega a ele
+typedef struct {
+    uint8_t nucleo;
+    bool cabecalho;
+    uint32_t pos;
+    uint32_t fim;
+    uint32_t perdidos; // sobrescritos antes de serem lidos
+} diario_cursor_t;
+
+void diario_cursor_iniciar(diario_cursor_t *c);
+
+// http_gerador_fn: cabeçalho e registros little-endian, com o núcleo no bit 7 do tipo
+int diario_gerar(void *ctx, char *buf, int max);
+
+#endif
@@ -11,6 +11,7 @@
 #include <stdbool.h>
 
 #include "dnsserver.h"
+#include "metricas.h"
 #include "lwip/udp.h"
 
 #define PORT_DNS_SERVER 53
@@ -103,6 +104,7 @@ static int dns_socket_sendto(struct udp_pcb **udp, const void *buf, size_t len,
 static void dns_server_process(void *arg, struct udp_pcb *upcb, struct pbuf *p, const ip_addr_t *src_addr, u16_t src_port) {
     dns_server_t *d = arg;
     DEBUG_printf("dns_server_process %u\n", p->tot_len);
+    METRICA_CONTAR(MC_DNS_CONSULTAS);
 
     uint8_t dns_msg[MAX_DNS_MSG_SIZE];
     dns_header_t *dns_hdr = (dns_header_t*)dns_msg;
@@ -176,7 +178,17 @@ static void dns_server_process(void *arg, struct udp_pcb *upcb, struct pbuf *p,
         goto ignore_request;
     }
 
-    // Skip QNAME and QTYPE
+    // Check QTYPE and QCLASS are present, and count the query by type
+    if (question_ptr + 4 > question_ptr_end) {
+        DEBUG_printf("Truncated question\n");
+        goto ignore_request;
+    }
+#if METRICAS_ATIVAS
+    uint16_t qtype = question_ptr[0] << 8 | question_ptr[1];
+    METRICA_CONTAR(qtype == 1 ? MC_DNS_A : qtype == 28 ? MC_DNS_AAAA : MC_DNS_OUTROS);
+#endif
+
+    // Skip QTYPE and QCLASS
     question_ptr += 4;
 
     // Generate answer
@@ -212,6 +224,7 @@ static void dns_server_process(void *arg, struct udp_pcb *upcb, struct pbuf *p,
     // Send the reply
     DEBUG_printf("Sending %d byte reply to %s:%d\n", answer_ptr - dns_msg, ipaddr_ntoa(src_addr), src_port);
     dns_socket_sendto(&d->udp, &dns_msg, answer_ptr - dns_msg, src_addr, src_port);
+    METRICA_CONTAR(MC_DNS_RESPOSTAS);
 
 ignore_request:
     pbuf_free(p);
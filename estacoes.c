@@ -0,0 +1,50 @@
+#include <stdio.h>
+#include <string.h>
+#include "pico/cyw43_arch.h"
+#include "estacoes.h"
+#include "estacoes_tabela.h"
+#include "http_stream.h"
+
+// WLC_SCB_DEAUTHENTICATE_FOR_REASON; o cyw43 codifica ioctls de escrita como (cmd << 1) | 1
+#define IOCTL_DESASSOCIAR ((201 << 1) | 1)
+#define MOTIVO_AP_LOTADO 5 // 802.11: AP incapaz de atender todas as estações associadas
+
+static estacoes_t estacoes;
+static async_at_time_worker_t worker;
+
+// Com erro o driver deixa n em max e macs sem preencher
+static int listar_cyw43(uint8_t *macs, int max) {
+    int n = max;
+    if (cyw43_wifi_ap_get_stas(&cyw43_state, &n, macs) != 0) return -1;
+    return n;
+}
+
+static void expulsar_cyw43(const uint8_t mac[6]) {
+    uint8_t buf[4 + 6] = {MOTIVO_AP_LOTADO, 0, 0, 0};
+    memcpy(buf + 4, mac, 6);
+    cyw43_ioctl(&cyw43_state, IOCTL_DESASSOCIAR, sizeof(buf), buf, CYW43_ITF_AP);
+}
+
+static const estacoes_fonte_t FONTE_CYW43 = {listar_cyw43, expulsar_cyw43};
+
+static void worker_fn(async_context_t *context, async_at_time_worker_t *w) {
+    estacoes_conciliar(&estacoes, to_ms_since_boot(get_absolute_time()));
+    async_context_add_at_time_worker_at(context, w, make_timeout_time_ms(ESTACOES_INTERVALO_MS));
+}
+
+void estacoes_iniciar(async_context_t *context, dhcp_server_t *dhcp) {
+    estacoes_init(&estacoes, &FONTE_CYW43, dhcp);
+    worker.do_work = worker_fn;
+    async_context_add_at_time_worker_at(context, &worker, make_timeout_time_ms(ESTACOES_INTERVALO_MS));
+}
+
+int estacoes_formatar_linha(uint16_t indice, char *linha, int max) {
+    return estacoes_formatar(&estacoes, indice, to_ms_since_boot(get_absolute_time()), linha, max);
+}
+
+void estacoes_imprimir(void) {
+    char linha[HTTP_LINHA_MAX];
+    for (uint16_t i = 0; estacoes_formatar_linha(i, linha, sizeof(linha)) > 0; i++) {
+        fputs(linha, stdout);
+    }
+}
@@ -0,0 +1,21 @@
+#ifndef ESTACOES_H
+#define ESTACOES_H
+
+#include <stdint.h>
+#include "pico/async_context.h"
+#include "dhcpserver.h"
+
+// Gerente de estações do AP: a cada ESTACOES_INTERVALO_MS lê a lista de associadas do
+// cyw43 e concilia com os leases do DHCP (ver estacoes_tabela.h).
+
+#ifndef ESTACOES_INTERVALO_MS
+#define ESTACOES_INTERVALO_MS 2000
+#endif
+
+void estacoes_iniciar(async_context_t *context, dhcp_server_t *dhcp);
+
+// Uma linha por estação (http_linha_fn); retorna 0 depois da última
+int estacoes_formatar_linha(uint16_t indice, char *linha, int max);
+void estacoes_imprimir(void);
+
+#endif
@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include <string.h>
+#include "estacoes_tabela.h"
+
+static const uint8_t MAC_VAZIO[6];
+
+static bool mac_na_lista(const uint8_t *macs, int n, const uint8_t mac[6]) {
+    for (int i = 0; i < n; i++) {
+        if (memcmp(macs + 6 * i, mac, 6) == 0) return true;
+    }
+    return false;
+}
+
+static estacao_t *procurar(estacoes_t *e, const uint8_t mac[6]) {
+    for (int i = 0; i < e->num; i++) {
+        if (memcmp(e->tabela[i].mac, mac, 6) == 0) return &e->tabela[i];
+    }
+    return NULL;
+}
+
+void estacoes_init(estacoes_t *e, const estacoes_fonte_t *fonte, dhcp_server_t *dhcp) {
+    memset(e, 0, sizeof(*e));
+    e->fonte = fonte;
+    e->dhcp = dhcp;
+}
+
+void estacoes_conciliar(estacoes_t *e, uint32_t agora_ms) {
+    uint8_t macs[6 * ESTACOES_LISTA_MAX];
+    int n = e->fonte->listar(macs, ESTACOES_LISTA_MAX);
+    if (n < 0) {
+        // Sem lista não dá para distinguir quem saiu: nada é liberado nesta rodada
+        e->falhas++;
+        return;
+    }
+    // Lista cheia pode ter deixado associadas de fora: ausência não prova saída
+    bool cheia = n >= ESTACOES_LISTA_MAX;
+    if (cheia) {
+        n = ESTACOES_LISTA_MAX;
+        e->listas_cheias++;
+    }
+
+    for (int i = e->num - 1; i >= 0 && !cheia; i--) {
+        if (!mac_na_lista(macs, n, e->tabela[i].mac)) {
+            e->tabela[i] = e->tabela[--e->num];
+            e->saidas++;
+        }
+    }
+
+    for (int i = 0; i < n; i++) {
+        const uint8_t *mac = macs + 6 * i;
+        estacao_t *s = procurar(e, mac);
+        if (s) {
+            s->vista_ms = agora_ms;
+        } else if (e->num < ESTACOES_MAX) {
+            s = &e->tabela[e->num++];
+            memcpy(s->mac, mac, 6);
+            s->desde_ms = s->vista_ms = agora_ms;
+        } else {
+            e->fonte->expulsar(mac);
+            e->expulsas++;
+        }
+    }
+
+    // O DHCP só ouve a estação depois da associação, então um lease sem estação na
+    // tabela é de quem saiu ou foi expulso
+    for (int i = 0; i < DHCPS_MAX_IP && !cheia; i++) {
+        uint8_t *mac = e->dhcp->lease[i].mac;
+        if (memcmp(mac, MAC_VAZIO, 6) != 0 && !procurar(e, mac)) {
+            memset(mac, 0, 6);
+            e->dhcp->lease[i].expiry = 0;
+            e->leases_liberados++;
+        }
+    }
+}
+
+static int lease_de(const estacoes_t *e, const uint8_t mac[6]) {
+    for (int i = 0; i < DHCPS_MAX_IP; i++) {
+        if (memcmp(e->dhcp->lease[i].mac, mac, 6) == 0) return i;
+    }
+    return -1;
+}
+
+int estacoes_formatar(const estacoes_t *e, uint16_t indice, uint32_t agora_ms, char *linha, int max) {
+    if (indice == 0) {
+        return snprintf(linha, max, "estacoes: %d/%d associadas, %lu saidas, %lu expulsas, %lu leases liberados, %lu falhas, %lu listas cheias\n",
+            e->num, ESTACOES_MAX, (unsigned long)e->saidas, (unsigned long)e->expulsas,
+            (unsigned long)e->leases_liberados, (unsigned long)e->falhas, (unsigned long)e->listas_cheias);
+    }
+    if (indice > e->num) return 0;
+
+    const estacao_t *s = &e->tabela[indice - 1];
+    char ip[20] = "-";
+    int lease = lease_de(e, s->mac);
+    if (lease >= 0) {
+        const ip4_addr_t *base = ip_2_ip4(&e->dhcp->ip);
+        snprintf(ip, sizeof(ip), "%u.%u.%u.%u", ip4_addr1(base), ip4_addr2(base), ip4_addr3(base), (uint8_t)(DHCPS_BASE_IP + lease));
+    }
+    return snprintf(linha, max, "%02x:%02x:%02x:%02x:%02x:%02x ip %s associada ha %lu s, vista ha %lu s\n",
+        s->mac[0], s->mac[1], s->mac[2], s->mac[3], s->mac[4], s->mac[5], ip,
+        (unsigned long)((agora_ms - s->desde_ms) / 1000), (unsigned long)((agora_ms - s->vista_ms) / 1000));
+}
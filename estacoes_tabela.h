@@ -0,0 +1,55 @@
+#ifndef ESTACOES_TABELA_H
+#define ESTACOES_TABELA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "dhcpserver.h"
+
+// Conciliação entre as estações associadas ao AP e os leases do DHCP. Sem SDK nem cyw43:
+// a lista de estações vem de uma fonte injetada, que no host pode ser falsa.
+
+#ifndef ESTACOES_MAX
+#define ESTACOES_MAX DHCPS_MAX_IP // estações aceitas; as excedentes são desassociadas
+#endif
+#ifndef ESTACOES_LISTA_MAX
+#define ESTACOES_LISTA_MAX (2 * ESTACOES_MAX) // MACs lidos da fonte por rodada
+#endif
+#if ESTACOES_LISTA_MAX <= ESTACOES_MAX
+#error "ESTACOES_LISTA_MAX precisa de ao menos uma vaga além de ESTACOES_MAX para ver a excedente"
+#endif
+
+typedef struct {
+    uint8_t mac[6];
+    uint32_t desde_ms; // primeira rodada em que apareceu associada
+    uint32_t vista_ms; // última rodada em que ainda estava associada
+} estacao_t;
+
+typedef struct {
+    // Copia até max MACs associados (6 bytes cada) e devolve quantos; < 0 se a fonte falhou
+    int (*listar)(uint8_t *macs, int max);
+    void (*expulsar)(const uint8_t mac[6]);
+} estacoes_fonte_t;
+
+typedef struct {
+    const estacoes_fonte_t *fonte;
+    dhcp_server_t *dhcp;
+    estacao_t tabela[ESTACOES_MAX];
+    int num;
+    uint32_t saidas;
+    uint32_t expulsas;
+    uint32_t leases_liberados;
+    uint32_t falhas;
+    uint32_t listas_cheias; // rodadas com a lista possivelmente truncada
+} estacoes_t;
+
+void estacoes_init(estacoes_t *e, const estacoes_fonte_t *fonte, dhcp_server_t *dhcp);
+
+// Uma rodada: quem saiu deixa a tabela, quem chegou entra até ESTACOES_MAX e o resto é
+// expulso; lease de MAC fora da tabela é liberado na hora. Com a lista cheia (talvez
+// truncada) só as estações listadas contam: ninguém sai e nenhum lease é liberado.
+void estacoes_conciliar(estacoes_t *e, uint32_t agora_ms);
+
+// Uma linha de resumo e uma por estação; retorna 0 depois da última
+int estacoes_formatar(const estacoes_t *e, uint16_t indice, uint32_t agora_ms, char *linha, int max);
+
+#endif
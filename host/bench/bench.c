@@ -0,0 +1,110 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bench.h"
+#include "pico/cyw43_arch.h"
+#include "lwip/init.h"
+#include "core1_worker.h"
+#include "alarme.h"
+
+#ifndef BENCH_COMMIT
+#define BENCH_COMMIT "desconhecido"
+#endif
+#define BENCH_ALVO_NS 200000000ull  // cada caso roda até somar ~200 ms
+
+static FILE *saida_json;
+
+// Alocações vistas pelo linker (-Wl,--wrap); só contam durante "medir"
+static int contando;
+static uint64_t bytes_alocados, alocacoes;
+
+void *__real_malloc(size_t n);
+void *__real_calloc(size_t n, size_t tam);
+void *__real_realloc(void *p, size_t n);
+
+void *__wrap_malloc(size_t n) {
+    if (contando) { bytes_alocados += n; alocacoes++; }
+    return __real_malloc(n);
+}
+
+void *__wrap_calloc(size_t n, size_t tam) {
+    if (contando) { bytes_alocados += n * tam; alocacoes++; }
+    return __real_calloc(n, tam);
+}
+
+void *__wrap_realloc(void *p, size_t n) {
+    if (contando) { bytes_alocados += n; alocacoes++; }
+    return __real_realloc(p, n);
+}
+
+static uint64_t agora_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static uint64_t rodar(bench_fn preparar, bench_fn medir, void *ctx, uint64_t n) {
+    uint64_t total = 0;
+    if (!preparar) {
+        contando = 1;
+        uint64_t t0 = agora_ns();
+        for (uint64_t i = 0; i < n; i++) medir(ctx);
+        total = agora_ns() - t0;
+        contando = 0;
+        return total;
+    }
+    for (uint64_t i = 0; i < n; i++) {
+        preparar(ctx);
+        contando = 1;
+        uint64_t t0 = agora_ns();
+        medir(ctx);
+        total += agora_ns() - t0;
+        contando = 0;
+    }
+    return total;
+}
+
+void bench_executar(const char *nome, bench_fn preparar, bench_fn medir, void *ctx) {
+    // Dobra as iterações até a medida passar do alvo; só a última rodada vale
+    uint64_t n = 1, ns;
+    for (;;) {
+        bytes_alocados = alocacoes = 0;
+        ns = rodar(preparar, medir, ctx, n);
+        if (ns >= BENCH_ALVO_NS || n >= (1ull << 32)) break;
+        n *= 2;
+    }
+    double ns_op = (double)ns / n;
+    double bytes_op = (double)bytes_alocados / n;
+    double alocs_op = (double)alocacoes / n;
+    printf("%-44s %12.1f ns/op %10.1f B/op %8.2f allocs/op %12llu iter\n",
+           nome, ns_op, bytes_op, alocs_op, (unsigned long long)n);
+    if (saida_json) {
+        fprintf(saida_json, "{\"commit\":\"%s\",\"bench\":\"%s\",\"ns_op\":%.1f,\"bytes_op\":%.1f,\"allocs_op\":%.2f,\"iteracoes\":%llu}\n",
+                BENCH_COMMIT, nome, ns_op, bytes_op, alocs_op, (unsigned long long)n);
+    }
+}
+
+// Uso: picow_access_point_bench [resultado.jsonl] [filtro]
+int main(int argc, char **argv) {
+    const char *arquivo = argc > 1 ? argv[1] : "bench.jsonl";
+    const char *filtro = argc > 2 ? argv[2] : "";
+    saida_json = fopen(arquivo, "a");
+    if (!saida_json) {
+        perror(arquivo);
+        return 1;
+    }
+
+    // Mesmo estado de execução do firmware: lwIP, core1 consumindo a fila e alarme no async_context
+    lwip_init();
+    core1_worker_iniciar();
+    alarme_iniciar(cyw43_arch_async_context());
+
+    printf("commit %s\n", BENCH_COMMIT);
+    if (strstr("http", filtro)) bench_http();
+    if (strstr("dhcp", filtro)) bench_dhcp();
+    if (strstr("dns", filtro)) bench_dns();
+    if (strstr("display", filtro)) bench_display();
+    fclose(saida_json);
+    return 0;
+}
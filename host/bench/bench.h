@@ -0,0 +1,18 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+
+// Microbenchmarks no host: ns por operação e bytes de malloc por operação.
+// "preparar" (opcional) roda antes de cada "medir" e fica fora do tempo e das alocações.
+
+typedef void (*bench_fn)(void *ctx);
+
+void bench_executar(const char *nome, bench_fn preparar, bench_fn medir, void *ctx);
+
+void bench_http(void);
+void bench_dhcp(void);
+void bench_dns(void);
+void bench_display(void);
+
+#endif
@@ -0,0 +1,82 @@
+// Inclui o servidor para medir opt_find e a escrita de opções, que são estáticas
+#include "dhcpserver.c"
+
+#include "bench.h"
+
+typedef struct {
+    dhcp_server_t servidor;
+    dhcp_msg_t descoberta;
+    size_t len;
+    struct pbuf *p;
+} bench_dhcp_t;
+
+// DISCOVER típico de um celular: tipo de mensagem depois do client id e do hostname
+static size_t montar_descoberta(dhcp_msg_t *m) {
+    static const uint8_t mac[MAC_LEN] = {0x02, 0x11, 0x22, 0x33, 0x44, 0x55};
+    static const uint8_t pedidos[] = {1, 3, 6, 15, 26, 28, 51, 58, 59, 43};
+    memset(m, 0, sizeof(*m));
+    m->op = 1;
+    m->htype = 1;
+    m->hlen = MAC_LEN;
+    memcpy(m->chaddr, mac, MAC_LEN);
+    uint8_t *opt = m->options;
+    static const uint8_t cookie[] = {99, 130, 83, 99};
+    memcpy(opt, cookie, sizeof(cookie));
+    opt += sizeof(cookie);
+    uint8_t client_id[1 + MAC_LEN] = {1};
+    memcpy(client_id + 1, mac, MAC_LEN);
+    opt_write_n(&opt, DHCP_OPT_CLIENT_ID, sizeof(client_id), client_id);
+    opt_write_n(&opt, DHCP_OPT_HOST_NAME, 13, "android-bench");
+    opt_write_n(&opt, DHCP_OPT_VENDOR_CLASS_ID, 12, "android-dhcp");
+    opt_write_n(&opt, DHCP_OPT_PARAM_REQUEST_LIST, sizeof(pedidos), pedidos);
+    opt_write_u8(&opt, DHCP_OPT_MSG_TYPE, DHCPDISCOVER);
+    *opt++ = DHCP_OPT_END;
+    return opt - (uint8_t*)m;
+}
+
+static void medir_opt_find(void *ctx) {
+    bench_dhcp_t *b = ctx;
+    if (!opt_find(b->descoberta.options + 4, DHCP_OPT_MSG_TYPE)) abort();
+}
+
+// As mesmas opções que dhcp_server_process escreve numa oferta
+static void medir_opt_escrita(void *ctx) {
+    bench_dhcp_t *b = ctx;
+    static uint8_t opcoes[64];
+    uint8_t *opt = opcoes;
+    uint32_t ip = ip4_addr_get_u32(ip_2_ip4(&b->servidor.ip));
+    uint32_t nm = ip4_addr_get_u32(ip_2_ip4(&b->servidor.nm));
+    opt_write_u8(&opt, DHCP_OPT_MSG_TYPE, DHCPOFFER);
+    opt_write_n(&opt, DHCP_OPT_SERVER_ID, 4, &ip);
+    opt_write_n(&opt, DHCP_OPT_SUBNET_MASK, 4, &nm);
+    opt_write_n(&opt, DHCP_OPT_ROUTER, 4, &ip);
+    opt_write_n(&opt, DHCP_OPT_DNS, 4, &ip);
+    opt_write_u32(&opt, DHCP_OPT_IP_LEASE_TIME, DEFAULT_LEASE_TIME_S);
+    *opt++ = DHCP_OPT_END;
+}
+
+static void preparar_processo(void *ctx) {
+    bench_dhcp_t *b = ctx;
+    b->p = pbuf_alloc(PBUF_TRANSPORT, b->len, PBUF_POOL);
+    pbuf_take(b->p, &b->descoberta, b->len);
+}
+
+// Sem netif de entrada a oferta sai por udp_sendto e para no roteamento, depois de montada
+static void medir_processo(void *ctx) {
+    bench_dhcp_t *b = ctx;
+    dhcp_server_process(&b->servidor, b->servidor.udp, b->p, IP_ADDR_ANY, PORT_DHCP_CLIENT);
+}
+
+void bench_dhcp(void) {
+    static bench_dhcp_t b;
+    ip_addr_t ip, nm;
+    IP4_ADDR(ip_2_ip4(&ip), 192, 168, 4, 1);
+    IP4_ADDR(ip_2_ip4(&nm), 255, 255, 255, 0);
+    dhcp_server_init(&b.servidor, &ip, &nm);
+    b.len = montar_descoberta(&b.descoberta);
+
+    bench_executar("dhcp opt_find msg_type", NULL, medir_opt_find, &b);
+    bench_executar("dhcp opt_write oferta", NULL, medir_opt_escrita, &b);
+    bench_executar("dhcp_server_process DISCOVER", preparar_processo, medir_processo, &b);
+    dhcp_server_deinit(&b.servidor);
+}
@@ -0,0 +1,31 @@
+#include <string.h>
+#include "bench.h"
+#include "ssd1306.h"
+
+static uint8_t ssd[ssd1306_buffer_length];
+static uint32_t contador;
+
+static void bench_pixel(void *ctx) {
+    uint32_t i = contador++;
+    ssd1306_set_pixel(ssd, i % ssd1306_width, (i / ssd1306_width) % ssd1306_height, i & 1);
+}
+
+static void bench_linha(void *ctx) {
+    ssd1306_draw_line(ssd, 0, 0, ssd1306_width - 1, ssd1306_height - 1, true);
+}
+
+static void bench_caractere(void *ctx) {
+    ssd1306_draw_char(ssd, 20, 20, 'A' + (contador++ % 26));
+}
+
+static void bench_texto_escalado(void *ctx) {
+    ssd1306_draw_string_scaled(ssd, 20, 30, "EVACUAR", 2);
+}
+
+void bench_display(void) {
+    memset(ssd, 0, sizeof(ssd));
+    bench_executar("ssd1306_set_pixel", NULL, bench_pixel, NULL);
+    bench_executar("ssd1306_draw_line 128x64 diagonal", NULL, bench_linha, NULL);
+    bench_executar("ssd1306_draw_char", NULL, bench_caractere, NULL);
+    bench_executar("ssd1306_draw_string_scaled EVACUAR x2", NULL, bench_texto_escalado, NULL);
+}
@@ -0,0 +1,59 @@
+// Inclui o servidor para chamar dns_server_process, que é estática
+#include "dnsserver.c"
+
+#include "bench.h"
+
+typedef struct {
+    dns_server_t servidor;
+    uint8_t consulta[MAX_DNS_MSG_SIZE];
+    size_t len;
+    ip_addr_t origem;
+    struct pbuf *p;
+} bench_dns_t;
+
+// Consulta A com rótulos no formato de tamanho+texto, como a de um teste de portal cativo
+static size_t montar_consulta(uint8_t *msg, const char *nome) {
+    dns_header_t *cab = (dns_header_t*)msg;
+    memset(cab, 0, sizeof(*cab));
+    cab->id = lwip_htons(0x1234);
+    cab->flags = lwip_htons(0x0100);
+    cab->question_count = lwip_htons(1);
+    uint8_t *q = msg + sizeof(*cab);
+    while (*nome) {
+        const char *fim = strchr(nome, '.');
+        size_t n = fim ? (size_t)(fim - nome) : strlen(nome);
+        *q++ = n;
+        memcpy(q, nome, n);
+        q += n;
+        nome += n + (fim ? 1 : 0);
+    }
+    *q++ = 0;
+    static const uint8_t tipo_classe[] = {0, 1, 0, 1};
+    memcpy(q, tipo_classe, sizeof(tipo_classe));
+    return q + sizeof(tipo_classe) - msg;
+}
+
+static void preparar_consulta(void *ctx) {
+    bench_dns_t *b = ctx;
+    b->p = pbuf_alloc(PBUF_TRANSPORT, b->len, PBUF_POOL);
+    pbuf_take(b->p, b->consulta, b->len);
+}
+
+static void medir_consulta(void *ctx) {
+    bench_dns_t *b = ctx;
+    dns_server_process(&b->servidor, b->servidor.udp, b->p, &b->origem, 5353);
+}
+
+void bench_dns(void) {
+    static bench_dns_t b;
+    ip_addr_t ip;
+    IP4_ADDR(ip_2_ip4(&ip), 192, 168, 4, 1);
+    IP4_ADDR(ip_2_ip4(&b.origem), 192, 168, 4, 16);
+    dns_server_init(&b.servidor, &ip);
+
+    b.len = montar_consulta(b.consulta, "connectivitycheck.gstatic.com");
+    bench_executar("dns_server_process A connectivitycheck", preparar_consulta, medir_consulta, &b);
+    b.len = montar_consulta(b.consulta, "a.b.c.d.e.f.g.h.captive.apple.com");
+    bench_executar("dns_server_process A 10 rotulos", preparar_consulta, medir_consulta, &b);
+    dns_server_deinit(&b.servidor);
+}
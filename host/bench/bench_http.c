@@ -0,0 +1,100 @@
+// O servidor HTTP inteiro entra nesta unidade para alcançar os tipos e funções estáticas;
+// o main do firmware é renomeado para não colidir com o do benchmark
+#define main firmware_main
+#include "picow_access_point.c"
+#undef main
+
+#include "bench.h"
+
+#define BENCH_MAX_REQUISICOES 5
+
+typedef struct {
+    const char *const *requisicoes;
+    int n;
+    TCP_SERVER_T servidor;
+    TCP_CONNECT_STATE_T *con_state[BENCH_MAX_REQUISICOES];
+    struct tcp_pcb *pcb[BENCH_MAX_REQUISICOES];
+    struct pbuf *p[BENCH_MAX_REQUISICOES];
+} bench_recv_t;
+
+// Conexão nova por requisição a cada iteração, como depois do accept. O pcb nunca conecta: a
+// resposta é montada e o primeiro tcp_write falha com ERR_CONN, fechando tudo pelo caminho normal.
+static void preparar_recv(void *ctx) {
+    bench_recv_t *b = ctx;
+    for (int i = 0; i < b->n; i++) {
+        u16_t len = strlen(b->requisicoes[i]);
+        b->pcb[i] = tcp_new_ip_type(IPADDR_TYPE_ANY);
+        b->con_state[i] = calloc(1, sizeof(TCP_CONNECT_STATE_T));
+        b->con_state[i]->pcb = b->pcb[i];
+        b->con_state[i]->gw = &b->servidor.gw;
+        b->con_state[i]->server = &b->servidor;
+        b->servidor.conexoes_ativas++;
+        b->p[i] = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
+        pbuf_take(b->p[i], b->requisicoes[i], len);
+    }
+}
+
+static void medir_recv(void *ctx) {
+    bench_recv_t *b = ctx;
+    for (int i = 0; i < b->n; i++) tcp_server_recv(b->con_state[i], b->pcb[i], b->p[i], ERR_OK);
+}
+
+// Cada iteração atende as n requisições, cada uma na sua conexão
+static void bench_recv_varias(const char *nome, const char *const *requisicoes, int n) {
+    bench_recv_t b = {.requisicoes = requisicoes, .n = n};
+    IP4_ADDR(&b.servidor.gw, 192, 168, 4, 1);
+    bench_executar(nome, preparar_recv, medir_recv, &b);
+}
+
+static void bench_recv(const char *nome, const char *requisicao) {
+    bench_recv_varias(nome, &requisicao, 1);
+}
+
+// Os mesmos cinco atuadores em lote (um POST) e um por requisição (cinco GETs)
+static const char *const LOTE_POST[] = {
+    "POST /api/commands HTTP/1.1\r\nHost: 192.168.4.1\r\nContent-Type: application/json\r\n"
+    "Content-Length: 50\r\n\r\n{\"red\":1,\"green\":0,\"blue\":1,\"buzzer\":0,\"alarme\":0}",
+};
+static const char *const LOTE_GETS[] = {
+    "GET /bitdoglabtest?red=1 HTTP/1.1\r\nHost: 192.168.4.1\r\n\r\n",
+    "GET /bitdoglabtest?green=0 HTTP/1.1\r\nHost: 192.168.4.1\r\n\r\n",
+    "GET /bitdoglabtest?blue=1 HTTP/1.1\r\nHost: 192.168.4.1\r\n\r\n",
+    "GET /bitdoglabtest?buzzer=0 HTTP/1.1\r\nHost: 192.168.4.1\r\n\r\n",
+    "GET /bitdoglabtest?alarme=0 HTTP/1.1\r\nHost: 192.168.4.1\r\n\r\n",
+};
+
+static void medir_parse_leds(void *ctx) {
+    parse_params("red=1&green=0&blue=1&buzzer=0");
+}
+
+static void medir_parse_padrao(void *ctx) {
+    parse_params("padrao=sos&periodo=200&cor=ff8000&fade=500");
+}
+
+static void medir_pagina(void *ctx) {
+    TCP_CONNECT_STATE_T con_state = {0};
+    handle_request("/bitdoglabtest", NULL, &con_state);
+}
+
+static void medir_estado_json(void *ctx) {
+    char buf[160];
+    gerar_estado_json(buf, sizeof(buf));
+}
+
+void bench_http(void) {
+    bench_recv("tcp_server_recv GET /bitdoglabtest?red=1",
+               "GET /bitdoglabtest?red=1 HTTP/1.1\r\nHost: 192.168.4.1\r\nUser-Agent: bench\r\nAccept: */*\r\n\r\n");
+    bench_recv("tcp_server_recv GET /api/state",
+               "GET /api/state HTTP/1.1\r\nHost: 192.168.4.1\r\n\r\n");
+    bench_recv("tcp_server_recv POST /api/commands",
+               "POST /api/commands HTTP/1.1\r\nHost: 192.168.4.1\r\nContent-Type: application/json\r\n"
+               "Content-Length: 20\r\n\r\n{\"red\":1,\"buzzer\":0}");
+    bench_recv_varias("lote de 5 atuadores: 1 POST /api/commands", LOTE_POST, 1);
+    bench_recv_varias("lote de 5 atuadores: 5 GET /bitdoglabtest?<atuador>", LOTE_GETS, 5);
+    bench_recv("tcp_server_recv GET /generate_204 (redirect)",
+               "GET /generate_204 HTTP/1.1\r\nHost: connectivitycheck.gstatic.com\r\n\r\n");
+    bench_executar("parse_params leds", NULL, medir_parse_leds, NULL);
+    bench_executar("parse_params padrao+cor", NULL, medir_parse_padrao, NULL);
+    bench_executar("handle_request /bitdoglabtest", NULL, medir_pagina, NULL);
+    bench_executar("gerar_estado_json", NULL, medir_estado_json, NULL);
+}
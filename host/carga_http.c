@@ -0,0 +1,197 @@
+// Gerador de carga HTTP contra a placa (ou o firmware do host na TAP): mantém N conexões
+// simultâneas pedindo a mesma URL e classifica cada tentativa. Degradar bem é responder 200
+// ou o 503 pronto e voltar ao normal depois; colapsar é resetar, estourar o prazo ou parar
+// de responder.
+//
+//   ./carga_http [-c conexoes] [-t segundos] [-u /caminho] [-p porta] [-e] 192.168.4.1
+//
+// Com -e qualquer RST conta como falha (use com -c até HTTP_MAX_CONEXOES, em que só a
+// taxa por IP pode recusar). Sem -e, só o RST que corta uma resposta já começada falha.
+// No fim, passada a janela de taxa, um GET /api/state precisa voltar com 200.
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CARGA_MAX_CONEXOES 256
+#define CARGA_PRAZO_MS 5000
+#define CARGA_ESPERA_TAXA_MS 2500 // um pouco mais que HTTP_TAXA_JANELA_MS
+
+typedef enum {
+    R_200,
+    R_503,
+    R_OUTRO,
+    R_RST_NA_RESPOSTA, // RST depois de bytes da resposta: o cliente perde o que não leu
+    R_RST,
+    R_RECUSADA,
+    R_PRAZO,
+    NUM_RESULTADOS
+} resultado_t;
+
+static const char *const NOMES[NUM_RESULTADOS] = {
+    "200", "503", "outro_status", "rst_na_resposta", "rst", "recusada", "prazo",
+};
+
+typedef struct {
+    int fd;
+    uint64_t inicio_us;
+    bool enviado;
+    char resposta[16]; // só a linha de status interessa
+    int len;
+} conexao_t;
+
+static struct sockaddr_in destino;
+static char requisicao[256];
+static int requisicao_len;
+
+static uint64_t agora_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int comparar(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+static void abrir(conexao_t *c) {
+    c->fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    c->inicio_us = agora_us();
+    c->enviado = false;
+    c->len = 0;
+    connect(c->fd, (struct sockaddr*)&destino, sizeof(destino));
+}
+
+static resultado_t classificar_status(const conexao_t *c) {
+    if (c->len >= 12 && strncmp(c->resposta + 9, "200", 3) == 0) return R_200;
+    if (c->len >= 12 && strncmp(c->resposta + 9, "503", 3) == 0) return R_503;
+    return R_OUTRO;
+}
+
+// Avança a conexão; devolve o resultado quando ela termina, ou -1
+static int atender(conexao_t *c, short eventos) {
+    if (!c->enviado) {
+        int erro = 0;
+        socklen_t tam = sizeof(erro);
+        getsockopt(c->fd, SOL_SOCKET, SO_ERROR, &erro, &tam);
+        if (erro == ECONNREFUSED) return R_RECUSADA;
+        if (erro) return R_RST;
+        if (!(eventos & POLLOUT)) return -1;
+        if (send(c->fd, requisicao, requisicao_len, MSG_NOSIGNAL) != requisicao_len) return R_RST;
+        c->enviado = true;
+        return -1;
+    }
+    char buf[1024];
+    for (;;) {
+        ssize_t n = recv(c->fd, buf, sizeof(buf), 0);
+        if (n > 0) {
+            int copiar = n < (ssize_t)sizeof(c->resposta) - c->len ? (int)n : (int)sizeof(c->resposta) - c->len;
+            memcpy(c->resposta + c->len, buf, copiar);
+            c->len += copiar;
+            continue;
+        }
+        if (n == 0) return classificar_status(c);
+        if (errno == EAGAIN || errno == EWOULDBLOCK) return -1;
+        return c->len > 0 ? R_RST_NA_RESPOSTA : R_RST;
+    }
+}
+
+// Um GET isolado depois da carga: a placa voltou ao normal?
+static bool placa_responde(void) {
+    conexao_t c;
+    abrir(&c);
+    uint64_t prazo = agora_us() + CARGA_PRAZO_MS * 1000ull;
+    int r = -1;
+    while (r < 0 && agora_us() < prazo) {
+        struct pollfd p = {.fd = c.fd, .events = c.enviado ? POLLIN : POLLOUT};
+        if (poll(&p, 1, 100) > 0) r = atender(&c, p.revents);
+    }
+    close(c.fd);
+    return r == R_200;
+}
+
+int main(int argc, char **argv) {
+    int conexoes = 8, segundos = 5, porta = 80;
+    const char *caminho = "/bitdoglabtest";
+    bool exigir_sem_rst = false;
+    int opt;
+    while ((opt = getopt(argc, argv, "c:t:u:p:e")) != -1) {
+        if (opt == 'c') conexoes = atoi(optarg);
+        else if (opt == 't') segundos = atoi(optarg);
+        else if (opt == 'u') caminho = optarg;
+        else if (opt == 'p') porta = atoi(optarg);
+        else if (opt == 'e') exigir_sem_rst = true;
+        else optind = argc + 1;
+    }
+    if (optind != argc - 1 || conexoes < 1 || conexoes > CARGA_MAX_CONEXOES) {
+        fprintf(stderr, "uso: %s [-c conexoes] [-t segundos] [-u /caminho] [-p porta] [-e] <ip>\n", argv[0]);
+        return 2;
+    }
+    destino.sin_family = AF_INET;
+    destino.sin_port = htons(porta);
+    if (inet_pton(AF_INET, argv[optind], &destino.sin_addr) != 1) {
+        fprintf(stderr, "ip invalido: %s\n", argv[optind]);
+        return 2;
+    }
+    requisicao_len = snprintf(requisicao, sizeof(requisicao), "GET %s HTTP/1.1\r\nHost: %s\r\n\r\n", caminho, argv[optind]);
+
+    static conexao_t c[CARGA_MAX_CONEXOES];
+    static struct pollfd fds[CARGA_MAX_CONEXOES];
+    uint32_t contagem[NUM_RESULTADOS] = {0};
+    size_t lat_cap = 1 << 16, lat_n = 0;
+    uint32_t *latencias = malloc(lat_cap * sizeof(uint32_t));
+
+    for (int i = 0; i < conexoes; i++) abrir(&c[i]);
+    uint64_t inicio = agora_us(), fim = inicio + segundos * 1000000ull;
+    while (agora_us() < fim) {
+        for (int i = 0; i < conexoes; i++) {
+            fds[i].fd = c[i].fd;
+            fds[i].events = c[i].enviado ? POLLIN : POLLOUT;
+        }
+        if (poll(fds, conexoes, 100) < 0) break;
+        uint64_t agora = agora_us();
+        for (int i = 0; i < conexoes; i++) {
+            int r = fds[i].revents ? atender(&c[i], fds[i].revents) : -1;
+            if (r < 0 && agora - c[i].inicio_us > CARGA_PRAZO_MS * 1000ull) r = R_PRAZO;
+            if (r < 0) continue;
+            contagem[r]++;
+            if ((r == R_200 || r == R_503) && lat_n < lat_cap) latencias[lat_n++] = agora - c[i].inicio_us;
+            close(c[i].fd);
+            abrir(&c[i]);
+        }
+    }
+    for (int i = 0; i < conexoes; i++) close(c[i].fd);
+
+    double s = (agora_us() - inicio) / 1e6;
+    uint32_t total = 0;
+    for (int r = 0; r < NUM_RESULTADOS; r++) total += contagem[r];
+    printf("%d conexoes, %.1f s: %u tentativas (%.0f/s)\n", conexoes, s, total, total / s);
+    for (int r = 0; r < NUM_RESULTADOS; r++) printf("  %-16s %u\n", NOMES[r], contagem[r]);
+    if (lat_n) {
+        qsort(latencias, lat_n, sizeof(uint32_t), comparar);
+        printf("  latencia 200/503: p50 %u us, p99 %u us, max %u us\n",
+            latencias[lat_n / 2], latencias[lat_n * 99 / 100], latencias[lat_n - 1]);
+    }
+    free(latencias);
+
+    struct timespec espera = {.tv_sec = CARGA_ESPERA_TAXA_MS / 1000, .tv_nsec = CARGA_ESPERA_TAXA_MS % 1000 * 1000000};
+    nanosleep(&espera, NULL);
+    requisicao_len = snprintf(requisicao, sizeof(requisicao), "GET /api/state HTTP/1.1\r\nHost: %s\r\n\r\n", argv[optind]);
+    bool responde = placa_responde();
+    printf("  depois da carga: %s\n", responde ? "GET /api/state 200" : "sem resposta");
+
+    bool falhou = !responde || contagem[R_RST_NA_RESPOSTA] > 0 || contagem[R_PRAZO] > 0 ||
+                  (exigir_sem_rst && contagem[R_RST] > 0);
+    return falhou ? 1 : 0;
+}
@@ -0,0 +1,186 @@
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/select.h>
+#include <linux/if.h>
+#include <linux/if_tun.h>
+#include "pico/cyw43_arch.h"
+#include "lwip/init.h"
+#include "lwip/netif.h"
+#include "lwip/etharp.h"
+#include "lwip/timeouts.h"
+#include "netif/ethernet.h"
+
+// O AP da placa vira uma interface TAP: o Linux (ou uma VM/namespace ligado a ela) faz
+// o papel das estações Wi-Fi e recebe endereço do dhcpserver do próprio firmware.
+
+#define HOST_QUADRO_MAX 1514
+#define HOST_MAX_ESTACOES 16
+#define HOST_ESTACAO_EXPIRA_MS 30000
+#define HOST_ESTACAO_BLOQUEIO_MS 10000
+#define HOST_IOCTL_DESASSOCIAR ((201 << 1) | 1)
+
+cyw43_t cyw43_state;
+
+static struct netif netif_ap;
+static int fd_tap = -1;
+
+static struct {
+    uint8_t mac[6];
+    uint32_t vista_ms;
+    uint32_t bloqueada_ate_ms;
+} estacoes[HOST_MAX_ESTACOES];
+
+// Registra o remetente do quadro; false se ele foi desassociado há pouco
+static bool estacao_aceitar(const uint8_t mac[6]) {
+    uint32_t agora = cyw43_hal_ticks_ms();
+    int livre = 0;
+    if (mac[0] & 1) return true; // multicast como origem não é estação
+    for (int i = 0; i < HOST_MAX_ESTACOES; i++) {
+        if (memcmp(estacoes[i].mac, mac, 6) == 0) {
+            if ((int32_t)(estacoes[i].bloqueada_ate_ms - agora) > 0) return false;
+            estacoes[i].vista_ms = agora;
+            return true;
+        }
+        if (estacoes[i].vista_ms < estacoes[livre].vista_ms) livre = i;
+    }
+    memcpy(estacoes[livre].mac, mac, 6);
+    estacoes[livre].vista_ms = agora;
+    estacoes[livre].bloqueada_ate_ms = agora;
+    return true;
+}
+
+int cyw43_wifi_ap_get_stas(cyw43_t *self, int *num_stas, uint8_t *macs) {
+    uint32_t agora = cyw43_hal_ticks_ms();
+    int n = 0;
+    for (int i = 0; i < HOST_MAX_ESTACOES && n < *num_stas; i++) {
+        bool ativa = estacoes[i].vista_ms && agora - estacoes[i].vista_ms < HOST_ESTACAO_EXPIRA_MS &&
+                     (int32_t)(estacoes[i].bloqueada_ate_ms - agora) <= 0;
+        if (ativa) memcpy(macs + 6 * n++, estacoes[i].mac, 6);
+    }
+    *num_stas = n;
+    return 0;
+}
+
+int cyw43_ioctl(cyw43_t *self, uint32_t cmd, size_t len, uint8_t *buf, uint32_t iface) {
+    if (cmd != HOST_IOCTL_DESASSOCIAR || len < 10) return -1;
+    for (int i = 0; i < HOST_MAX_ESTACOES; i++) {
+        if (memcmp(estacoes[i].mac, buf + 4, 6) == 0) {
+            estacoes[i].bloqueada_ate_ms = cyw43_hal_ticks_ms() + HOST_ESTACAO_BLOQUEIO_MS;
+            printf("estacao %02x:%02x:%02x:%02x:%02x:%02x desassociada\n",
+                buf[4], buf[5], buf[6], buf[7], buf[8], buf[9]);
+        }
+    }
+    return 0;
+}
+
+static err_t tap_saida(struct netif *netif, struct pbuf *p) {
+    uint8_t quadro[HOST_QUADRO_MAX];
+    uint16_t len = pbuf_copy_partial(p, quadro, sizeof(quadro), 0);
+    if (write(fd_tap, quadro, len) != len) return ERR_IF;
+    return ERR_OK;
+}
+
+static err_t tap_netif_init(struct netif *netif) {
+    static const uint8_t mac[6] = {0x02, 0x00, 0x00, 0x00, 0x04, 0x01};
+    netif->name[0] = 'a';
+    netif->name[1] = 'p';
+    netif->output = etharp_output;
+    netif->linkoutput = tap_saida;
+    netif->mtu = 1500;
+    netif->hwaddr_len = sizeof(mac);
+    memcpy(netif->hwaddr, mac, sizeof(mac));
+    netif->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET;
+    return ERR_OK;
+}
+
+static void tap_receber(void) {
+    uint8_t quadro[HOST_QUADRO_MAX];
+    ssize_t len;
+    while (fd_tap >= 0 && (len = read(fd_tap, quadro, sizeof(quadro))) > 0) {
+        if (len < 14 || !estacao_aceitar(quadro + 6)) continue;
+        struct pbuf *p = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
+        if (!p) return;
+        pbuf_take(p, quadro, len);
+        if (netif_ap.input(p, &netif_ap) != ERR_OK) pbuf_free(p);
+    }
+}
+
+int cyw43_arch_init(void) {
+    lwip_init();
+    return 0;
+}
+
+void cyw43_arch_deinit(void) {
+    if (fd_tap >= 0) close(fd_tap);
+    fd_tap = -1;
+}
+
+void cyw43_arch_enable_ap_mode(const char *ssid, const char *senha, uint32_t auth) {
+    const char *nome = getenv("PICO_HOST_TAP");
+    struct ifreq ifr = {0};
+    ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
+    strncpy(ifr.ifr_name, nome ? nome : "tap0", IFNAMSIZ - 1);
+    fd_tap = open("/dev/net/tun", O_RDWR | O_NONBLOCK);
+    if (fd_tap < 0 || ioctl(fd_tap, TUNSETIFF, &ifr) < 0) {
+        perror("TAP");
+        exit(1);
+    }
+    printf("AP '%s' na interface %s\n", ssid, ifr.ifr_name);
+
+    ip4_addr_t ip, mascara;
+    IP4_ADDR(&ip, 192, 168, 4, 1);
+    IP4_ADDR(&mascara, 255, 255, 255, 0);
+    netif_add(&netif_ap, &ip, &mascara, &ip, NULL, tap_netif_init, ethernet_input);
+    netif_set_default(&netif_ap);
+    netif_set_up(&netif_ap);
+    netif_set_link_up(&netif_ap);
+}
+
+void cyw43_arch_disable_ap_mode(void) {
+    netif_set_link_down(&netif_ap);
+    netif_set_down(&netif_ap);
+    netif_remove(&netif_ap);
+}
+
+void cyw43_arch_poll(void) {
+    tap_receber();
+    sys_check_timeouts();
+    int fd = pico_host_fd_stdin();
+    fd_set fds;
+    struct timeval zero = {0, 0};
+    FD_ZERO(&fds);
+    if (fd >= 0) FD_SET(fd, &fds);
+    pico_host_atender(fd >= 0 && select(fd + 1, &fds, NULL, NULL, &zero) > 0);
+}
+
+// Dorme no select até chegar um quadro, uma tecla, vencer um worker ou um timer do lwIP
+void cyw43_arch_wait_for_work_until(absolute_time_t ate) {
+    absolute_time_t agora = get_absolute_time();
+    absolute_time_t prazo = pico_host_proximo_prazo();
+    if (ate < prazo) prazo = ate;
+    uint64_t espera = prazo > agora ? prazo - agora : 0;
+    uint64_t lwip_us = sys_timeouts_sleeptime() * 1000ull;
+    if (lwip_us < espera) espera = lwip_us;
+
+    fd_set fds;
+    int maior = -1;
+    FD_ZERO(&fds);
+    if (fd_tap >= 0) {
+        FD_SET(fd_tap, &fds);
+        maior = fd_tap;
+    }
+    int fd = pico_host_fd_stdin();
+    if (fd >= 0) {
+        FD_SET(fd, &fds);
+        if (fd > maior) maior = fd;
+    }
+    struct timeval tv = {espera / 1000000, espera % 1000000};
+    select(maior + 1, &fds, NULL, NULL, &tv);
+}
+
+async_context_t *cyw43_arch_async_context(void) {
+    return pico_host_async_context();
+}
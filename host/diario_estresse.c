@@ -0,0 +1,137 @@
+// Estresse do diário: um produtor por núcleo (threads com get_core_num próprio) escrevendo sem
+// parar enquanto outra thread exporta o anel em pedaços de tamanho variável, como o http_stream.
+// Cada registro leva um contador por produtor e um verificador; qualquer registro rasgado,
+// repetido ou fora de ordem derruba o teste.
+//
+//   ./diario_estresse [segundos]
+//
+// Usa diario.c sem o resto do firmware: get_core_num e time_us_64 são definidos aqui.
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "pico/stdlib.h"
+#include "diario.h"
+
+#define PEDIDO_MIN 64 // HTTP_STREAM_MIN_GERADOR
+
+static _Thread_local uint nucleo;
+static atomic_bool parar;
+
+uint get_core_num(void) {
+    return nucleo;
+}
+
+uint64_t time_us_64(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+uint32_t save_and_disable_interrupts(void) {
+    return 0;
+}
+
+void restore_interrupts(uint32_t estado) {}
+
+static uint16_t verificador(uint8_t produtor, uint32_t contador) {
+    return (contador * 2654435761u ^ produtor * 40503u) >> 16;
+}
+
+static uint32_t escritos[DIARIO_NUCLEOS];
+
+static void *produzir(void *arg) {
+    nucleo = (uintptr_t)arg;
+    uint32_t contador = 0;
+    while (!atomic_load_explicit(&parar, memory_order_relaxed)) {
+        contador++;
+        diario_registrar(DIARIO_TESTE, nucleo, verificador(nucleo, contador), contador);
+    }
+    escritos[nucleo] = contador;
+    return NULL;
+}
+
+static uint32_t ler_u32(const uint8_t *p) {
+    return p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+typedef struct {
+    unsigned long exportacoes;
+    unsigned long registros;
+    unsigned long perdidos;
+    unsigned long erros;
+} resultado_t;
+
+// Confere um registro contra o anterior do mesmo núcleo dentro da mesma exportação
+static bool conferir(const uint8_t *p, uint32_t ultimo_seq[], uint32_t ultimo_contador[]) {
+    uint32_t seq = ler_u32(p);
+    uint32_t palavra = ler_u32(p + 8);
+    uint32_t contador = ler_u32(p + 12);
+    uint8_t tipo = palavra & 0x7f, c = palavra >> 7 & 1, produtor = palavra >> 8;
+    uint16_t arg16 = palavra >> 16;
+    if (tipo != DIARIO_TESTE || produtor != c || arg16 != verificador(produtor, contador)) {
+        fprintf(stderr, "registro rasgado: seq %lu nucleo %u produtor %u contador %lu\n",
+            (unsigned long)seq, c, produtor, (unsigned long)contador);
+        return false;
+    }
+    // Um produtor por faixa: o contador acompanha a sequência
+    if (seq != contador || seq <= ultimo_seq[c] || contador <= ultimo_contador[c]) {
+        fprintf(stderr, "fora de ordem: nucleo %u seq %lu depois de %lu\n", c, (unsigned long)seq,
+            (unsigned long)ultimo_seq[c]);
+        return false;
+    }
+    ultimo_seq[c] = seq;
+    ultimo_contador[c] = contador;
+    return true;
+}
+
+static void *exportar(void *arg) {
+    resultado_t *res = arg;
+    char buf[PEDIDO_MIN + DIARIO_TAM_REGISTRO * 40];
+    unsigned semente = 1;
+    while (!atomic_load_explicit(&parar, memory_order_relaxed)) {
+        diario_cursor_t c;
+        diario_cursor_iniciar(&c);
+        uint32_t ultimo_seq[DIARIO_NUCLEOS] = {0}, ultimo_contador[DIARIO_NUCLEOS] = {0};
+        bool cabecalho = false;
+        int n;
+        while ((n = diario_gerar(&c, buf, PEDIDO_MIN + rand_r(&semente) % (sizeof(buf) - PEDIDO_MIN))) > 0) {
+            const uint8_t *p = (const uint8_t*)buf;
+            if (!cabecalho) {
+                if (memcmp(p, "BDJ1", 4) != 0) res->erros++;
+                p += DIARIO_CABECALHO_TAM;
+                n -= DIARIO_CABECALHO_TAM;
+                cabecalho = true;
+            }
+            if (n % DIARIO_TAM_REGISTRO) res->erros++;
+            for (; n >= DIARIO_TAM_REGISTRO; n -= DIARIO_TAM_REGISTRO, p += DIARIO_TAM_REGISTRO) {
+                if (!conferir(p, ultimo_seq, ultimo_contador)) res->erros++;
+                res->registros++;
+            }
+        }
+        res->perdidos += c.perdidos;
+        res->exportacoes++;
+    }
+    return NULL;
+}
+
+int main(int argc, char **argv) {
+    int segundos = argc > 1 ? atoi(argv[1]) : 2;
+    pthread_t produtores[DIARIO_NUCLEOS], leitor;
+    resultado_t res = {0};
+    for (uintptr_t i = 0; i < DIARIO_NUCLEOS; i++) pthread_create(&produtores[i], NULL, produzir, (void*)i);
+    pthread_create(&leitor, NULL, exportar, &res);
+
+    struct timespec espera = {.tv_sec = segundos};
+    nanosleep(&espera, NULL);
+    atomic_store(&parar, true);
+    for (int i = 0; i < DIARIO_NUCLEOS; i++) pthread_join(produtores[i], NULL);
+    pthread_join(leitor, NULL);
+
+    printf("escritos: %lu + %lu, exportacoes: %lu, registros lidos: %lu, sobrescritos antes da leitura: %lu, erros: %lu\n",
+        (unsigned long)escritos[0], (unsigned long)escritos[1], res.exportacoes, res.registros, res.perdidos, res.erros);
+    return res.erros ? 1 : 0;
+}
@@ -0,0 +1,123 @@
+// Decodifica o diário exportado em /diario, em ordem de tempo, e aponta as lacunas de cada núcleo.
+//
+//   curl -s http://192.168.4.1/diario | ./diario_ler
+//
+// Os dois núcleos compartilham o timer, então t_us intercala as duas faixas; o contador de
+// 32 bits volta a zero a cada ~71 min e a ordenação não tenta adivinhar a volta.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "diario.h"
+
+typedef struct {
+    uint32_t seq;
+    uint32_t t_us;
+    uint8_t tipo;
+    uint8_t nucleo;
+    uint8_t origem;
+    uint16_t arg16;
+    uint32_t arg32;
+} registro_t;
+
+static const char *const NOMES_TIPOS[] = {
+    [DIARIO_PARTIDA] = "partida", [DIARIO_ALARME_LIGADO] = "alarme_ligado",
+    [DIARIO_ALARME_DESLIGADO] = "alarme_desligado", [DIARIO_HTTP_COMANDO] = "http_comando",
+    [DIARIO_DHCP_LEASE] = "dhcp_lease", [DIARIO_DISPLAY_FALHA] = "display_falha", [DIARIO_TESTE] = "teste",
+};
+
+static const char *const NOMES_FONTES[] = {
+    "http", "ws", "api", "botao", "som", "malha", "serial", "temperatura",
+};
+
+static uint32_t ler_u32(const uint8_t *p) {
+    return p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static int comparar(const void *a, const void *b) {
+    const registro_t *x = a, *y = b;
+    if (x->t_us != y->t_us) return x->t_us < y->t_us ? -1 : 1;
+    if (x->nucleo != y->nucleo) return x->nucleo - y->nucleo;
+    return x->seq < y->seq ? -1 : x->seq > y->seq;
+}
+
+static const char *fonte(uint8_t f) {
+    return f < sizeof(NOMES_FONTES) / sizeof(NOMES_FONTES[0]) ? NOMES_FONTES[f] : "?";
+}
+
+static void imprimir(const registro_t *r) {
+    const char *nome = r->tipo < sizeof(NOMES_TIPOS) / sizeof(NOMES_TIPOS[0]) && NOMES_TIPOS[r->tipo] ?
+        NOMES_TIPOS[r->tipo] : "desconhecido";
+    printf("%5lu.%06lu c%u #%-6lu %-16s ", (unsigned long)(r->t_us / 1000000), (unsigned long)(r->t_us % 1000000),
+        r->nucleo, (unsigned long)r->seq, nome);
+    uint8_t *ip = (uint8_t*)&r->arg32; // IPs do lwIP ficam em ordem de rede
+    switch (r->tipo) {
+        case DIARIO_ALARME_LIGADO:
+        case DIARIO_ALARME_DESLIGADO:
+            printf("fonte=%s", fonte(r->origem));
+            if (r->origem == DIARIO_FONTE_MALHA) printf(" no=%u relogio=%lu", r->arg16, (unsigned long)r->arg32);
+            break;
+        case DIARIO_HTTP_COMANDO:
+            printf("fonte=%s cliente=%u.%u.%u.%u", fonte(r->origem), ip[0], ip[1], ip[2], ip[3]);
+            break;
+        case DIARIO_DHCP_LEASE:
+            printf("mac=%02x:%02x:%02x:%02x:%02x:%02x ip=.%u", r->arg16 >> 8, r->arg16 & 0xff,
+                (unsigned)(r->arg32 >> 24), (unsigned)(r->arg32 >> 16 & 0xff), (unsigned)(r->arg32 >> 8 & 0xff),
+                (unsigned)(r->arg32 & 0xff), r->origem);
+            break;
+        case DIARIO_DISPLAY_FALHA:
+            printf("tela=%u i2c=%ld", r->origem, (long)(int32_t)r->arg32);
+            break;
+        default:
+            printf("origem=%u arg16=%u arg32=%lu", r->origem, r->arg16, (unsigned long)r->arg32);
+    }
+    putchar('\n');
+}
+
+int main(void) {
+    uint8_t cab[DIARIO_CABECALHO_TAM];
+    if (fread(cab, 1, sizeof(cab), stdin) != sizeof(cab) || memcmp(cab, "BDJ1", 4) != 0) {
+        fprintf(stderr, "cabecalho BDJ1 ausente\n");
+        return 1;
+    }
+    unsigned tam = cab[6] | cab[7] << 8;
+    if (tam < DIARIO_TAM_REGISTRO) {
+        fprintf(stderr, "registro de %u bytes\n", tam);
+        return 1;
+    }
+
+    size_t n = 0, cap = 256;
+    registro_t *regs = malloc(cap * sizeof(registro_t));
+    uint8_t buf[256];
+    while (fread(buf, 1, tam, stdin) == tam) {
+        if (n == cap) regs = realloc(regs, (cap *= 2) * sizeof(registro_t));
+        registro_t *r = &regs[n++];
+        uint32_t palavra = ler_u32(buf + 8);
+        r->seq = ler_u32(buf);
+        r->t_us = ler_u32(buf + 4);
+        r->tipo = palavra & 0x7f;
+        r->nucleo = palavra >> 7 & 1;
+        r->origem = palavra >> 8;
+        r->arg16 = palavra >> 16;
+        r->arg32 = ler_u32(buf + 12);
+    }
+
+    // Lacunas: a exportação percorre cada núcleo em ordem de sequência
+    uint32_t ultimo[DIARIO_NUCLEOS] = {0};
+    unsigned long faltando = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint32_t *u = &ultimo[regs[i].nucleo];
+        if (*u && regs[i].seq != *u + 1) {
+            printf("# nucleo %u: %lu registros perdidos entre #%lu e #%lu\n", regs[i].nucleo,
+                (unsigned long)(regs[i].seq - *u - 1), (unsigned long)*u, (unsigned long)regs[i].seq);
+            faltando += regs[i].seq - *u - 1;
+        }
+        *u = regs[i].seq;
+    }
+
+    qsort(regs, n, sizeof(registro_t), comparar);
+    for (size_t i = 0; i < n; i++) imprimir(&regs[i]);
+    printf("# %zu registros, %lu perdidos\n", n, faltando);
+    free(regs);
+    return 0;
+}
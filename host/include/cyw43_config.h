@@ -0,0 +1 @@
+#include "pico/cyw43_arch.h"
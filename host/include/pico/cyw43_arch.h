@@ -0,0 +1,33 @@
+#ifndef PICO_HOST_CYW43_ARCH_H
+#define PICO_HOST_CYW43_ARCH_H
+
+#include "pico_host.h"
+
+// cyw43_arch no modo poll, com o AP trocado por uma interface TAP do Linux (host/cyw43_host.c).
+// O nome da interface vem de PICO_HOST_TAP (padrão tap0).
+
+#define CYW43_AUTH_WPA2_AES_PSK 0x00400004
+
+int cyw43_arch_init(void);
+void cyw43_arch_deinit(void);
+void cyw43_arch_enable_ap_mode(const char *ssid, const char *senha, uint32_t auth);
+void cyw43_arch_disable_ap_mode(void);
+static inline void cyw43_arch_lwip_begin(void) {}
+static inline void cyw43_arch_lwip_end(void) {}
+void cyw43_arch_poll(void);
+void cyw43_arch_wait_for_work_until(absolute_time_t ate);
+async_context_t *cyw43_arch_async_context(void);
+
+// Estações: todo MAC que enviou quadros pela TAP há menos de HOST_ESTACAO_EXPIRA_MS conta
+// como associado; desassociar descarta os quadros do MAC por HOST_ESTACAO_BLOQUEIO_MS
+#define CYW43_ITF_AP 1
+typedef struct {
+    int itf_state;
+} cyw43_t;
+extern cyw43_t cyw43_state;
+int cyw43_wifi_ap_get_stas(cyw43_t *self, int *num_stas, uint8_t *macs);
+int cyw43_ioctl(cyw43_t *self, uint32_t cmd, size_t len, uint8_t *buf, uint32_t iface);
+
+static inline uint32_t cyw43_hal_ticks_ms(void) { return to_ms_since_boot(get_absolute_time()); }
+
+#endif
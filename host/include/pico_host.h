@@ -0,0 +1,205 @@
+#ifndef PICO_HOST_H
+#define PICO_HOST_H
+
+// Subconjunto do Pico SDK usado pelo firmware, implementado sobre POSIX (ver host/pico_host.c).
+// Os cabeçalhos pico/... e hardware/... deste diretório apenas incluem este arquivo.
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef unsigned int uint;
+
+#define _u(x) x##u
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+#define __not_in_flash_func(f) f
+#define __time_critical_func(f) f
+#define __isr
+#define bi_decl(x)
+
+#define PICO_OK 0
+#define PICO_ERROR_TIMEOUT -1
+#define PICO_ERROR_GENERIC -2
+
+// Tempo: microssegundos desde o início do processo (CLOCK_MONOTONIC)
+typedef uint64_t absolute_time_t;
+#define at_the_end_of_time ((absolute_time_t)INT64_MAX)
+
+uint64_t time_us_64(void);
+static inline uint32_t time_us_32(void) { return (uint32_t)time_us_64(); }
+static inline absolute_time_t get_absolute_time(void) { return time_us_64(); }
+static inline uint32_t to_ms_since_boot(absolute_time_t t) { return (uint32_t)(t / 1000); }
+static inline uint64_t to_us_since_boot(absolute_time_t t) { return t; }
+static inline absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us) { return t + us; }
+static inline absolute_time_t delayed_by_ms(absolute_time_t t, uint32_t ms) { return t + ms * 1000ull; }
+static inline absolute_time_t make_timeout_time_ms(uint32_t ms) { return delayed_by_ms(get_absolute_time(), ms); }
+static inline int64_t absolute_time_diff_us(absolute_time_t de, absolute_time_t ate) { return (int64_t)(ate - de); }
+void sleep_ms(uint32_t ms);
+void sleep_us(uint64_t us);
+static inline void tight_loop_contents(void) {}
+
+// stdio: o terminal vira não canônico para as teclas do console
+bool stdio_init_all(void);
+int getchar_timeout_us(uint32_t timeout_us);
+void stdio_set_chars_available_callback(void (*fn)(void*), void *param);
+static inline int putchar_raw(int c) { return putchar(c); }
+static inline void stdio_flush(void) { fflush(stdout); }
+
+// GPIO: níveis guardados em memória
+#define GPIO_IN 0
+#define GPIO_OUT 1
+#define GPIO_FUNC_I2C 3
+#define GPIO_FUNC_PWM 4
+#define GPIO_FUNC_PIO0 6
+#define GPIO_IRQ_EDGE_FALL 0x4u
+#define GPIO_IRQ_EDGE_RISE 0x8u
+typedef void (*gpio_irq_callback_t)(uint gpio, uint32_t eventos);
+void gpio_init(uint gpio);
+void gpio_set_dir(uint gpio, bool saida);
+void gpio_put(uint gpio, bool valor);
+bool gpio_get(uint gpio);
+void gpio_set_function(uint gpio, int funcao);
+void gpio_pull_up(uint gpio);
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t eventos, bool ativo, gpio_irq_callback_t callback);
+
+// Núcleos: o core1 é uma thread; "interrupções" só desabilitam o despacho simulado
+uint get_core_num(void);
+uint32_t save_and_disable_interrupts(void);
+void restore_interrupts(uint32_t estado);
+
+// ID único da flash: PICO_HOST_NO_ID (ou o PID) nos dois últimos bytes, para vários
+// processos se distinguirem na malha
+typedef struct {
+    uint8_t id[8];
+} pico_unique_board_id_t;
+void pico_get_unique_board_id(pico_unique_board_id_t *id);
+
+// IRQs: os handlers rodam na thread do núcleo que os registrou, quando ele espera
+typedef void (*irq_handler_t)(void);
+#define PWM_IRQ_WRAP 4
+#define DMA_IRQ_1 12
+#define PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY 0x80
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t prioridade);
+void irq_set_enabled(uint num, bool ativo);
+
+// Clocks
+#define clk_sys 5
+uint32_t clock_get_hz(int clk);
+
+// PWM: só o período é simulado, para gerar PWM_IRQ_WRAP nas fatias com IRQ ligada
+#define NUM_PWM_SLICES 8
+#define PWM_CHAN_A 0
+#define PWM_CHAN_B 1
+typedef struct {
+    float div;
+    uint16_t top;
+} pwm_config;
+static inline uint pwm_gpio_to_slice_num(uint gpio) { return (gpio >> 1) & 7; }
+static inline uint pwm_gpio_to_channel(uint gpio) { return gpio & 1; }
+static inline pwm_config pwm_get_default_config(void) { return (pwm_config){1.0f, 0xffff}; }
+static inline void pwm_config_set_clkdiv(pwm_config *c, float div) { c->div = div; }
+static inline void pwm_config_set_wrap(pwm_config *c, uint16_t top) { c->top = top; }
+void pwm_init(uint slice, pwm_config *c, bool iniciar);
+void pwm_set_wrap(uint slice, uint16_t top);
+void pwm_set_chan_level(uint slice, uint canal, uint16_t nivel);
+void pwm_set_enabled(uint slice, bool ativo);
+void pwm_set_counter(uint slice, uint16_t contagem);
+void pwm_set_irq_enabled(uint slice, bool ativo);
+void pwm_clear_irq(uint slice);
+uint32_t pwm_get_irq_status_mask(void);
+
+// DMA, PIO e ADC: configurados e ignorados; no host nenhuma transferência termina
+#define DMA_SIZE_16 1
+#define DMA_SIZE_32 2
+#define DREQ_ADC 36
+typedef struct {
+    uint32_t ctrl;
+} dma_channel_config;
+int dma_claim_unused_channel(bool obrigatorio);
+static inline dma_channel_config dma_channel_get_default_config(uint canal) { return (dma_channel_config){canal}; }
+static inline void channel_config_set_transfer_data_size(dma_channel_config *c, int tam) {}
+static inline void channel_config_set_read_increment(dma_channel_config *c, bool inc) {}
+static inline void channel_config_set_write_increment(dma_channel_config *c, bool inc) {}
+static inline void channel_config_set_dreq(dma_channel_config *c, uint dreq) {}
+static inline void channel_config_set_chain_to(dma_channel_config *c, uint canal) {}
+static inline void dma_channel_configure(uint canal, const dma_channel_config *c, volatile void *escrita,
+                                         const volatile void *leitura, uint n, bool disparar) {}
+static inline void dma_channel_set_irq1_enabled(uint canal, bool ativo) {}
+static inline bool dma_channel_get_irq1_status(uint canal) { return false; }
+static inline void dma_channel_acknowledge_irq1(uint canal) {}
+static inline void dma_channel_set_write_addr(uint canal, volatile void *escrita, bool disparar) {}
+static inline void dma_channel_transfer_from_buffer_now(uint canal, const volatile void *leitura, uint32_t n) {}
+static inline void dma_channel_start(uint canal) {}
+static inline bool dma_channel_is_busy(uint canal) { return false; }
+
+typedef struct {
+    volatile uint32_t txf[4];
+} pio_hw_t;
+typedef pio_hw_t *PIO;
+extern pio_hw_t pico_host_pio0;
+#define pio0 (&pico_host_pio0)
+typedef struct {
+    const uint16_t *instructions;
+    uint8_t length;
+    int8_t origin;
+} pio_program_t;
+static inline uint pio_add_program(PIO pio, const pio_program_t *programa) { return 0; }
+static inline int pio_claim_unused_sm(PIO pio, bool obrigatorio) { return 0; }
+static inline uint pio_get_dreq(PIO pio, uint sm, bool tx) { return 0; }
+
+typedef struct {
+    volatile uint32_t fifo;
+} adc_hw_t;
+extern adc_hw_t pico_host_adc;
+#define adc_hw (&pico_host_adc)
+static inline void adc_init(void) {}
+static inline void adc_gpio_init(uint gpio) {}
+static inline void adc_select_input(uint entrada) {}
+static inline void adc_fifo_setup(bool en, bool dreq, uint16_t limiar, bool erro, bool byte) {}
+static inline void adc_set_clkdiv(float div) {}
+static inline void adc_run(bool ativo) {}
+static inline void adc_set_temp_sensor_enabled(bool ativo) {}
+static inline void adc_set_round_robin(uint mascara) {}
+
+// I2C: as escritas só são contadas (o display fica invisível no host)
+typedef struct i2c_inst i2c_inst_t;
+extern i2c_inst_t *i2c1;
+uint i2c_init(i2c_inst_t *i2c, uint baud);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t endereco, const uint8_t *dados, size_t len, bool nostop);
+
+// Multicore: FIFO de 8 posições entre as threads, como a do SIO
+void multicore_launch_core1(void (*entrada)(void));
+bool multicore_fifo_wready(void);
+void multicore_fifo_push_blocking(uint32_t dado);
+uint32_t multicore_fifo_pop_blocking(void);
+void multicore_fifo_drain(void);
+
+// async_context: um único contexto, servido pela thread principal em cyw43_arch_poll
+typedef struct async_context async_context_t;
+typedef struct async_work_on_timeout {
+    struct async_work_on_timeout *next;
+    void (*do_work)(async_context_t *context, struct async_work_on_timeout *worker);
+    absolute_time_t next_time;
+    void *user_data;
+} async_at_time_worker_t;
+typedef struct async_when_pending_worker {
+    struct async_when_pending_worker *next;
+    void (*do_work)(async_context_t *context, struct async_when_pending_worker *worker);
+    volatile bool work_pending;
+    void *user_data;
+} async_when_pending_worker_t;
+bool async_context_add_at_time_worker_at(async_context_t *context, async_at_time_worker_t *worker, absolute_time_t t);
+bool async_context_remove_at_time_worker(async_context_t *context, async_at_time_worker_t *worker);
+bool async_context_add_when_pending_worker(async_context_t *context, async_when_pending_worker_t *worker);
+void async_context_set_work_pending(async_context_t *context, async_when_pending_worker_t *worker);
+
+// Despacho interno usado por cyw43_host.c
+async_context_t *pico_host_async_context(void);
+void pico_host_atender(bool stdin_pronto);
+absolute_time_t pico_host_proximo_prazo(void);
+int pico_host_fd_stdin(void);
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef PICO_HOST_WS2812_PIO_H
+#define PICO_HOST_WS2812_PIO_H
+
+#include "pico_host.h"
+
+// No alvo o pioasm gera este cabeçalho a partir de ws2812.pio; no host a matriz não existe
+static const pio_program_t ws2812_program = {NULL, 0, -1};
+
+static inline void ws2812_program_init(PIO pio, uint sm, uint offset, uint pino, float freq) {}
+
+#endif
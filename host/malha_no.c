@@ -0,0 +1,125 @@
+// Nó da malha de alarme sobre UDP multicast no loopback: o mesmo malha_protocolo.c do
+// firmware, sem lwIP nem TAP, para medir a propagação entre vários processos.
+//
+//   ./malha_no 1 & ./malha_no 2 & ./malha_no 3 20   # o último descarta 20% do que recebe
+//
+// Linhas "1" e "0" no stdin ligam e desligam o alarme deste nó; cada mudança aplicada é
+// impressa com o instante CLOCK_MONOTONIC, comum a todos os processos da máquina.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include "malha_protocolo.h"
+
+#define MALHA_GRUPO "239.255.42.10"
+
+static int sock;
+static struct sockaddr_in grupo;
+static int perda_pct;
+
+static uint64_t agora_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void difundir(const malha_msg_t *m) {
+    uint8_t buf[MALHA_MSG_TAM];
+    malha_codificar(m, buf);
+    sendto(sock, buf, sizeof(buf), 0, (struct sockaddr*)&grupo, sizeof(grupo));
+}
+
+static void mostrar(const malha_t *n, const char *motivo) {
+    uint64_t t = agora_us();
+    printf("%llu.%06llu no %u: alarme %d (origem %u, relogio %lu) %s\n",
+        (unsigned long long)(t / 1000000), (unsigned long long)(t % 1000000), n->id, n->estado,
+        n->versao_origem, (unsigned long)n->versao_relogio, motivo);
+    fflush(stdout);
+}
+
+static int abrir_socket(void) {
+    int s = socket(AF_INET, SOCK_DGRAM, 0);
+    int um = 1;
+    setsockopt(s, SOL_SOCKET, SO_REUSEADDR, &um, sizeof(um));
+    setsockopt(s, SOL_SOCKET, SO_REUSEPORT, &um, sizeof(um));
+
+    struct sockaddr_in local = {.sin_family = AF_INET, .sin_port = htons(MALHA_PORTA)};
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(s, (struct sockaddr*)&local, sizeof(local)) < 0) {
+        perror("bind");
+        exit(1);
+    }
+
+    struct ip_mreq mreq;
+    mreq.imr_multiaddr.s_addr = inet_addr(MALHA_GRUPO);
+    mreq.imr_interface.s_addr = htonl(INADDR_LOOPBACK);
+    struct in_addr lo = {.s_addr = htonl(INADDR_LOOPBACK)};
+    if (setsockopt(s, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0 ||
+        setsockopt(s, IPPROTO_IP, IP_MULTICAST_IF, &lo, sizeof(lo)) < 0 ||
+        setsockopt(s, IPPROTO_IP, IP_MULTICAST_LOOP, &um, sizeof(um)) < 0) {
+        perror("multicast");
+        exit(1);
+    }
+    grupo.sin_family = AF_INET;
+    grupo.sin_port = htons(MALHA_PORTA);
+    grupo.sin_addr.s_addr = inet_addr(MALHA_GRUPO);
+    return s;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2 || atoi(argv[1]) <= 0 || atoi(argv[1]) > 0xffff) {
+        fprintf(stderr, "uso: %s <id 1..65535> [perda%%]\n", argv[0]);
+        return 1;
+    }
+    perda_pct = argc > 2 ? atoi(argv[2]) : 0;
+    srand(agora_us());
+    sock = abrir_socket();
+
+    malha_t no;
+    malha_init(&no, atoi(argv[1]), agora_us() / 1000);
+    mostrar(&no, "iniciado");
+
+    bool stdin_aberto = true;
+    while (true) {
+        uint32_t agora = agora_us() / 1000;
+        uint32_t proximo;
+        malha_msg_t m, saida;
+        while (malha_tick(&no, agora, &m, &proximo)) difundir(&m);
+
+        struct pollfd fds[2] = {{.fd = sock, .events = POLLIN}, {.fd = 0, .events = POLLIN}};
+        int espera = (int32_t)(proximo - agora);
+        if (poll(fds, stdin_aberto ? 2 : 1, espera > 0 ? espera : 0) < 0) break;
+
+        if (fds[0].revents & POLLIN) {
+            uint8_t buf[64];
+            ssize_t n = recv(sock, buf, sizeof(buf), 0);
+            if (n > 0 && rand() % 100 >= perda_pct && malha_decodificar(buf, n, &m)) {
+                unsigned r = malha_receber(&no, &m, agora_us() / 1000, &saida);
+                if (r & MALHA_ENVIAR) difundir(&saida);
+                if (r & MALHA_APLICAR) mostrar(&no, m.tipo == MALHA_EVENTO ? "evento" : "batimento");
+            }
+        }
+        if (stdin_aberto && (fds[1].revents & (POLLIN | POLLHUP))) {
+            char linha[16];
+            if (!fgets(linha, sizeof(linha), stdin)) {
+                stdin_aberto = false;
+            } else if (linha[0] == '0' || linha[0] == '1') {
+                malha_local(&no, linha[0] == '1', agora_us() / 1000, &m);
+                difundir(&m);
+                mostrar(&no, "local");
+            } else if (linha[0] == 's') {
+                printf("no %u: %d vizinhos, %lu reenvios, %lu duplicados\n", no.id,
+                    malha_num_vizinhos(&no, agora_us() / 1000), (unsigned long)no.reenviados,
+                    (unsigned long)no.duplicados);
+                fflush(stdout);
+            }
+        }
+    }
+    return 0;
+}
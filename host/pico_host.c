@@ -0,0 +1,401 @@
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/select.h>
+#include "pico_host.h"
+
+#define HOST_MAX_IRQS 8
+#define HOST_FIFO_TAM 8       // profundidade da FIFO do SIO
+#define HOST_CLK_SYS_HZ 125000000
+#define HOST_ESPERA_MAX_US 10000
+
+// --- Tempo ---
+
+static uint64_t inicio_us;
+
+static uint64_t agora_monotonico_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+uint64_t time_us_64(void) {
+    if (!inicio_us) inicio_us = agora_monotonico_us();
+    return agora_monotonico_us() - inicio_us;
+}
+
+void sleep_us(uint64_t us) {
+    struct timespec ts = {us / 1000000, (us % 1000000) * 1000};
+    while (nanosleep(&ts, &ts) && errno == EINTR) {}
+}
+
+void sleep_ms(uint32_t ms) {
+    sleep_us(ms * 1000ull);
+}
+
+// --- stdio ---
+
+static struct termios termios_original;
+static bool termios_alterado;
+static void (*chars_disponiveis)(void*);
+static void *chars_disponiveis_param;
+
+static void restaurar_terminal(void) {
+    if (termios_alterado) tcsetattr(STDIN_FILENO, TCSANOW, &termios_original);
+}
+
+bool stdio_init_all(void) {
+    time_us_64();
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    // Teclas chegam uma a uma, sem Enter, como no USB CDC da placa
+    if (isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &termios_original) == 0) {
+        struct termios t = termios_original;
+        t.c_lflag &= ~(ICANON | ECHO);
+        t.c_iflag &= ~(ICRNL | INLCR | IXON); // quadros binários da serial passam intactos
+        tcsetattr(STDIN_FILENO, TCSANOW, &t);
+        termios_alterado = true;
+        atexit(restaurar_terminal);
+    }
+    return true;
+}
+
+int getchar_timeout_us(uint32_t timeout_us) {
+    fd_set fds;
+    FD_ZERO(&fds);
+    FD_SET(STDIN_FILENO, &fds);
+    struct timeval tv = {timeout_us / 1000000, timeout_us % 1000000};
+    unsigned char c;
+    if (select(STDIN_FILENO + 1, &fds, NULL, NULL, &tv) <= 0) return PICO_ERROR_TIMEOUT;
+    if (read(STDIN_FILENO, &c, 1) != 1) return PICO_ERROR_TIMEOUT;
+    return c;
+}
+
+void stdio_set_chars_available_callback(void (*fn)(void*), void *param) {
+    chars_disponiveis = fn;
+    chars_disponiveis_param = param;
+}
+
+int pico_host_fd_stdin(void) {
+    return chars_disponiveis ? STDIN_FILENO : -1;
+}
+
+// --- GPIO ---
+
+static bool niveis[32];
+
+void gpio_init(uint gpio) {}
+void gpio_set_dir(uint gpio, bool saida) {}
+void gpio_set_function(uint gpio, int funcao) {}
+
+void gpio_put(uint gpio, bool valor) {
+    niveis[gpio & 31] = valor;
+}
+
+bool gpio_get(uint gpio) {
+    return niveis[gpio & 31];
+}
+
+void gpio_pull_up(uint gpio) {
+    niveis[gpio & 31] = true;
+}
+
+// Sem pinos físicos não há bordas: os botões ficam em repouso no host
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t eventos, bool ativo, gpio_irq_callback_t callback) {}
+
+void pico_get_unique_board_id(pico_unique_board_id_t *id) {
+    const char *env = getenv("PICO_HOST_NO_ID");
+    unsigned long n = env ? strtoul(env, NULL, 0) : (unsigned long)getpid();
+    memset(id->id, 0, sizeof(id->id));
+    id->id[6] = n >> 8;
+    id->id[7] = n;
+}
+
+// --- Núcleos e IRQs ---
+
+static _Thread_local uint core_atual;
+static _Thread_local uint32_t irqs_desabilitadas;
+
+static struct {
+    uint num;
+    uint core;
+    irq_handler_t handler;
+} irqs[HOST_MAX_IRQS];
+static int num_irqs;
+static uint32_t irqs_ativas[2];
+
+uint get_core_num(void) {
+    return core_atual;
+}
+
+uint32_t save_and_disable_interrupts(void) {
+    return irqs_desabilitadas++;
+}
+
+void restore_interrupts(uint32_t estado) {
+    irqs_desabilitadas = estado;
+}
+
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t prioridade) {
+    if (num_irqs < HOST_MAX_IRQS) {
+        irqs[num_irqs].num = num;
+        irqs[num_irqs].core = core_atual;
+        irqs[num_irqs].handler = handler;
+        num_irqs++;
+    }
+}
+
+void irq_set_enabled(uint num, bool ativo) {
+    if (ativo) irqs_ativas[core_atual] |= 1u << num;
+    else irqs_ativas[core_atual] &= ~(1u << num);
+}
+
+uint32_t clock_get_hz(int clk) {
+    return HOST_CLK_SYS_HZ;
+}
+
+// --- PWM: cada fatia com IRQ ligada sinaliza o wrap no seu período ---
+// Estado acessado só pelo núcleo que ligou PWM_IRQ_WRAP (o core1 no firmware)
+
+static struct {
+    bool ativa;
+    bool irq;
+    float div;
+    uint16_t top;
+    uint64_t proximo_wrap;
+} fatias[NUM_PWM_SLICES];
+static uint32_t pwm_status;
+
+static uint64_t periodo_us(uint slice) {
+    uint64_t p = (uint64_t)((fatias[slice].top + 1) * fatias[slice].div) / (HOST_CLK_SYS_HZ / 1000000);
+    return p ? p : 1;
+}
+
+void pwm_init(uint slice, pwm_config *c, bool iniciar) {
+    fatias[slice].div = c->div;
+    fatias[slice].top = c->top;
+    pwm_set_enabled(slice, iniciar);
+}
+
+void pwm_set_wrap(uint slice, uint16_t top) {
+    fatias[slice].top = top;
+}
+
+void pwm_set_chan_level(uint slice, uint canal, uint16_t nivel) {}
+
+void pwm_set_enabled(uint slice, bool ativo) {
+    fatias[slice].ativa = ativo;
+    fatias[slice].proximo_wrap = time_us_64() + periodo_us(slice);
+}
+
+void pwm_set_counter(uint slice, uint16_t contagem) {
+    fatias[slice].proximo_wrap = time_us_64() + periodo_us(slice);
+}
+
+void pwm_set_irq_enabled(uint slice, bool ativo) {
+    fatias[slice].irq = ativo;
+}
+
+void pwm_clear_irq(uint slice) {
+    pwm_status &= ~(1u << slice);
+}
+
+uint32_t pwm_get_irq_status_mask(void) {
+    return pwm_status;
+}
+
+static uint64_t pwm_proximo_wrap(void) {
+    uint64_t proximo = UINT64_MAX;
+    for (uint s = 0; s < NUM_PWM_SLICES; s++) {
+        if (fatias[s].ativa && fatias[s].irq && fatias[s].proximo_wrap < proximo) proximo = fatias[s].proximo_wrap;
+    }
+    return proximo;
+}
+
+static void pwm_avancar(uint64_t agora) {
+    for (uint s = 0; s < NUM_PWM_SLICES; s++) {
+        if (!fatias[s].ativa || !fatias[s].irq || agora < fatias[s].proximo_wrap) continue;
+        pwm_status |= 1u << s;
+        // Wraps perdidos enquanto a thread estava ocupada viram um só, como a flag do hardware
+        fatias[s].proximo_wrap += periodo_us(s);
+        if (fatias[s].proximo_wrap <= agora) fatias[s].proximo_wrap = agora + periodo_us(s);
+    }
+}
+
+// Roda os handlers que o núcleo atual registrou e cujas fontes estão sinalizadas
+static void despachar_irqs(void) {
+    if (irqs_desabilitadas || !(irqs_ativas[core_atual] & (1u << PWM_IRQ_WRAP))) return;
+    pwm_avancar(time_us_64());
+    if (!pwm_status) return;
+    for (int i = 0; i < num_irqs; i++) {
+        if (irqs[i].core == core_atual && irqs[i].num == PWM_IRQ_WRAP) irqs[i].handler();
+    }
+}
+
+// --- DMA, PIO, ADC ---
+
+static int proximo_canal_dma;
+pio_hw_t pico_host_pio0;
+adc_hw_t pico_host_adc;
+
+int dma_claim_unused_channel(bool obrigatorio) {
+    return proximo_canal_dma < 12 ? proximo_canal_dma++ : -1;
+}
+
+// --- I2C: o display só conta bytes ---
+
+static struct i2c_inst {
+    uint64_t bytes;
+} i2c1_inst;
+i2c_inst_t *i2c1 = &i2c1_inst;
+
+uint i2c_init(i2c_inst_t *i2c, uint baud) {
+    return baud;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t endereco, const uint8_t *dados, size_t len, bool nostop) {
+    i2c->bytes += len;
+    return (int)len;
+}
+
+// --- Multicore ---
+
+static pthread_t thread_core1;
+static pthread_mutex_t fifo_trava = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t fifo_cond = PTHREAD_COND_INITIALIZER;
+static uint32_t fifo[HOST_FIFO_TAM];
+static int fifo_inicio, fifo_ocupacao;
+
+static void *core1_entrada(void *arg) {
+    core_atual = 1;
+    ((void (*)(void))arg)();
+    return NULL;
+}
+
+void multicore_launch_core1(void (*entrada)(void)) {
+    pthread_create(&thread_core1, NULL, core1_entrada, (void*)entrada);
+}
+
+bool multicore_fifo_wready(void) {
+    pthread_mutex_lock(&fifo_trava);
+    bool pronto = fifo_ocupacao < HOST_FIFO_TAM;
+    pthread_mutex_unlock(&fifo_trava);
+    return pronto;
+}
+
+void multicore_fifo_push_blocking(uint32_t dado) {
+    pthread_mutex_lock(&fifo_trava);
+    while (fifo_ocupacao == HOST_FIFO_TAM) pthread_cond_wait(&fifo_cond, &fifo_trava);
+    fifo[(fifo_inicio + fifo_ocupacao++) % HOST_FIFO_TAM] = dado;
+    pthread_cond_broadcast(&fifo_cond);
+    pthread_mutex_unlock(&fifo_trava);
+}
+
+// O core1 passa quase todo o tempo aqui; é onde as IRQs dele são atendidas
+uint32_t multicore_fifo_pop_blocking(void) {
+    pthread_mutex_lock(&fifo_trava);
+    while (fifo_ocupacao == 0) {
+        uint64_t agora = time_us_64();
+        uint64_t prazo = pwm_proximo_wrap();
+        if (prazo > agora + HOST_ESPERA_MAX_US) prazo = agora + HOST_ESPERA_MAX_US;
+        uint64_t abs_us = agora_monotonico_us() + (prazo > agora ? prazo - agora : 0);
+        struct timespec ts = {abs_us / 1000000, (abs_us % 1000000) * 1000};
+        pthread_cond_timedwait(&fifo_cond, &fifo_trava, &ts);
+        pthread_mutex_unlock(&fifo_trava);
+        despachar_irqs();
+        pthread_mutex_lock(&fifo_trava);
+    }
+    uint32_t dado = fifo[fifo_inicio];
+    fifo_inicio = (fifo_inicio + 1) % HOST_FIFO_TAM;
+    fifo_ocupacao--;
+    pthread_cond_broadcast(&fifo_cond);
+    pthread_mutex_unlock(&fifo_trava);
+    return dado;
+}
+
+void multicore_fifo_drain(void) {
+    pthread_mutex_lock(&fifo_trava);
+    fifo_ocupacao = 0;
+    pthread_cond_broadcast(&fifo_cond);
+    pthread_mutex_unlock(&fifo_trava);
+}
+
+// --- async_context (só o core0 usa) ---
+
+struct async_context {
+    async_at_time_worker_t *em_horario;
+    async_when_pending_worker_t *pendentes;
+};
+
+static async_context_t contexto;
+
+async_context_t *pico_host_async_context(void) {
+    return &contexto;
+}
+
+bool async_context_add_at_time_worker_at(async_context_t *context, async_at_time_worker_t *worker, absolute_time_t t) {
+    async_context_remove_at_time_worker(context, worker);
+    worker->next_time = t;
+    worker->next = context->em_horario;
+    context->em_horario = worker;
+    return true;
+}
+
+bool async_context_remove_at_time_worker(async_context_t *context, async_at_time_worker_t *worker) {
+    for (async_at_time_worker_t **w = &context->em_horario; *w; w = &(*w)->next) {
+        if (*w == worker) {
+            *w = worker->next;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool async_context_add_when_pending_worker(async_context_t *context, async_when_pending_worker_t *worker) {
+    worker->next = context->pendentes;
+    context->pendentes = worker;
+    return true;
+}
+
+void async_context_set_work_pending(async_context_t *context, async_when_pending_worker_t *worker) {
+    worker->work_pending = true;
+}
+
+absolute_time_t pico_host_proximo_prazo(void) {
+    absolute_time_t prazo = at_the_end_of_time;
+    for (async_at_time_worker_t *w = contexto.em_horario; w; w = w->next) {
+        if (w->next_time < prazo) prazo = w->next_time;
+    }
+    for (async_when_pending_worker_t *w = contexto.pendentes; w; w = w->next) {
+        if (w->work_pending) return 0;
+    }
+    return prazo;
+}
+
+// Um passo do laço do core0: workers vencidos, pendentes e teclado
+void pico_host_atender(bool stdin_pronto) {
+    absolute_time_t agora = get_absolute_time();
+    bool rodou;
+    do {
+        // Um worker pode se reagendar ou remover outros; recomeça a busca a cada execução
+        rodou = false;
+        for (async_at_time_worker_t *w = contexto.em_horario; w; w = w->next) {
+            if (w->next_time <= agora) {
+                async_context_remove_at_time_worker(&contexto, w);
+                w->do_work(&contexto, w);
+                rodou = true;
+                break;
+            }
+        }
+    } while (rodou);
+    for (async_when_pending_worker_t *w = contexto.pendentes; w; w = w->next) {
+        if (w->work_pending) {
+            w->work_pending = false;
+            w->do_work(&contexto, w);
+        }
+    }
+    if (stdin_pronto && chars_disponiveis) chars_disponiveis(chars_disponiveis_param);
+}
@@ -0,0 +1,116 @@
+// Converte os rastros de /rastros (ou da tecla 't' no console) para o formato de trace do
+// Chrome, que o chrome://tracing e o ui.perfetto.dev abrem, ou para pilhas "folded" do
+// flamegraph.pl/speedscope, com o tempo próprio de cada ponto em nanossegundos.
+//
+//   curl -s http://192.168.4.1/rastros | ./rastro_chrome > rastros.json
+//   curl -s http://192.168.4.1/rastros | ./rastro_chrome -f | flamegraph.pl > rastros.svg
+//
+// Cada requisição vira uma linha (tid) própria no trace; na pilha folded a raiz é a rota.
+// Linhas que não fazem parte de um rastro (texto do console, por exemplo) são ignoradas.
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PILHA_MAX 32
+
+typedef struct {
+    char nome[32];
+    double inicio_ns;
+    double filhos_ns; // tempo dos pontos aninhados, descontado do tempo próprio
+} quadro_t;
+
+static bool folded;
+static bool primeiro_evento = true;
+
+// Rastro em curso
+static unsigned long seq;
+static char rota[64];
+static unsigned long inicio_us;
+static double ns_por_ciclo;
+static quadro_t pilha[PILHA_MAX];
+static int altura;
+
+static void json_evento(const char *nome, char fase, double ts_us) {
+    printf("%s\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%lu}",
+        primeiro_evento ? "" : ",", nome, fase, ts_us, seq);
+    primeiro_evento = false;
+}
+
+static void folded_empilhar(const char *nome, double t_ns) {
+    if (altura == PILHA_MAX) return;
+    quadro_t *q = &pilha[altura++];
+    snprintf(q->nome, sizeof(q->nome), "%s", nome);
+    q->inicio_ns = t_ns;
+    q->filhos_ns = 0;
+}
+
+static void folded_desempilhar(const char *nome, double t_ns) {
+    // Um fim sem o início correspondente (rastro truncado) é descartado
+    int i = altura - 1;
+    while (i >= 0 && strcmp(pilha[i].nome, nome) != 0) i--;
+    if (i < 0) return;
+    altura = i;
+    double total = t_ns - pilha[i].inicio_ns;
+    if (i > 0) pilha[i - 1].filhos_ns += total;
+
+    printf("%s", rota);
+    for (int j = 0; j <= i; j++) printf(";%s", pilha[j].nome);
+    printf(" %.0f\n", total - pilha[i].filhos_ns);
+}
+
+static void rastro_comecar(const char *linha) {
+    char r[sizeof(rota)];
+    unsigned long hz;
+    unsigned n;
+    if (sscanf(linha, "rastro %lu %63s us=%lu hz=%lu n=%u", &seq, r, &inicio_us, &hz, &n) != 5 || hz == 0) {
+        ns_por_ciclo = 0;
+        return;
+    }
+    snprintf(rota, sizeof(rota), "%s", r);
+    ns_por_ciclo = 1e9 / hz;
+    altura = 0;
+    if (strstr(linha, " truncado")) fprintf(stderr, "rastro %lu (%s) truncado\n", seq, rota);
+    if (!folded) {
+        printf("%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%lu,\"args\":{\"name\":\"#%lu %s\"}}",
+            primeiro_evento ? "" : ",", seq, seq, rota);
+        primeiro_evento = false;
+    }
+}
+
+static void rastro_marca(char fase, const char *nome, unsigned long ciclos) {
+    double t_ns = ciclos * ns_por_ciclo;
+    if (!folded) {
+        json_evento(nome, fase, inicio_us + t_ns / 1000);
+    } else if (fase == 'B') {
+        folded_empilhar(nome, t_ns);
+    } else {
+        folded_desempilhar(nome, t_ns);
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1 && strcmp(argv[1], "-f") == 0) {
+        folded = true;
+    } else if (argc > 1) {
+        fprintf(stderr, "uso: %s [-f] < rastros.txt\n", argv[0]);
+        return 1;
+    }
+    if (!folded) printf("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+
+    char linha[256];
+    while (fgets(linha, sizeof(linha), stdin)) {
+        char fase, nome[32];
+        unsigned long ciclos;
+        if (strncmp(linha, "rastro ", 7) == 0) {
+            rastro_comecar(linha);
+        } else if (ns_por_ciclo > 0 && sscanf(linha, "%c %31s %lu", &fase, nome, &ciclos) == 3 &&
+                   (fase == 'B' || fase == 'E')) {
+            rastro_marca(fase, nome, ciclos);
+        }
+    }
+
+    if (!folded) printf("\n]}\n");
+    return 0;
+}
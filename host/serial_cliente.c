@@ -0,0 +1,157 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "serial_cliente.h"
+
+#define PRAZO_PADRAO_MS 1000
+
+static int64_t agora_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+void serial_cliente_usar_fd(serial_cliente_t *c, int fd) {
+    memset(c, 0, sizeof(*c));
+    c->fd = fd;
+    serial_decodificador_init(&c->dec);
+    struct termios t;
+    if (tcgetattr(fd, &t) == 0) {
+        cfmakeraw(&t);
+        tcsetattr(fd, TCSANOW, &t);
+    }
+}
+
+int serial_cliente_abrir(serial_cliente_t *c, const char *caminho) {
+    int fd = open(caminho, O_RDWR | O_NOCTTY);
+    if (fd < 0) return -1;
+    serial_cliente_usar_fd(c, fd);
+    tcflush(fd, TCIOFLUSH);
+    return 0;
+}
+
+void serial_cliente_fechar(serial_cliente_t *c) {
+    close(c->fd);
+    c->fd = -1;
+}
+
+static int escrever_tudo(int fd, const uint8_t *p, size_t n) {
+    while (n) {
+        ssize_t w = write(fd, p, n);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += w;
+        n -= w;
+    }
+    return 0;
+}
+
+int serial_cliente_enviar(serial_cliente_t *c, uint8_t comando, const uint8_t *dados, int len) {
+    uint8_t quadro[SERIAL_QUADRO_MAX - 2];
+    uint8_t saida[SERIAL_CODIFICADO_MAX(SERIAL_QUADRO_MAX - 2)];
+    if (len < 0 || len + 2 > (int)sizeof(quadro)) return -1;
+    uint8_t seq = c->seq++;
+    quadro[0] = comando;
+    quadro[1] = seq;
+    memcpy(quadro + 2, dados, len);
+    size_t n = serial_codificar(quadro, len + 2, saida, sizeof(saida));
+    return escrever_tudo(c->fd, saida, n) < 0 ? -1 : seq;
+}
+
+int serial_cliente_receber(serial_cliente_t *c, uint8_t *quadro, int max, int prazo_ms) {
+    int64_t fim = agora_ms() + prazo_ms;
+    while (true) {
+        while (c->entrada_pos < c->entrada_len) {
+            serial_evento_t e = serial_decodificar(&c->dec, c->entrada[c->entrada_pos++]);
+            if (e == SERIAL_TECLA) {
+                c->texto++;
+            } else if (e == SERIAL_QUADRO) {
+                if (c->dec.len < 3 || !(c->dec.quadro[0] & SERIAL_RESPOSTA) || c->dec.len > max) {
+                    c->descartados++;
+                    continue;
+                }
+                memcpy(quadro, c->dec.quadro, c->dec.len);
+                return c->dec.len;
+            }
+        }
+        int espera = (int)(fim - agora_ms());
+        struct pollfd pfd = {.fd = c->fd, .events = POLLIN};
+        if (espera < 0 || poll(&pfd, 1, espera) == 0) return 0;
+        ssize_t n = read(c->fd, c->entrada, sizeof(c->entrada));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        c->entrada_pos = 0;
+        c->entrada_len = n;
+    }
+}
+
+int serial_cliente_pedir(serial_cliente_t *c, uint8_t comando, const uint8_t *dados, int len,
+    uint8_t *resposta, int *resposta_len, int prazo_ms) {
+    int seq = serial_cliente_enviar(c, comando, dados, len);
+    if (seq < 0) return -1;
+    int64_t fim = agora_ms() + prazo_ms;
+    uint8_t quadro[SERIAL_QUADRO_MAX];
+    while (true) {
+        int n = serial_cliente_receber(c, quadro, sizeof(quadro), (int)(fim - agora_ms()));
+        if (n <= 0) return -1;
+        if (quadro[0] != (comando | SERIAL_RESPOSTA) || quadro[1] != seq) {
+            c->descartados++; // resposta atrasada de um pedido anterior
+            continue;
+        }
+        if (resposta) memcpy(resposta, quadro + 3, n - 3);
+        if (resposta_len) *resposta_len = n - 3;
+        return quadro[2];
+    }
+}
+
+static int pedir_estado(serial_cliente_t *c, uint8_t comando, const uint8_t *dados, int len,
+    uint8_t estado[SERIAL_ESTADO_TAM]) {
+    uint8_t resposta[SERIAL_DADOS_MAX];
+    int n;
+    int status = serial_cliente_pedir(c, comando, dados, len, resposta, &n, PRAZO_PADRAO_MS);
+    if (status == SERIAL_OK && estado) {
+        if (n < SERIAL_ESTADO_TAM) return SERIAL_TAMANHO_INVALIDO;
+        memcpy(estado, resposta, SERIAL_ESTADO_TAM);
+    }
+    return status;
+}
+
+int serial_cliente_comandos(serial_cliente_t *c, const uint8_t (*pares)[2], int n, uint8_t estado[SERIAL_ESTADO_TAM]) {
+    return pedir_estado(c, SERIAL_CMD_COMANDOS, (const uint8_t*)pares, 2 * n, estado);
+}
+
+int serial_cliente_estado(serial_cliente_t *c, uint8_t estado[SERIAL_ESTADO_TAM]) {
+    return pedir_estado(c, SERIAL_CMD_ESTADO, NULL, 0, estado);
+}
+
+int serial_cliente_tela(serial_cliente_t *c, int tela, int matriz) {
+    uint8_t dados[2] = {tela, matriz};
+    return serial_cliente_pedir(c, SERIAL_CMD_TELA, dados, matriz < 0 ? 1 : 2, NULL, NULL, PRAZO_PADRAO_MS);
+}
+
+static uint32_t ler_u32(const uint8_t *p) {
+    return p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+int serial_cliente_metricas(serial_cliente_t *c, uint32_t *contadores, int max_contadores,
+    uint32_t (*hist)[2], int max_hist, int *num_hist) {
+    uint8_t r[SERIAL_DADOS_MAX];
+    int n;
+    int status = serial_cliente_pedir(c, SERIAL_CMD_METRICAS, NULL, 0, r, &n, PRAZO_PADRAO_MS);
+    if (status != SERIAL_OK) return status > 0 ? -status : -1;
+    if (n < 2 || n < 2 + 4 * r[0] + 8 * r[1]) return -1;
+    int nc = r[0], nh = r[1];
+    for (int i = 0; i < nc && i < max_contadores; i++) contadores[i] = ler_u32(r + 2 + 4 * i);
+    for (int i = 0; i < nh && i < max_hist; i++) {
+        hist[i][0] = ler_u32(r + 2 + 4 * nc + 8 * i);
+        hist[i][1] = ler_u32(r + 2 + 4 * nc + 8 * i + 4);
+    }
+    if (num_hist) *num_hist = nh;
+    return nc;
+}
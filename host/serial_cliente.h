@@ -0,0 +1,44 @@
+#ifndef SERIAL_CLIENTE_H
+#define SERIAL_CLIENTE_H
+
+#include <stdint.h>
+#include "serial_quadro.h"
+
+// Cliente do protocolo binário da serial (serial_quadro.h) para bancadas de teste no Linux.
+// Linhas de texto do console que chegam entre as respostas são contadas e ignoradas.
+
+typedef struct {
+    int fd;
+    uint8_t seq;
+    serial_decodificador_t dec;
+    uint8_t entrada[512]; // lido do descritor e ainda não decodificado
+    uint16_t entrada_pos;
+    uint16_t entrada_len;
+    uint32_t texto;      // bytes de console ignorados
+    uint32_t descartados; // respostas inválidas ou fora de ordem
+} serial_cliente_t;
+
+// Abre o dispositivo (ex.: /dev/ttyACM0) em modo cru; 0 ou -1 com errno
+int serial_cliente_abrir(serial_cliente_t *c, const char *caminho);
+// Usa um descritor já aberto (ex.: o mestre de um pseudo-terminal), também em modo cru
+void serial_cliente_usar_fd(serial_cliente_t *c, int fd);
+void serial_cliente_fechar(serial_cliente_t *c);
+
+// Envia sem esperar: permite vários pedidos em voo (até SERIAL_FILA_TAM na placa). Retorna o seq ou -1
+int serial_cliente_enviar(serial_cliente_t *c, uint8_t comando, const uint8_t *dados, int len);
+// Próxima resposta: quadro = [comando | 0x80][seq][status][dados...]. Retorna o tamanho, 0 no prazo esgotado ou -1
+int serial_cliente_receber(serial_cliente_t *c, uint8_t *quadro, int max, int prazo_ms);
+
+// Pedido e resposta casados pelo seq. Retorna o serial_status_t, ou -1 sem resposta no prazo
+int serial_cliente_pedir(serial_cliente_t *c, uint8_t comando, const uint8_t *dados, int len,
+    uint8_t *resposta, int *resposta_len, int prazo_ms);
+
+// Atalhos; pares = [serial_atuador_t][0|1] aplicados num só lote
+int serial_cliente_comandos(serial_cliente_t *c, const uint8_t (*pares)[2], int n, uint8_t estado[SERIAL_ESTADO_TAM]);
+int serial_cliente_estado(serial_cliente_t *c, uint8_t estado[SERIAL_ESTADO_TAM]);
+int serial_cliente_tela(serial_cliente_t *c, int tela, int matriz); // matriz < 0 mantém o padrão
+// contadores e pares (n, max_us) dos histogramas, na ordem de metricas.h; retorna quantos contadores vieram
+int serial_cliente_metricas(serial_cliente_t *c, uint32_t *contadores, int max_contadores,
+    uint32_t (*hist)[2], int max_hist, int *num_hist);
+
+#endif
@@ -0,0 +1,165 @@
+// Latência e vazão do protocolo binário da serial através de um pseudo-terminal.
+//
+//   ./serial_vazao [segundos] [dispositivo] [janela]
+//
+// Sem dispositivo, uma thread faz o papel da placa no lado escravo do pty: o mesmo
+// serial_quadro.c decodifica, responde ECO e solta linhas de texto entre as respostas, como o
+// printf do firmware. Com um dispositivo (ex.: /dev/ttyACM0) mede a placa de verdade; a janela
+// de pedidos em voo não deve passar de SERIAL_FILA_TAM.
+
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "serial_cliente.h"
+
+#define ECO_MAX (SERIAL_QUADRO_MAX - 4 < SERIAL_DADOS_MAX ? SERIAL_QUADRO_MAX - 4 : SERIAL_DADOS_MAX)
+#define PRAZO_MS 2000
+
+static uint64_t agora_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// --- placa simulada ---
+
+static void *placa(void *arg) {
+    int fd = (intptr_t)arg;
+    serial_decodificador_t dec;
+    serial_decodificador_init(&dec);
+    uint8_t buf[512], resposta[SERIAL_QUADRO_MAX - 2], saida[SERIAL_CODIFICADO_MAX(SERIAL_QUADRO_MAX - 2)];
+    uint32_t respostas = 0;
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof(buf))) > 0) {
+        for (ssize_t i = 0; i < n; i++) {
+            if (serial_decodificar(&dec, buf[i]) != SERIAL_QUADRO) continue;
+            resposta[0] = dec.quadro[0] | SERIAL_RESPOSTA;
+            resposta[1] = dec.quadro[1];
+            int len = 3;
+            if (dec.quadro[0] == SERIAL_CMD_ECO && dec.len - 2 <= SERIAL_DADOS_MAX) {
+                resposta[2] = SERIAL_OK;
+                memcpy(resposta + 3, dec.quadro + 2, dec.len - 2);
+                len += dec.len - 2;
+            } else {
+                resposta[2] = SERIAL_DESCONHECIDO;
+            }
+            size_t m = serial_codificar(resposta, len, saida, sizeof(saida));
+            if (write(fd, saida, m) < 0) return NULL;
+            if (++respostas % 64 == 0) {
+                static const char LINHA[] = "DHCPS: client connected: MAC=aa:bb:cc:dd:ee:ff IP=192.168.4.16\r\n";
+                if (write(fd, LINHA, sizeof(LINHA) - 1) < 0) return NULL;
+            }
+        }
+    }
+    return NULL;
+}
+
+static int abrir_pty(int *escravo) {
+    int mestre = posix_openpt(O_RDWR | O_NOCTTY);
+    if (mestre < 0 || grantpt(mestre) < 0 || unlockpt(mestre) < 0) return -1;
+    *escravo = open(ptsname(mestre), O_RDWR | O_NOCTTY);
+    if (*escravo < 0) return -1;
+    struct termios t;
+    tcgetattr(*escravo, &t);
+    cfmakeraw(&t);
+    tcsetattr(*escravo, TCSANOW, &t);
+    return mestre;
+}
+
+// --- medidas ---
+
+static void preencher(uint8_t *p, int len, uint32_t semente) {
+    for (int i = 0; i < len; i++) p[i] = (uint8_t)(semente * 2654435761u >> (i % 24)) + i;
+}
+
+static int comparar_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+static int medir_latencia(serial_cliente_t *c, int pedidos, int tam) {
+    uint32_t *amostras = malloc(pedidos * sizeof(uint32_t));
+    uint8_t dados[ECO_MAX], resposta[SERIAL_DADOS_MAX];
+    for (int i = 0; i < pedidos; i++) {
+        preencher(dados, tam, i);
+        int n;
+        uint64_t t0 = agora_us();
+        int status = serial_cliente_pedir(c, SERIAL_CMD_ECO, dados, tam, resposta, &n, PRAZO_MS);
+        amostras[i] = agora_us() - t0;
+        if (status != SERIAL_OK || n != tam || memcmp(dados, resposta, tam) != 0) {
+            fprintf(stderr, "eco %d: status %d, %d bytes\n", i, status, n);
+            free(amostras);
+            return -1;
+        }
+    }
+    qsort(amostras, pedidos, sizeof(uint32_t), comparar_u32);
+    uint64_t soma = 0;
+    for (int i = 0; i < pedidos; i++) soma += amostras[i];
+    printf("latencia eco %3d B: media %lu us, p50 %lu us, p99 %lu us, max %lu us (%d pedidos)\n", tam,
+        (unsigned long)(soma / pedidos), (unsigned long)amostras[pedidos / 2],
+        (unsigned long)amostras[pedidos * 99 / 100], (unsigned long)amostras[pedidos - 1], pedidos);
+    free(amostras);
+    return 0;
+}
+
+// Mantém janela pedidos em voo; as respostas voltam na ordem dos pedidos
+static int medir_vazao(serial_cliente_t *c, int segundos, int janela) {
+    uint8_t dados[ECO_MAX], quadro[SERIAL_QUADRO_MAX];
+    uint32_t enviados = 0, recebidos = 0;
+    uint8_t seq0 = c->seq;
+    uint64_t fim = agora_us() + (uint64_t)segundos * 1000000, inicio = agora_us();
+    while (agora_us() < fim || recebidos < enviados) {
+        while (enviados - recebidos < (uint32_t)janela && agora_us() < fim) {
+            preencher(dados, ECO_MAX, enviados);
+            if (serial_cliente_enviar(c, SERIAL_CMD_ECO, dados, ECO_MAX) < 0) return -1;
+            enviados++;
+        }
+        int n = serial_cliente_receber(c, quadro, sizeof(quadro), PRAZO_MS);
+        preencher(dados, ECO_MAX, recebidos);
+        if (n != 3 + ECO_MAX || quadro[1] != (uint8_t)(seq0 + recebidos) || quadro[2] != SERIAL_OK ||
+            memcmp(quadro + 3, dados, ECO_MAX) != 0) {
+            fprintf(stderr, "resposta %lu invalida (%d bytes)\n", (unsigned long)recebidos, n);
+            return -1;
+        }
+        recebidos++;
+    }
+    double s = (agora_us() - inicio) / 1e6;
+    printf("vazao eco %d B, janela %d: %.0f quadros/s, %.1f KB/s de dados em cada sentido\n",
+        ECO_MAX, janela, recebidos / s, recebidos * (double)ECO_MAX / s / 1024);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    int segundos = argc > 1 ? atoi(argv[1]) : 2;
+    const char *dispositivo = argc > 2 ? argv[2] : NULL;
+    int janela = argc > 3 ? atoi(argv[3]) : 4;
+
+    serial_cliente_t c;
+    pthread_t t;
+    if (dispositivo) {
+        if (serial_cliente_abrir(&c, dispositivo) < 0) {
+            perror(dispositivo);
+            return 1;
+        }
+    } else {
+        int escravo;
+        int mestre = abrir_pty(&escravo);
+        if (mestre < 0) {
+            perror("pty");
+            return 1;
+        }
+        serial_cliente_usar_fd(&c, mestre);
+        pthread_create(&t, NULL, placa, (void*)(intptr_t)escravo);
+    }
+
+    int erro = medir_latencia(&c, 1000, 16) || medir_latencia(&c, 1000, ECO_MAX) || medir_vazao(&c, segundos, janela);
+    printf("texto de console ignorado: %lu bytes, respostas descartadas: %lu, erros de crc: %lu\n",
+        (unsigned long)c.texto, (unsigned long)c.descartados, (unsigned long)c.dec.erros_crc);
+    return erro ? 1 : 0;
+}
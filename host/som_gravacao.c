@@ -0,0 +1,204 @@
+// Análise de nível sonoro (som.c) sobre áudio gravado: o WAV é levado a SOM_TAXA_HZ e a
+// contagens do ADC de 12 bits em torno de meia escala, como o microfone da placa entrega, e
+// passa bloco a bloco pelo mesmo som_analisar_bloco e detector do firmware. Imprime cada
+// disparo, o RMS máximo por segundo e o custo por bloco.
+//
+//   ./som_gravacao [-l limiar_rms] [-m sustentado_ms] [-e escala] [gravacao.wav]
+//
+// O WAV precisa ser PCM de 16 bits (só o primeiro canal é usado); outras taxas são levadas
+// a SOM_TAXA_HZ pela média de cada intervalo. A escala padrão põe o fundo de escala de 16
+// bits no fundo de escala do ADC. Sem arquivo, roda uma gravação sintética de 20 s (fundo,
+// rajadas curtas de 1,6 kHz, sirene de 5 s) e falha se o disparo não vier só na sirene,
+// SOM_SUSTENTADO_MS depois do início, ou se o RMS inteiro se afastar do calculado em double.
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "microfone.h"
+
+#define BLOCOS_POR_S (SOM_TAXA_HZ / SOM_BLOCO)
+#define MEDIR_REPETICOES 20
+
+typedef struct {
+    int16_t *amostras;
+    uint32_t n;
+    uint32_t taxa_hz;
+} gravacao_t;
+
+static uint32_t le32(const uint8_t *p) {
+    return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint16_t le16(const uint8_t *p) {
+    return p[0] | p[1] << 8;
+}
+
+static bool ler_wav(const char *caminho, gravacao_t *g) {
+    FILE *f = fopen(caminho, "rb");
+    if (!f) {
+        perror(caminho);
+        return false;
+    }
+    uint8_t cab[12], pedaco[8], fmt[16];
+    uint16_t canais = 0, bits = 0, formato = 0;
+    bool ok = fread(cab, 1, 12, f) == 12 && memcmp(cab, "RIFF", 4) == 0 && memcmp(cab + 8, "WAVE", 4) == 0;
+    while (ok && fread(pedaco, 1, 8, f) == 8) {
+        uint32_t tam = le32(pedaco + 4);
+        if (memcmp(pedaco, "fmt ", 4) == 0 && tam >= 16) {
+            ok = fread(fmt, 1, 16, f) == 16 && fseek(f, tam - 16 + (tam & 1), SEEK_CUR) == 0;
+            formato = le16(fmt);
+            canais = le16(fmt + 2);
+            g->taxa_hz = le32(fmt + 4);
+            bits = le16(fmt + 14);
+        } else if (memcmp(pedaco, "data", 4) == 0) {
+            if (formato != 1 || bits != 16 || canais == 0 || g->taxa_hz == 0) break;
+            uint8_t *dados = malloc(tam);
+            uint32_t lidos = fread(dados, 1, tam, f);
+            g->n = lidos / (2 * canais);
+            g->amostras = malloc(g->n * sizeof(int16_t) + 1);
+            for (uint32_t i = 0; i < g->n; i++) g->amostras[i] = (int16_t)le16(dados + 2 * canais * i);
+            free(dados);
+            fclose(f);
+            return true;
+        } else {
+            ok = fseek(f, tam + (tam & 1), SEEK_CUR) == 0;
+        }
+    }
+    fprintf(stderr, "%s: precisa ser WAV PCM de 16 bits\n", caminho);
+    fclose(f);
+    return false;
+}
+
+// Média de cada intervalo de 1/SOM_TAXA_HZ s, escalada para contagens do ADC e saturada
+static uint16_t *para_adc(const gravacao_t *g, double escala, uint32_t *n) {
+    *n = (uint32_t)((uint64_t)g->n * SOM_TAXA_HZ / g->taxa_hz);
+    uint16_t *adc = malloc((*n + 1) * sizeof(uint16_t));
+    for (uint32_t i = 0; i < *n; i++) {
+        uint64_t ini = (uint64_t)i * g->taxa_hz / SOM_TAXA_HZ, fim = (uint64_t)(i + 1) * g->taxa_hz / SOM_TAXA_HZ;
+        if (fim <= ini) fim = ini + 1;
+        double soma = 0;
+        for (uint64_t j = ini; j < fim; j++) soma += g->amostras[j];
+        long v = lround(2048 + soma / (fim - ini) * escala);
+        adc[i] = v < 0 ? 0 : v > 4095 ? 4095 : (uint16_t)v;
+    }
+    return adc;
+}
+
+static double ruido(double sigma) {
+    double u = (rand() + 1.0) / (RAND_MAX + 2.0), v = (rand() + 1.0) / (RAND_MAX + 2.0);
+    return sigma * sqrt(-2 * log(u)) * cos(2 * M_PI * v);
+}
+
+// Fundo em todo o trecho; rajadas de 0,25 s a cada 0,6 s entre 6 e 10 s; sirene de 12 a 17 s
+#define SIRENE_INICIO_S 12.0
+#define SIRENE_FIM_S 17.0
+
+static void sintetizar(gravacao_t *g) {
+    g->taxa_hz = SOM_TAXA_HZ;
+    g->n = 20 * SOM_TAXA_HZ;
+    g->amostras = malloc(g->n * sizeof(int16_t));
+    double fase = 0;
+    for (uint32_t i = 0; i < g->n; i++) {
+        double t = (double)i / g->taxa_hz, s = ruido(300);
+        if (t >= 6 && t < 10 && fmod(t - 6, 0.6) < 0.25) s += 16000 * sin(2 * M_PI * 1600 * t);
+        if (t >= SIRENE_INICIO_S && t < SIRENE_FIM_S) {
+            fase += 2 * M_PI * (600 + 600 * fmod(t, 1.0)) / g->taxa_hz; // "whoop" de 600 a 1200 Hz
+            s += 16000 * sin(fase);
+        }
+        g->amostras[i] = (int16_t)lround(s);
+    }
+}
+
+// Referência em double para o mesmo bloco
+static double rms_referencia(const uint16_t *a, uint32_t n) {
+    double media = 0, var = 0;
+    for (uint32_t i = 0; i < n; i++) media += a[i];
+    media /= n;
+    for (uint32_t i = 0; i < n; i++) var += (a[i] - media) * (a[i] - media);
+    return sqrt(var / n);
+}
+
+static double agora_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv) {
+    uint16_t limiar = SOM_LIMIAR_RMS, sustentado_ms = SOM_SUSTENTADO_MS;
+    double escala = 2048.0 / 32768;
+    int opt;
+    while ((opt = getopt(argc, argv, "l:m:e:")) != -1) {
+        switch (opt) {
+            case 'l': limiar = atoi(optarg); break;
+            case 'm': sustentado_ms = atoi(optarg); break;
+            case 'e': escala = atof(optarg) * 2048.0 / 32768; break;
+            default:
+                fprintf(stderr, "uso: %s [-l limiar_rms] [-m sustentado_ms] [-e escala] [gravacao.wav]\n", argv[0]);
+                return 2;
+        }
+    }
+    bool sintetica = optind >= argc;
+    gravacao_t g = {0};
+    if (sintetica) sintetizar(&g);
+    else if (!ler_wav(argv[optind], &g)) return 2;
+
+    uint32_t n;
+    uint16_t *adc = para_adc(&g, escala, &n);
+    uint32_t blocos = n / SOM_BLOCO;
+    printf("som_gravacao: %s, %lu amostras a %lu Hz -> %lu blocos de %d a %d Hz; limiar %u, %u ms\n",
+           sintetica ? "sintética" : argv[optind], (unsigned long)g.n, (unsigned long)g.taxa_hz,
+           (unsigned long)blocos, SOM_BLOCO, SOM_TAXA_HZ, limiar, sustentado_ms);
+
+    // Mesma conversão de microfone_configurar
+    som_detector_t d;
+    som_detector_init(&d, limiar, (uint32_t)sustentado_ms * SOM_TAXA_HZ / SOM_BLOCO / 1000);
+    uint32_t disparos = 0, fora_da_sirene = 0;
+    double primeiro_disparo = -1, erro_rms = 0;
+    uint16_t max_segundo = 0;
+    for (uint32_t b = 0; b < blocos; b++) {
+        const uint16_t *bloco = adc + b * SOM_BLOCO;
+        som_bloco_t r = som_analisar_bloco(bloco, SOM_BLOCO);
+        double erro = fabs(r.rms - rms_referencia(bloco, SOM_BLOCO));
+        if (erro > erro_rms) erro_rms = erro;
+        if (r.rms > max_segundo) max_segundo = r.rms;
+        double t = (double)(b + 1) * SOM_BLOCO / SOM_TAXA_HZ; // fim do bloco
+        if (som_detector_atualizar(&d, r.rms)) {
+            disparos++;
+            if (primeiro_disparo < 0) primeiro_disparo = t;
+            if (t < SIRENE_INICIO_S || t > SIRENE_FIM_S) fora_da_sirene++;
+            printf("%7.2f s  DISPARO: rms %u, pico %u\n", t, r.rms, r.pico);
+        }
+        if ((b + 1) % BLOCOS_POR_S == 0) {
+            printf("%7.2f s  rms máximo %4u\n", t, max_segundo);
+            max_segundo = 0;
+        }
+    }
+
+    // Custo: a análise de todos os blocos, repetida
+    double inicio = agora_s();
+    volatile uint32_t sumidouro = 0;
+    for (int r = 0; r < MEDIR_REPETICOES; r++) {
+        for (uint32_t b = 0; b < blocos; b++) sumidouro += som_analisar_bloco(adc + b * SOM_BLOCO, SOM_BLOCO).rms;
+    }
+    double ns_bloco = (agora_s() - inicio) * 1e9 / ((double)MEDIR_REPETICOES * (blocos ? blocos : 1));
+    printf("%lu disparos; erro máximo do RMS inteiro %.2f contagens; %.0f ns por bloco (%.2f ns/amostra)\n",
+           (unsigned long)disparos, erro_rms, ns_bloco, ns_bloco / SOM_BLOCO);
+
+    free(adc);
+    free(g.amostras);
+    if (!sintetica) return 0;
+
+    // Só a sirene sustentada dispara, um bloco de folga em torno do tempo de sustentação
+    double esperado = SIRENE_INICIO_S + sustentado_ms / 1000.0;
+    double bloco_s = (double)SOM_BLOCO / SOM_TAXA_HZ;
+    bool ok = disparos == 1 && fora_da_sirene == 0 && fabs(primeiro_disparo - esperado) <= 2 * bloco_s &&
+              erro_rms < 1 + 1.0 / SOM_BLOCO; // a raiz e a divisão truncam
+    if (!ok) fprintf(stderr, "som_gravacao: esperado um disparo em %.2f s só na sirene\n", esperado);
+    return ok ? 0 : 1;
+}
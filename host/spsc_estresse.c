@@ -0,0 +1,125 @@
+// Estresse da fila core0 -> core1 (spsc_ring.h): uma thread produtora e uma consumidora
+// empurrando e tirando elementos do tamanho de core1_cmd_t o mais rápido possível. Cada
+// elemento leva um contador e um verificador em todos os bytes; qualquer elemento rasgado,
+// repetido, perdido ou fora de ordem derruba o teste. Roda com uma fila mínima (disputa em
+// todo slot) e com a do core1, e com os índices perto de 2^32 para cobrir a volta.
+//
+//   ./spsc_estresse [segundos]
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "spsc_ring.h"
+
+#define ELEMENTO_TAM 12 // sizeof(core1_cmd_t)
+#define CAPACIDADE_MAX 32 // CORE1_FILA_TAM
+
+typedef struct {
+    uint32_t contador;
+    uint8_t verificacao[ELEMENTO_TAM - 4];
+} elemento_t;
+
+typedef struct {
+    spsc_ring_t fila;
+    elemento_t dados[CAPACIDADE_MAX];
+    atomic_bool parar;
+    atomic_bool produtor_terminou;
+    uint32_t empurrados;
+    uint32_t cheia;   // push recusado com a fila cheia
+    uint32_t tirados;
+    uint32_t vazia;   // pop sem nada
+    uint32_t erros;
+} estresse_t;
+
+static void preencher(elemento_t *e, uint32_t contador) {
+    e->contador = contador;
+    for (size_t i = 0; i < sizeof(e->verificacao); i++) e->verificacao[i] = (uint8_t)(contador * 2654435761u >> (i * 3));
+}
+
+static bool integro(const elemento_t *e) {
+    elemento_t esperado;
+    preencher(&esperado, e->contador);
+    return memcmp(e, &esperado, sizeof(esperado)) == 0;
+}
+
+static void *produzir(void *arg) {
+    estresse_t *t = arg;
+    uint32_t contador = 0;
+    while (!atomic_load_explicit(&t->parar, memory_order_relaxed)) {
+        elemento_t e;
+        preencher(&e, contador + 1);
+        if (spsc_ring_push(&t->fila, &e)) {
+            contador++;
+        } else {
+            // O core0 descarta e segue; aqui, com um só processador, girar gastaria a fatia inteira
+            t->cheia++;
+            sched_yield();
+        }
+    }
+    t->empurrados = contador;
+    atomic_store_explicit(&t->produtor_terminou, true, memory_order_release);
+    return NULL;
+}
+
+static void *consumir(void *arg) {
+    estresse_t *t = arg;
+    uint32_t esperado = 1;
+    // Depois que o produtor termina, esvazia o que ele deixou
+    for (;;) {
+        bool parado = atomic_load_explicit(&t->produtor_terminou, memory_order_acquire);
+        elemento_t e;
+        if (!spsc_ring_pop(&t->fila, &e)) {
+            if (parado) break;
+            t->vazia++;
+            sched_yield(); // o core1 dorme no FIFO até a próxima campainha
+            continue;
+        }
+        if (!integro(&e) || e.contador != esperado) {
+            if (t->erros++ < 5) {
+                fprintf(stderr, "elemento %lu rasgado ou fora de ordem (esperado %lu)\n",
+                    (unsigned long)e.contador, (unsigned long)esperado);
+            }
+            esperado = e.contador;
+        }
+        esperado++;
+        t->tirados++;
+    }
+    return NULL;
+}
+
+static bool rodar(uint32_t capacidade, uint32_t indice_inicial, double segundos) {
+    static estresse_t t;
+    memset(&t, 0, sizeof(t));
+    spsc_ring_init(&t.fila, t.dados, capacidade, sizeof(elemento_t));
+    atomic_store(&t.fila.cabeca, indice_inicial);
+    atomic_store(&t.fila.cauda, indice_inicial);
+
+    pthread_t produtor, consumidor;
+    pthread_create(&consumidor, NULL, consumir, &t);
+    pthread_create(&produtor, NULL, produzir, &t);
+    struct timespec espera = {.tv_sec = (time_t)segundos, .tv_nsec = (long)((segundos - (time_t)segundos) * 1e9)};
+    nanosleep(&espera, NULL);
+    atomic_store(&t.parar, true);
+    pthread_join(produtor, NULL);
+    pthread_join(consumidor, NULL);
+
+    bool ok = t.erros == 0 && t.tirados == t.empurrados && spsc_ring_ocupacao(&t.fila) == 0;
+    printf("capacidade %2lu, indice inicial %08lx: %lu elementos (%.1f M/s), fila cheia %lu, vazia %lu, erros %lu%s\n",
+        (unsigned long)capacidade, (unsigned long)indice_inicial, (unsigned long)t.tirados, t.tirados / segundos / 1e6,
+        (unsigned long)t.cheia, (unsigned long)t.vazia, (unsigned long)t.erros,
+        t.tirados == t.empurrados ? "" : " (perdidos)");
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    double segundos = (argc > 1 ? atof(argv[1]) : 2) / 4;
+    bool ok = rodar(2, 0, segundos);
+    ok &= rodar(2, UINT32_MAX - 1000, segundos);
+    ok &= rodar(CAPACIDADE_MAX, 0, segundos);
+    ok &= rodar(CAPACIDADE_MAX, UINT32_MAX - 1000, segundos);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,79 @@
+// Filtro e limiar de temperatura contra um perfil sintético: o mesmo temperatura_filtro.c do
+// firmware recebendo blocos de SOM_BLOCO leituras de 12 bits com ruído, como o ADC entrega.
+//
+//   ./temperatura_sim [limiar °C] [ruído em contagens]
+//
+// O perfil sobe de 25 °C a 80 °C em 60 s, fica 20 s e desce a 50 °C; uma linha por segundo.
+// Sai com erro se o alarme disparar com a temperatura real longe do limiar, disparar mais de
+// uma vez na única subida, ou não rearmar perto de limiar - histerese.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "microfone.h"
+#include "temperatura_filtro.h"
+
+#define BLOCOS_POR_S (SOM_TAXA_HZ / SOM_BLOCO)
+#define PERFIL_MAX_C 80
+#define PERFIL_FINAL_C 50
+#define TOLERANCIA_C 2.0 // atraso da média (~1 s a ~0,9 °C/s na subida) mais o ruído
+
+static double perfil_c(double t) {
+    if (t < 60) return 25 + (PERFIL_MAX_C - 25) * t / 60;
+    if (t < 80) return PERFIL_MAX_C;
+    if (t < 120) return PERFIL_MAX_C - (PERFIL_MAX_C - PERFIL_FINAL_C) * (t - 80) / 40;
+    return PERFIL_FINAL_C;
+}
+
+// Inverso da fórmula do datasheet, em contagens do ADC
+static double contagens(double c) {
+    return (0.706 - (c - 27) * 0.001721) / 3.3 * 4096;
+}
+
+static double ruido(double sigma) {
+    double u = (rand() + 1.0) / (RAND_MAX + 2.0), v = (rand() + 1.0) / (RAND_MAX + 2.0);
+    return sigma * sqrt(-2 * log(u)) * cos(2 * M_PI * v);
+}
+
+int main(int argc, char **argv) {
+    int32_t limiar_mc = argc > 1 ? atoi(argv[1]) * 1000 : TEMP_LIMIAR_MC;
+    double sigma = argc > 2 ? atof(argv[2]) : 4;
+    temperatura_filtro_t f;
+    temperatura_filtro_init(&f, limiar_mc, TEMP_HISTERESE_MC);
+
+    double limiar_c = limiar_mc / 1000.0, rearme_c = (limiar_mc - TEMP_HISTERESE_MC) / 1000.0;
+    int total = 140 * BLOCOS_POR_S;
+    bool acima = false;
+    int falhas = 0;
+    for (int b = 0; b < total; b++) {
+        double t = (double)b / BLOCOS_POR_S;
+        uint32_t soma = 0;
+        for (int i = 0; i < SOM_BLOCO; i++) {
+            long v = lround(contagens(perfil_c(t)) + ruido(sigma));
+            soma += v < 0 ? 0 : v > 4095 ? 4095 : v;
+        }
+        int32_t mc = temperatura_mc_de_contagens(soma, SOM_BLOCO);
+        if (temperatura_filtro_atualizar(&f, mc)) {
+            printf("%6.2f s  DISPARO: media %.2f C, real %.2f C\n", t, f.mc / 1000.0, perfil_c(t));
+            if (fabs(perfil_c(t) - limiar_c) > TOLERANCIA_C) falhas++;
+        }
+        if (acima && !f.acima) {
+            printf("%6.2f s  rearmado: media %.2f C, real %.2f C\n", t, f.mc / 1000.0, perfil_c(t));
+            if (fabs(perfil_c(t) - rearme_c) > TOLERANCIA_C) falhas++;
+        }
+        acima = f.acima;
+        if (b % BLOCOS_POR_S == 0) {
+            printf("%6.2f s  real %6.2f  bloco %7.3f  media %7.3f C\n", t, perfil_c(t), mc / 1000.0, f.mc / 1000.0);
+        }
+    }
+    printf("limiar %.1f C, histerese %.1f C, %lu disparos, min %.2f C, max %.2f C\n", limiar_mc / 1000.0,
+        f.histerese_mc / 1000.0, (unsigned long)f.disparos, f.min_mc / 1000.0, f.max_mc / 1000.0);
+
+    // O perfil cruza o limiar no máximo uma vez para cima e uma para baixo
+    bool deve_disparar = PERFIL_MAX_C >= limiar_c + TOLERANCIA_C;
+    bool deve_rearmar = PERFIL_FINAL_C <= rearme_c - TOLERANCIA_C;
+    if (f.disparos > 1 || (deve_disparar && f.disparos == 0)) falhas++;
+    if (f.disparos && deve_rearmar && f.acima) falhas++;
+    if (falhas) fprintf(stderr, "temperatura_sim: %d falhas (tolerancia %.1f C)\n", falhas, TOLERANCIA_C);
+    return falhas ? 1 : 0;
+}
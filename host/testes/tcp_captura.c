@@ -0,0 +1,294 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lwip/init.h"
+#include "lwip/memp.h"
+#include "lwip/pbuf.h"
+#include "tcp_captura.h"
+
+#define CAPTURA_MAX_CONEXOES 32
+#define CAPTURA_MAX_SEGMENTOS 64
+#define CAPTURA_SEGS_POR_ESCRITA ((TCP_SND_BUF + TCP_MSS - 1) / TCP_MSS)
+
+// Uma chamada a tcp_write ainda não confirmada, com o que o lwIP alocaria para ela: um
+// segmento do pool por MSS e, por segmento, a cópia no heap ou um cabeçalho no heap mais
+// uma referência do pool de pbufs
+typedef struct {
+    u16_t len;
+    u16_t pbufs; // contam em snd_queuelen
+    struct pbuf *p;
+    void *segs[CAPTURA_SEGS_POR_ESCRITA];
+    int num_segs;
+} escrita_t;
+
+typedef struct {
+    captura_t c;
+    escrita_t escritas[CAPTURA_MAX_SEGMENTOS]; // em ordem
+    int seg_inicio, seg_n;
+    u16_t fila_pbufs;
+    u16_t sobra; // espaço livre no último pbuf copiado ainda não enviado (TCP_OVERSIZE)
+} conexao_t;
+
+static conexao_t *conexoes[CAPTURA_MAX_CONEXOES];
+
+static void escrita_liberar(escrita_t *e) {
+    if (e->p) pbuf_free(e->p);
+    for (int i = 0; i < e->num_segs; i++) memp_free(MEMP_TCP_SEG, e->segs[i]);
+    e->p = NULL;
+    e->num_segs = 0;
+}
+
+// Como o tcp_abort do lwIP: tudo o que estava na fila de envio é devolvido
+static void fila_liberar(conexao_t *k) {
+    for (; k->seg_n; k->seg_n--) {
+        escrita_liberar(&k->escritas[k->seg_inicio]);
+        k->seg_inicio = (k->seg_inicio + 1) % CAPTURA_MAX_SEGMENTOS;
+    }
+    k->fila_pbufs = 0;
+    k->sobra = 0;
+    k->c.pcb->snd_queuelen = 0;
+}
+
+void captura_liberar(captura_t *c) {
+    for (int i = 0; i < CAPTURA_MAX_CONEXOES; i++) {
+        if (!conexoes[i] || &conexoes[i]->c != c) continue;
+        fila_liberar(conexoes[i]);
+        free(conexoes[i]->c.pcb);
+        free(conexoes[i]);
+        conexoes[i] = NULL;
+    }
+}
+
+void captura_iniciar(void) {
+    for (int i = 0; i < CAPTURA_MAX_CONEXOES; i++) {
+        if (conexoes[i]) captura_liberar(&conexoes[i]->c);
+    }
+    lwip_init();
+}
+
+static conexao_t *conexao_de(struct tcp_pcb *pcb) {
+    for (int i = 0; i < CAPTURA_MAX_CONEXOES; i++) {
+        if (conexoes[i] && conexoes[i]->c.pcb == pcb) return conexoes[i];
+    }
+    return NULL;
+}
+
+captura_t *captura_de(struct tcp_pcb *pcb) {
+    conexao_t *k = conexao_de(pcb);
+    return k ? &k->c : NULL;
+}
+
+// O pcb não sai do pool do lwIP: fechar e abortar aqui não o devolvem, e um teste
+// com dezenas de conexões esgotaria MEMP_NUM_TCP_PCB
+captura_t *captura_nova(uint8_t ip_final) {
+    for (int i = 0; i < CAPTURA_MAX_CONEXOES; i++) {
+        if (conexoes[i]) continue;
+        conexao_t *k = calloc(1, sizeof(conexao_t));
+        struct tcp_pcb *pcb = calloc(1, sizeof(struct tcp_pcb));
+        pcb->snd_buf = TCP_SND_BUF;
+        pcb->remote_port = 40000 + i;
+        IP4_ADDR(ip_2_ip4(&pcb->remote_ip), 192, 168, 4, ip_final);
+        k->c.pcb = pcb;
+        conexoes[i] = k;
+        return &k->c;
+    }
+    return NULL;
+}
+
+captura_t *captura_aceitar(captura_accept_fn accept, void *arg, uint8_t ip_final, err_t *ret) {
+    captura_t *c = captura_nova(ip_final);
+    err_t err = accept(arg, c->pcb, ERR_OK);
+    if (ret) *ret = err;
+    return c;
+}
+
+err_t captura_entregar(captura_t *c, const void *dados, u16_t len) {
+    struct pbuf *p = pbuf_alloc(PBUF_RAW, len, PBUF_RAM);
+    pbuf_take(p, dados, len);
+    if (!c->recv) {
+        // tcp_recv_null do lwIP
+        c->recebidos += len;
+        pbuf_free(p);
+        return ERR_OK;
+    }
+    return c->recv(c->arg, c->pcb, p, ERR_OK);
+}
+
+err_t captura_fin(captura_t *c) {
+    if (!c->recv) return ERR_OK;
+    return c->recv(c->arg, c->pcb, NULL, ERR_OK);
+}
+
+err_t captura_confirmar(captura_t *c, u16_t len) {
+    conexao_t *k = (conexao_t*)c;
+    if (len > c->pendente) len = c->pendente;
+    c->pendente -= len;
+    c->pcb->snd_buf += len;
+    for (u16_t resta = len; resta && k->seg_n;) {
+        escrita_t *e = &k->escritas[k->seg_inicio];
+        u16_t n = e->len < resta ? e->len : resta;
+        e->len -= n;
+        resta -= n;
+        if (e->len == 0) {
+            k->fila_pbufs -= e->pbufs;
+            escrita_liberar(e);
+            k->seg_inicio = (k->seg_inicio + 1) % CAPTURA_MAX_SEGMENTOS;
+            k->seg_n--;
+        }
+    }
+    c->pcb->snd_queuelen = k->fila_pbufs;
+    if (!c->sent || c->fechado || c->abortado) return ERR_OK;
+    return c->sent(c->arg, c->pcb, len);
+}
+
+err_t captura_poll(captura_t *c) {
+    if (!c->poll) return ERR_OK;
+    return c->poll(c->arg, c->pcb);
+}
+
+bool captura_contem(const captura_t *c, const char *texto) {
+    size_t n = strlen(texto);
+    uint32_t guardado = c->len < CAPTURA_MAX_SAIDA ? c->len : CAPTURA_MAX_SAIDA;
+    for (uint32_t i = 0; i + n <= guardado; i++) {
+        if (memcmp(c->saida + i, texto, n) == 0) return true;
+    }
+    return false;
+}
+
+void captura_limpar(captura_t *c) {
+    c->len = 0;
+}
+
+// Funções do lwIP substituídas pelo linker; pcbs desconhecidos (o de escuta) são ignorados
+
+void __wrap_tcp_arg(struct tcp_pcb *pcb, void *arg) {
+    captura_t *c = captura_de(pcb);
+    if (c) c->arg = arg;
+}
+
+void __wrap_tcp_recv(struct tcp_pcb *pcb, tcp_recv_fn recv) {
+    captura_t *c = captura_de(pcb);
+    if (c) c->recv = recv;
+}
+
+void __wrap_tcp_sent(struct tcp_pcb *pcb, tcp_sent_fn sent) {
+    captura_t *c = captura_de(pcb);
+    if (c) c->sent = sent;
+}
+
+void __wrap_tcp_poll(struct tcp_pcb *pcb, tcp_poll_fn poll, u8_t intervalo) {
+    captura_t *c = captura_de(pcb);
+    if (c) c->poll = poll;
+}
+
+void __wrap_tcp_err(struct tcp_pcb *pcb, tcp_err_fn err) {
+    captura_t *c = captura_de(pcb);
+    if (c) c->err = err;
+}
+
+// Segmentos de até TCP_MSS como no tcp_write do lwIP: com cópia, um pbuf no heap por segmento
+// (do tamanho do MSS quando vem mais depois, e a sobra recebe as próximas cópias até o
+// tcp_output); sem cópia, um cabeçalho no heap e uma referência do pool. A fila conta pbufs.
+static err_t escrita_alocar(conexao_t *k, escrita_t *e, const void *dados, u16_t len, u8_t flags) {
+    bool copia = flags & TCP_WRITE_FLAG_COPY;
+    u16_t resta = len;
+    if (copia) {
+        u16_t n = resta < k->sobra ? resta : k->sobra;
+        resta -= n;
+        k->sobra -= n;
+    } else {
+        k->sobra = 0;
+    }
+    e->pbufs = (resta + TCP_MSS - 1) / TCP_MSS * (copia ? 1 : 2);
+    if (k->fila_pbufs + e->pbufs > TCP_SND_QUEUELEN) return ERR_MEM;
+    for (u16_t feito = 0; feito < resta;) {
+        u16_t seglen = resta - feito < TCP_MSS ? resta - feito : TCP_MSS;
+        struct pbuf *p;
+        if (copia) {
+            u16_t alocar = (flags & TCP_WRITE_FLAG_MORE) && seglen < TCP_MSS ? TCP_MSS : seglen;
+            p = pbuf_alloc(PBUF_TRANSPORT, alocar, PBUF_RAM);
+            if (p) k->sobra = alocar - seglen;
+        } else {
+            p = pbuf_alloc(PBUF_TRANSPORT, 0, PBUF_RAM);
+            struct pbuf *ref = p ? pbuf_alloc(PBUF_RAW, seglen, PBUF_ROM) : NULL;
+            if (ref) {
+                ref->payload = (void*)((uintptr_t)dados + len - resta + feito);
+                pbuf_cat(p, ref);
+            } else if (p) {
+                pbuf_free(p);
+                p = NULL;
+            }
+        }
+        void *seg = p ? memp_malloc(MEMP_TCP_SEG) : NULL;
+        if (!seg) {
+            if (p) pbuf_free(p);
+            escrita_liberar(e);
+            k->sobra = 0;
+            k->c.sem_memoria++;
+            return ERR_MEM;
+        }
+        if (e->p) pbuf_cat(e->p, p);
+        else e->p = p;
+        e->segs[e->num_segs++] = seg;
+        feito += seglen;
+    }
+    return ERR_OK;
+}
+
+err_t __wrap_tcp_write(struct tcp_pcb *pcb, const void *dados, u16_t len, u8_t flags) {
+    conexao_t *k = conexao_de(pcb);
+    if (!k) return ERR_CONN;
+    captura_t *c = &k->c;
+    if (c->fin_enviado || c->abortado) return ERR_CONN;
+    if (len > pcb->snd_buf || k->seg_n >= CAPTURA_MAX_SEGMENTOS) return ERR_MEM;
+    escrita_t *e = &k->escritas[(k->seg_inicio + k->seg_n) % CAPTURA_MAX_SEGMENTOS];
+    *e = (escrita_t){.len = len};
+    err_t err = escrita_alocar(k, e, dados, len, flags);
+    if (err != ERR_OK) return err;
+    for (u16_t i = 0; i < len && c->len + i < CAPTURA_MAX_SAIDA; i++) {
+        c->saida[c->len + i] = ((const uint8_t*)dados)[i];
+    }
+    c->len += len;
+    c->pendente += len;
+    c->escritas++;
+    pcb->snd_buf -= len;
+    k->seg_n++;
+    k->fila_pbufs += e->pbufs;
+    pcb->snd_queuelen = k->fila_pbufs;
+    return ERR_OK;
+}
+
+// Tudo vai para o ar: o último segmento deixa de aceitar cópias
+err_t __wrap_tcp_output(struct tcp_pcb *pcb) {
+    conexao_t *k = conexao_de(pcb);
+    if (!k) return ERR_OK;
+    k->c.saidas++;
+    k->sobra = 0;
+    return ERR_OK;
+}
+
+void __wrap_tcp_recved(struct tcp_pcb *pcb, u16_t len) {
+    captura_t *c = captura_de(pcb);
+    if (c) c->recebidos += len;
+}
+
+err_t __wrap_tcp_shutdown(struct tcp_pcb *pcb, int shut_rx, int shut_tx) {
+    captura_t *c = captura_de(pcb);
+    if (!c) return ERR_CONN;
+    if (shut_tx) c->fin_enviado = true;
+    if (shut_rx && shut_tx) c->fechado = true;
+    return ERR_OK;
+}
+
+err_t __wrap_tcp_close(struct tcp_pcb *pcb) {
+    captura_t *c = captura_de(pcb);
+    if (c) c->fechado = c->fin_enviado = true;
+    return ERR_OK;
+}
+
+void __wrap_tcp_abort(struct tcp_pcb *pcb) {
+    conexao_t *k = conexao_de(pcb);
+    if (!k) return;
+    k->c.abortado = true;
+    fila_liberar(k);
+}
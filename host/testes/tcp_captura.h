@@ -0,0 +1,62 @@
+#ifndef TCP_CAPTURA_H
+#define TCP_CAPTURA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lwip/tcp.h"
+
+// Conexões TCP de mentira para testar os callbacks do servidor sem rede: o teste é ligado
+// com -Wl,--wrap para as funções de tcp_* abaixo, e cada pcb guarda o que o firmware
+// escreveu, os callbacks que registrou e se fechou ou abortou. A janela de envio segue
+// TCP_SND_BUF e TCP_SND_QUEUELEN como no lwIP e só é liberada por captura_confirmar; cada
+// tcp_write ocupa o heap e os pools do lwIP como ocuparia na placa até ser confirmado.
+
+#ifndef CAPTURA_MAX_SAIDA
+#define CAPTURA_MAX_SAIDA (80 * 1024) // bytes guardados por conexão; o excedente só é contado
+#endif
+
+typedef struct {
+    struct tcp_pcb *pcb;
+    void *arg;
+    tcp_recv_fn recv;
+    tcp_sent_fn sent;
+    tcp_poll_fn poll;
+    tcp_err_fn err;
+    uint8_t saida[CAPTURA_MAX_SAIDA];
+    uint32_t len;       // bytes escritos desde a abertura (ou desde captura_limpar)
+    uint32_t pendente;  // escritos e ainda não confirmados
+    uint32_t recebidos; // liberados pelo firmware com tcp_recved
+    uint32_t escritas;
+    uint32_t saidas;    // chamadas a tcp_output
+    uint32_t sem_memoria; // tcp_write recusado por falta de heap ou de pool
+    bool fin_enviado;   // tcp_shutdown do lado de envio ou tcp_close
+    bool fechado;
+    bool abortado;
+} captura_t;
+
+typedef err_t (*captura_accept_fn)(void *arg, struct tcp_pcb *pcb, err_t err);
+
+// lwip_init (pbufs) e nenhuma conexão aberta
+void captura_iniciar(void);
+
+// Conexão nova de 192.168.4.<ip_final> entregue ao callback de accept
+captura_t *captura_aceitar(captura_accept_fn accept, void *arg, uint8_t ip_final, err_t *ret);
+
+// pcb avulso, para quem chama os módulos sem passar pelo accept
+captura_t *captura_nova(uint8_t ip_final);
+captura_t *captura_de(struct tcp_pcb *pcb);
+// Devolve a vaga e o que ainda estava na fila de envio
+void captura_liberar(captura_t *c);
+
+// Segmento do cliente ou FIN (dados NULL) entregues ao callback de recv
+err_t captura_entregar(captura_t *c, const void *dados, u16_t len);
+err_t captura_fin(captura_t *c);
+
+// ACK do cliente: devolve len bytes à janela e chama o tcp_sent
+err_t captura_confirmar(captura_t *c, u16_t len);
+err_t captura_poll(captura_t *c);
+
+bool captura_contem(const captura_t *c, const char *texto);
+void captura_limpar(captura_t *c);
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef TESTE_H
+#define TESTE_H
+
+#include <stdio.h>
+
+// Testes do host: cada CONFERIR que falha é impresso com arquivo e linha e
+// teste_fim() devolve o código de saída que o ctest espera
+
+static int teste_falhas;
+
+#define CONFERIR(cond) do { \
+    if (!(cond)) { \
+        teste_falhas++; \
+        fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond); \
+    } \
+} while (0)
+
+static inline int teste_fim(const char *nome) {
+    if (teste_falhas) fprintf(stderr, "%s: %d falhas\n", nome, teste_falhas);
+    else printf("%s: ok\n", nome);
+    return teste_falhas ? 1 : 0;
+}
+
+#endif
@@ -0,0 +1,92 @@
+// Controle de admissão do listener: 503 para quem passa da taxa por IP, sem RST quando a
+// requisição chega depois da resposta, e RST imediato quando as vagas acabam.
+
+#define main firmware_main
+#include "picow_access_point.c"
+#undef main
+
+#include "teste.h"
+#include "tcp_captura.h"
+
+static const char REQUISICAO[] = "GET /bitdoglabtest HTTP/1.1\r\nHost: 192.168.4.1\r\n\r\n";
+
+static TCP_SERVER_T servidor;
+
+static captura_t *aceitar(uint8_t ip_final, err_t *ret) {
+    return captura_aceitar(tcp_server_accept, &servidor, ip_final, ret);
+}
+
+// Esgota a janela de um IP com conexões que abrem e fecham sem pedir nada
+static void esgotar_taxa(uint8_t ip_final) {
+    for (int i = 0; i < HTTP_TAXA_MAX_REQ; i++) {
+        err_t ret;
+        captura_t *c = aceitar(ip_final, &ret);
+        CONFERIR(ret == ERR_OK && c->recv == tcp_server_recv);
+        captura_fin(c);
+    }
+}
+
+static void testar_503_sem_rst(void) {
+    esgotar_taxa(20);
+    uint32_t antes = servidor.rejeitadas_taxa;
+
+    err_t ret;
+    captura_t *c = aceitar(20, &ret);
+    CONFERIR(ret == ERR_OK);
+    CONFERIR(servidor.rejeitadas_taxa == antes + 1);
+    CONFERIR(captura_contem(c, "HTTP/1.1 503 Service Unavailable"));
+    CONFERIR(servidor.conexoes_ativas == 0);
+    // FIN enviado, recepção aberta: a requisição que chega depois é consumida, não resetada
+    CONFERIR(c->fin_enviado && !c->fechado && !c->abortado);
+    CONFERIR(captura_entregar(c, REQUISICAO, sizeof(REQUISICAO) - 1) == ERR_OK);
+    CONFERIR(c->recebidos == sizeof(REQUISICAO) - 1);
+    CONFERIR(!c->abortado);
+    CONFERIR(captura_fin(c) == ERR_OK);
+    CONFERIR(c->fechado && !c->abortado);
+
+    // Outro IP segue atendido normalmente
+    c = aceitar(21, &ret);
+    CONFERIR(ret == ERR_OK && c->recv == tcp_server_recv && c->len == 0);
+    captura_fin(c);
+}
+
+// Quem recebe o 503 e nunca fecha a sua metade é abortado no primeiro poll
+static void testar_503_ocioso(void) {
+    err_t ret;
+    captura_t *c = aceitar(20, &ret);
+    CONFERIR(captura_contem(c, "503"));
+    CONFERIR(captura_poll(c) == ERR_ABRT);
+    CONFERIR(c->abortado);
+}
+
+static void testar_limite_conexoes(void) {
+    captura_t *abertas[HTTP_MAX_CONEXOES];
+    err_t ret;
+    for (int i = 0; i < HTTP_MAX_CONEXOES; i++) {
+        abertas[i] = aceitar(30 + i, &ret);
+        CONFERIR(ret == ERR_OK && !abertas[i]->abortado);
+    }
+    CONFERIR(servidor.conexoes_ativas == HTTP_MAX_CONEXOES);
+
+    uint32_t antes = servidor.rejeitadas_conexao;
+    captura_t *excedente = aceitar(40, &ret);
+    CONFERIR(ret == ERR_ABRT && excedente->abortado && excedente->len == 0);
+    CONFERIR(servidor.rejeitadas_conexao == antes + 1);
+
+    // Uma vaga devolvida volta a ser oferecida
+    captura_fin(abertas[0]);
+    captura_t *c = aceitar(41, &ret);
+    CONFERIR(ret == ERR_OK && !c->abortado);
+    captura_fin(c);
+    for (int i = 1; i < HTTP_MAX_CONEXOES; i++) captura_fin(abertas[i]);
+    CONFERIR(servidor.conexoes_ativas == 0);
+}
+
+int main(void) {
+    captura_iniciar();
+    IP4_ADDR(&servidor.gw, 192, 168, 4, 1);
+    testar_503_sem_rst();
+    testar_503_ocioso();
+    testar_limite_conexoes();
+    return teste_fim("teste_admissao");
+}
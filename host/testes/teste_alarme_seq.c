@@ -0,0 +1,102 @@
+// Sequenciador dos padrões do alarme (alarme_seq.c) sem SDK: ritmo do SOS em Morse, volta ao
+// início de cada ciclo, períodos sem deriva acumulada, unidade fora da faixa e nomes.
+
+#include <string.h>
+#include "alarme_seq.h"
+#include "teste.h"
+
+// Percorre um ciclo e escreve os pulsos acesos como '.' (1 unidade) e '-' (3 unidades)
+static void morse(alarme_padrao_t padrao, uint16_t unidade_ms, char *out, size_t max) {
+    alarme_sequenciador_t s;
+    alarme_sequenciador_init(&s, padrao, unidade_ms);
+    size_t n = 0;
+    do {
+        bool ligado;
+        uint32_t ms = alarme_sequenciador_avancar(&s, &ligado);
+        if (ligado && n + 1 < max) out[n++] = ms == unidade_ms ? '.' : ms == 3u * unidade_ms ? '-' : '?';
+    } while (s.indice != 0);
+    out[n] = '\0';
+}
+
+static void testar_sos(void) {
+    char texto[16];
+    morse(ALARME_SOS, ALARME_UNIDADE_SOS_MS, texto, sizeof(texto));
+    CONFERIR(strcmp(texto, "...---...") == 0);
+    // 15 unidades acesas, 6 intervalos de 1 dentro das letras, 2 de 3 entre letras e 7 no fim
+    CONFERIR(alarme_unidades_ciclo(ALARME_SOS) == 15 + 6 + 2 * 3 + 7);
+    morse(ALARME_SOS, 40, texto, sizeof(texto));
+    CONFERIR(strcmp(texto, "...---...") == 0);
+}
+
+// Soma das durações de N ciclos é exatamente N períodos, e cada ciclo começa aceso
+static void testar_periodo(alarme_padrao_t padrao, uint16_t unidade_ms) {
+    alarme_sequenciador_t s;
+    alarme_sequenciador_init(&s, padrao, unidade_ms);
+    uint64_t total = 0;
+    uint32_t transicoes = 0;
+    bool anterior = false;
+    for (int ciclo = 0; ciclo < 100; ciclo++) {
+        bool ligado;
+        total += alarme_sequenciador_avancar(&s, &ligado);
+        CONFERIR(ligado);
+        while (s.indice != 0) {
+            anterior = ligado;
+            total += alarme_sequenciador_avancar(&s, &ligado);
+            transicoes += ligado != anterior;
+            CONFERIR(ligado != anterior); // passos vizinhos sempre alternam
+        }
+    }
+    CONFERIR(total == 100ull * alarme_unidades_ciclo(padrao) * unidade_ms);
+    CONFERIR(transicoes > 0);
+}
+
+static void testar_sirene_pulso(void) {
+    alarme_sequenciador_t s;
+    bool ligado;
+    alarme_sequenciador_init(&s, ALARME_SIRENE, ALARME_UNIDADE_SIRENE_MS);
+    CONFERIR(alarme_sequenciador_avancar(&s, &ligado) == 500 && ligado);
+    CONFERIR(alarme_sequenciador_avancar(&s, &ligado) == 500 && !ligado);
+    CONFERIR(alarme_sequenciador_avancar(&s, &ligado) == 500 && ligado);
+
+    alarme_sequenciador_init(&s, ALARME_PULSO, ALARME_UNIDADE_PULSO_MS);
+    CONFERIR(alarme_sequenciador_avancar(&s, &ligado) == 200 && ligado);
+    CONFERIR(alarme_sequenciador_avancar(&s, &ligado) == 800 && !ligado);
+}
+
+static void testar_unidade(void) {
+    CONFERIR(alarme_unidade_valida(ALARME_SIRENE, 0) == ALARME_UNIDADE_SIRENE_MS);
+    CONFERIR(alarme_unidade_valida(ALARME_PULSO, 0) == ALARME_UNIDADE_PULSO_MS);
+    CONFERIR(alarme_unidade_valida(ALARME_SOS, 0) == ALARME_UNIDADE_SOS_MS);
+    CONFERIR(alarme_unidade_valida(ALARME_SOS, 1) == ALARME_UNIDADE_MIN_MS);
+    CONFERIR(alarme_unidade_valida(ALARME_SOS, ALARME_UNIDADE_MIN_MS) == ALARME_UNIDADE_MIN_MS);
+    CONFERIR(alarme_unidade_valida(ALARME_SOS, ALARME_UNIDADE_MAX_MS + 1) == ALARME_UNIDADE_MAX_MS);
+    CONFERIR(alarme_unidade_valida(ALARME_SOS, 65535) == ALARME_UNIDADE_MAX_MS);
+    // O maior ciclo com a maior unidade ainda cabe no retorno de 32 bits de cada passo
+    CONFERIR(alarme_unidades_ciclo(ALARME_SOS) * 65535ull < UINT32_MAX);
+}
+
+static void testar_nomes(void) {
+    for (int i = 0; i < NUM_PADROES_ALARME; i++) {
+        const char *nome = alarme_nome_padrao(i);
+        CONFERIR(alarme_padrao_por_nome(nome, strlen(nome)) == (alarme_padrao_t)i);
+    }
+    CONFERIR(alarme_padrao_por_nome("sos", 3) == ALARME_SOS);
+    CONFERIR(alarme_padrao_por_nome("sosx", 3) == ALARME_SOS); // o nome vem de uma query sem '\0'
+    CONFERIR(alarme_padrao_por_nome("so", 2) == NUM_PADROES_ALARME);
+    CONFERIR(alarme_padrao_por_nome("SOS", 3) == NUM_PADROES_ALARME);
+    CONFERIR(alarme_padrao_por_nome("", 0) == NUM_PADROES_ALARME);
+    CONFERIR(strcmp(alarme_nome_padrao(NUM_PADROES_ALARME), "") == 0);
+}
+
+int main(void) {
+    testar_sos();
+    testar_sirene_pulso();
+    for (int i = 0; i < NUM_PADROES_ALARME; i++) {
+        testar_periodo(i, alarme_unidade_valida(i, 0));
+        testar_periodo(i, ALARME_UNIDADE_MIN_MS);
+        testar_periodo(i, ALARME_UNIDADE_MAX_MS);
+    }
+    testar_unidade();
+    testar_nomes();
+    return teste_fim("teste_alarme_seq");
+}
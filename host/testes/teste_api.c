@@ -0,0 +1,151 @@
+// POST /api/commands com o corpo em segmentos posteriores aos cabeçalhos: a conexão guarda
+// a requisição até chegarem os Content-Length bytes, e só então responde (uma vez só no
+// histograma). Limites: Content-Length grande demais e corpo que nunca chega. A amostragem
+// do rastro conta requisições, não segmentos.
+
+#define main firmware_main
+#include "picow_access_point.c"
+#undef main
+
+#include "teste.h"
+#include "tcp_captura.h"
+
+static const char CABECALHOS[] =
+    "POST /api/commands HTTP/1.1\r\nHost: 192.168.4.1\r\nContent-Type: application/json\r\nContent-Length: 20\r\n\r\n";
+static const char CORPO[] = "{\"red\":1,\"buzzer\":0}";
+
+static TCP_SERVER_T servidor;
+static uint8_t proximo_ip = 10;
+
+static captura_t *conectar(void) {
+    err_t ret;
+    captura_t *c = captura_aceitar(tcp_server_accept, &servidor, proximo_ip++, &ret);
+    CONFERIR(ret == ERR_OK);
+    return c;
+}
+
+static void entregar(captura_t *c, const char *texto) {
+    captura_entregar(c, texto, strlen(texto));
+}
+
+static uint32_t respostas_commands(void) {
+    uint32_t n, max_us;
+    metricas_hist_resumo(MH_HTTP_API_COMMANDS, &n, &max_us);
+    return n;
+}
+
+static void conferir_200(captura_t *c, const char *estado) {
+    CONFERIR(captura_contem(c, "HTTP/1.1 200 OK"));
+    CONFERIR(captura_contem(c, estado));
+    CONFERIR(c->fechado && !c->abortado);
+}
+
+static void testar_um_segmento(void) {
+    captura_t *c = conectar();
+    char requisicao[sizeof(CABECALHOS) + sizeof(CORPO)];
+    snprintf(requisicao, sizeof(requisicao), "%s%s", CABECALHOS, CORPO);
+    entregar(c, requisicao);
+    conferir_200(c, "\"red\":1");
+}
+
+static void testar_corpo_depois(void) {
+    uint32_t antes = respostas_commands();
+    captura_t *c = conectar();
+    entregar(c, CABECALHOS);
+    CONFERIR(c->len == 0 && !c->fechado);
+    CONFERIR(c->recebidos == sizeof(CABECALHOS) - 1); // a janela não fica presa
+    CONFERIR(respostas_commands() == antes);
+    entregar(c, "{\"red\":0,\"buzzer\":0}");
+    conferir_200(c, "\"red\":0");
+    CONFERIR(c->recebidos == sizeof(CABECALHOS) - 1 + sizeof(CORPO) - 1);
+    CONFERIR(respostas_commands() == antes + 1);
+}
+
+static void testar_byte_a_byte(void) {
+    char requisicao[sizeof(CABECALHOS) + sizeof(CORPO)];
+    int n = snprintf(requisicao, sizeof(requisicao), "%s%s", CABECALHOS, "{\"red\":1,\"buzzer\":1}");
+    captura_t *c = conectar();
+    // O primeiro segmento precisa trazer a linha de requisição; o resto vem um byte por vez
+    int primeiro = strlen("POST /api/commands HTTP/1.1\r\n");
+    captura_entregar(c, requisicao, primeiro);
+    for (int i = primeiro; i < n; i++) {
+        CONFERIR(c->len == 0);
+        captura_entregar(c, requisicao + i, 1);
+    }
+    conferir_200(c, "\"buzzer\":1");
+    CONFERIR(c->recebidos == (uint32_t)n);
+}
+
+static void testar_corpo_grande(void) {
+    captura_t *c = conectar();
+    entregar(c, "POST /api/commands HTTP/1.1\r\nContent-Length: 4096\r\n\r\n{");
+    CONFERIR(captura_contem(c, "HTTP/1.1 400 Bad Request") && c->fechado);
+}
+
+// Cabeçalhos sem fim passam do limite e são recusados sem esperar mais
+static void testar_cabecalhos_sem_fim(void) {
+    captura_t *c = conectar();
+    entregar(c, "POST /api/commands HTTP/1.1\r\n");
+    char linha[64];
+    for (int i = 0; c->len == 0 && i < API_MAX_REQUISICAO / 20; i++) {
+        snprintf(linha, sizeof(linha), "X-Preenchimento-%02d: a\r\n", i);
+        entregar(c, linha);
+    }
+    CONFERIR(captura_contem(c, "HTTP/1.1 400 Bad Request") && c->fechado);
+}
+
+// Corpo que não chega: o poll encerra a conexão e a requisição retida é liberada (ASan)
+static void testar_corpo_ausente(void) {
+    int antes = servidor.conexoes_ativas;
+    captura_t *c = conectar();
+    entregar(c, CABECALHOS);
+    entregar(c, "{\"red\"");
+    CONFERIR(captura_poll(c) == ERR_OK);
+    CONFERIR(c->fechado && c->len == 0);
+    CONFERIR(servidor.conexoes_ativas == antes);
+}
+
+#if RASTRO_ATIVO
+static uint32_t rastros_concluidos(void) {
+    char linha[HTTP_LINHA_MAX];
+    unsigned long seq = 0;
+    bool algum = false;
+    for (uint16_t i = 0; rastro_formatar_linha(i, linha, sizeof(linha)) > 0; i++) {
+        if (sscanf(linha, "rastro %lu", &seq) == 1) algum = true;
+    }
+    return algum ? seq + 1 : 0;
+}
+
+// Requisições em RASTRO_AMOSTRAGEM segmentos: se cada segmento contasse, o que fecha a
+// requisição cairia sempre no mesmo resto e ou todas ou nenhuma seriam rastreadas
+static void testar_amostragem_rastro(void) {
+    uint32_t antes = rastros_concluidos();
+    int pedaco = (sizeof(CORPO) - 1 + RASTRO_AMOSTRAGEM - 2) / (RASTRO_AMOSTRAGEM - 1);
+    for (int r = 0; r < 2 * RASTRO_AMOSTRAGEM; r++) {
+        captura_t *c = conectar();
+        entregar(c, CABECALHOS);
+        for (size_t i = 0; i < sizeof(CORPO) - 1; i += pedaco) {
+            size_t n = sizeof(CORPO) - 1 - i;
+            captura_entregar(c, CORPO + i, n < (size_t)pedaco ? n : (size_t)pedaco);
+        }
+        CONFERIR(c->fechado);
+    }
+    CONFERIR(rastros_concluidos() == antes + 2);
+}
+#endif
+
+int main(void) {
+    captura_iniciar();
+    core1_worker_iniciar();
+    IP4_ADDR(&servidor.gw, 192, 168, 4, 1);
+    testar_um_segmento();
+    testar_corpo_depois();
+    testar_byte_a_byte();
+    testar_corpo_grande();
+    testar_cabecalhos_sem_fim();
+    testar_corpo_ausente();
+#if RASTRO_ATIVO
+    testar_amostragem_rastro();
+#endif
+    return teste_fim("teste_api");
+}
@@ -0,0 +1,213 @@
+// Gestos dos botões (botao_gestos.c) a partir de bordas roteirizadas: quique na pressão e na
+// soltura, clique, duplo, longo com chiado no contato e fila de bordas cheia. O laço abaixo
+// espelha botoes_processar: a IRQ põe (nível, instante) numa fila de BOTOES_FILA_TAM que
+// descarta a borda mais nova quando cheia, e o worker roda quando há bordas ou no prazo.
+
+#include <string.h>
+#include "botoes.h"
+#include "teste.h"
+
+#define PASSO_US 100
+#define MS 1000
+#define MAX_BORDAS 128
+#define MAX_GESTOS 8
+
+typedef struct {
+    uint32_t t_us;
+    bool pressionado;
+} borda_t;
+
+typedef struct {
+    botao_gesto_t gesto;
+    uint32_t t_decisao;
+    uint32_t t_emitido;
+} gesto_t;
+
+typedef struct {
+    borda_t bordas[MAX_BORDAS];
+    int num_bordas;
+    uint32_t ocupado_de_us;  // o worker não roda neste intervalo (core0 ocupado)
+    uint32_t ocupado_ate_us;
+    bool sincronizar;        // reler o nível no worker, como botoes.c
+} roteiro_t;
+
+typedef struct {
+    gesto_t gestos[MAX_GESTOS];
+    int num_gestos;
+    int descartadas;
+} resultado_t;
+
+static void pressionar(roteiro_t *r, uint32_t t_us, int quiques) {
+    // Quiques de 1 ms antes de assentar
+    for (int i = 0; i < quiques; i++) {
+        r->bordas[r->num_bordas++] = (borda_t){t_us + 2 * i * MS, true};
+        r->bordas[r->num_bordas++] = (borda_t){t_us + (2 * i + 1) * MS, false};
+    }
+    r->bordas[r->num_bordas++] = (borda_t){t_us + 2 * quiques * MS, true};
+}
+
+static void soltar(roteiro_t *r, uint32_t t_us, int quiques) {
+    for (int i = 0; i < quiques; i++) {
+        r->bordas[r->num_bordas++] = (borda_t){t_us + 2 * i * MS, false};
+        r->bordas[r->num_bordas++] = (borda_t){t_us + (2 * i + 1) * MS, true};
+    }
+    r->bordas[r->num_bordas++] = (borda_t){t_us + 2 * quiques * MS, false};
+}
+
+static void emitir(botao_t *b, uint32_t agora, resultado_t *res, uint32_t *prazo, bool *tem_prazo) {
+    botao_gesto_t g;
+    uint32_t p;
+    bool tem;
+    while ((g = botao_avaliar(b, agora, &p, &tem)) != GESTO_NENHUM) {
+        if (res->num_gestos < MAX_GESTOS) res->gestos[res->num_gestos++] = (gesto_t){g, b->t_decisao, agora};
+    }
+    if (tem && (!*tem_prazo || (int32_t)(p - *prazo) < 0)) *prazo = p, *tem_prazo = true;
+}
+
+static resultado_t simular(const roteiro_t *r, uint32_t fim_us) {
+    resultado_t res = {0};
+    botao_t b;
+    botao_init(&b);
+    borda_t fila[BOTOES_FILA_TAM];
+    int ocupacao = 0, proxima = 0;
+    bool nivel = false, pendente = false, tem_prazo = false;
+    uint32_t prazo = 0;
+    for (uint32_t t = 0; t <= fim_us; t += PASSO_US) {
+        // IRQ: carimba cada borda deste passo; a mais nova se perde com a fila cheia
+        while (proxima < r->num_bordas && r->bordas[proxima].t_us <= t) {
+            nivel = r->bordas[proxima].pressionado;
+            if (ocupacao < BOTOES_FILA_TAM) fila[ocupacao++] = r->bordas[proxima];
+            else res.descartadas++;
+            proxima++;
+            pendente = true;
+        }
+        bool no_prazo = tem_prazo && (int32_t)(t - prazo) >= 0;
+        if ((t >= r->ocupado_de_us && t < r->ocupado_ate_us) || (!pendente && !no_prazo)) continue;
+
+        // botoes_processar
+        uint32_t p = 0;
+        bool tem = false;
+        for (int i = 0; i < ocupacao; i++) {
+            emitir(&b, fila[i].t_us, &res, &p, &tem);
+            botao_borda(&b, fila[i].pressionado, fila[i].t_us);
+        }
+        ocupacao = 0;
+        pendente = false;
+        tem_prazo = false;
+        if (r->sincronizar) botao_borda(&b, nivel, t);
+        emitir(&b, t, &res, &prazo, &tem_prazo);
+    }
+    return res;
+}
+
+static bool gestos_iguais(const resultado_t *res, const botao_gesto_t *esperados, int n) {
+    if (res->num_gestos != n) return false;
+    for (int i = 0; i < n; i++) {
+        if (res->gestos[i].gesto != esperados[i]) return false;
+    }
+    return true;
+}
+
+static void testar_clique(void) {
+    roteiro_t r = {.sincronizar = true};
+    pressionar(&r, 100 * MS, 4);
+    soltar(&r, 250 * MS, 3);
+    resultado_t res = simular(&r, 2000 * MS);
+    CONFERIR(gestos_iguais(&res, (botao_gesto_t[]){GESTO_CLIQUE}, 1));
+    // Decidido quando a janela de duplo vence, contada da última borda da soltura
+    CONFERIR(res.gestos[0].t_decisao == 256 * MS + BOTAO_DUPLO_US);
+    CONFERIR(res.gestos[0].t_emitido - res.gestos[0].t_decisao < 2 * PASSO_US);
+}
+
+static void testar_glitch(void) {
+    roteiro_t r = {.sincronizar = true};
+    r.bordas[r.num_bordas++] = (borda_t){100 * MS, true};
+    r.bordas[r.num_bordas++] = (borda_t){100 * MS + BOTAO_DEBOUNCE_US / 2, false};
+    resultado_t res = simular(&r, 2000 * MS);
+    CONFERIR(res.num_gestos == 0);
+}
+
+static void testar_duplo(void) {
+    roteiro_t r = {.sincronizar = true};
+    pressionar(&r, 100 * MS, 2);
+    soltar(&r, 200 * MS, 2);
+    pressionar(&r, 400 * MS, 3);
+    soltar(&r, 500 * MS, 1);
+    resultado_t res = simular(&r, 2000 * MS);
+    CONFERIR(gestos_iguais(&res, (botao_gesto_t[]){GESTO_DUPLO}, 1));
+    // Emitido na segunda pressão, sem esperar a soltura
+    CONFERIR(res.gestos[0].t_emitido < 500 * MS);
+}
+
+static void testar_longo(void) {
+    roteiro_t r = {.sincronizar = true};
+    pressionar(&r, 100 * MS, 5);
+    // Chiado no contato bem na hora de decidir, mais curto que o debounce
+    uint32_t t_pressao = 110 * MS;
+    uint32_t decisao = t_pressao + BOTAO_LONGO_US;
+    r.bordas[r.num_bordas++] = (borda_t){decisao - 2 * MS, false};
+    r.bordas[r.num_bordas++] = (borda_t){decisao + 3 * MS, true};
+    soltar(&r, 1800 * MS, 4);
+    resultado_t res = simular(&r, 3000 * MS);
+    CONFERIR(gestos_iguais(&res, (botao_gesto_t[]){GESTO_LONGO}, 1));
+    CONFERIR(res.gestos[0].t_decisao == decisao);
+    CONFERIR(res.gestos[0].t_emitido <= decisao + 3 * MS + BOTAO_DEBOUNCE_US);
+}
+
+// Soltura com contato ruim e core0 ocupado: a fila enche durante o quique, termina em
+// "pressionado" e a última borda, a soltura de verdade, é a que se perde
+static roteiro_t roteiro_fila_cheia(bool sincronizar) {
+    roteiro_t r = {.sincronizar = sincronizar, .ocupado_de_us = 250 * MS, .ocupado_ate_us = 400 * MS};
+    pressionar(&r, 100 * MS, 0);
+    soltar(&r, 300 * MS, BOTOES_FILA_TAM);
+    return r;
+}
+
+static void testar_fila_cheia(void) {
+    roteiro_t r = roteiro_fila_cheia(true);
+    resultado_t res = simular(&r, 3000 * MS);
+    CONFERIR(res.descartadas > 0);
+    CONFERIR(gestos_iguais(&res, (botao_gesto_t[]){GESTO_CLIQUE}, 1));
+
+    // Sem reler o nível, a soltura perdida vira pressão longa e dispara o alarme
+    r = roteiro_fila_cheia(false);
+    res = simular(&r, 3000 * MS);
+    CONFERIR(gestos_iguais(&res, (botao_gesto_t[]){GESTO_LONGO}, 1));
+
+    // Worker preso até o prazo do longo: a releitura chega junto com a decisão e a soltura,
+    // ainda em debounce, impede o gesto longo
+    r = roteiro_fila_cheia(true);
+    r.ocupado_ate_us = 100 * MS + BOTAO_LONGO_US;
+    res = simular(&r, 3000 * MS);
+    CONFERIR(gestos_iguais(&res, (botao_gesto_t[]){GESTO_CLIQUE}, 1));
+
+    // Pressão perdida: o botão segue apertado e o gesto longo vem, contado da releitura
+    r = (roteiro_t){.sincronizar = true, .ocupado_de_us = 0, .ocupado_ate_us = 400 * MS};
+    pressionar(&r, 100 * MS, BOTOES_FILA_TAM / 2);
+    res = simular(&r, 3000 * MS);
+    CONFERIR(res.descartadas > 0);
+    CONFERIR(gestos_iguais(&res, (botao_gesto_t[]){GESTO_LONGO}, 1));
+    CONFERIR(res.gestos[0].t_decisao == 400 * MS + BOTAO_LONGO_US);
+}
+
+// O contador de 32 bits volta a zero no meio do gesto (~71 min de uptime)
+static void testar_volta_do_relogio(void) {
+    botao_t b;
+    botao_init(&b);
+    uint32_t t0 = UINT32_MAX - 500 * MS, p;
+    bool tem;
+    botao_borda(&b, true, t0);
+    CONFERIR(botao_avaliar(&b, t0 + BOTAO_DEBOUNCE_US, &p, &tem) == GESTO_NENHUM && tem);
+    CONFERIR(p == t0 + BOTAO_LONGO_US);
+    CONFERIR(botao_avaliar(&b, t0 + BOTAO_LONGO_US, &p, &tem) == GESTO_LONGO);
+}
+
+int main(void) {
+    testar_clique();
+    testar_glitch();
+    testar_duplo();
+    testar_longo();
+    testar_fila_cheia();
+    testar_volta_do_relogio();
+    return teste_fim("teste_botao_gestos");
+}
@@ -0,0 +1,216 @@
+// Conciliação de estacoes_tabela contra uma fonte roteirizada: cada rodada devolve a lista
+// de MACs associados (ou falha) e guarda quem foi expulso. Com ESTACOES_MAX + 2 estações
+// (10 contra 8 no padrão) saem exatamente duas expulsões; leases de quem saiu, de quem foi
+// expulso e sem estação nenhuma são zerados, e uma rodada sem lista ou com a lista cheia
+// (talvez truncada) não libera nada. A mesma conciliação passa depois pela fonte do cyw43 de
+// estacoes.c, com o driver trocado (-Wl,--wrap) por um que também falha.
+
+#include <stdbool.h>
+#include <string.h>
+#include "estacoes.c"
+#include "teste.h"
+
+#define NUM_ESTACOES (ESTACOES_MAX + 2)
+#define RODADA_MAX (ESTACOES_LISTA_MAX + 4) // a fonte pode ter mais do que cabe na lista
+
+typedef struct {
+    int num;     // < 0: a fonte falha
+    uint8_t macs[RODADA_MAX][6];
+} rodada_t;
+
+static rodada_t rodada;
+static uint8_t expulsos[RODADA_MAX][6];
+static int num_expulsos;
+
+static int listar(uint8_t *macs, int max) {
+    if (rodada.num < 0) return -1;
+    int n = rodada.num < max ? rodada.num : max;
+    memcpy(macs, rodada.macs, 6 * n);
+    return n;
+}
+
+static void expulsar(const uint8_t mac[6]) {
+    if (num_expulsos < RODADA_MAX) memcpy(expulsos[num_expulsos], mac, 6);
+    num_expulsos++;
+}
+
+// Driver do cyw43 roteirizado pela mesma rodada: com falha devolve erro e, como o de verdade,
+// deixa num_stas em max e macs sem preencher
+int __wrap_cyw43_wifi_ap_get_stas(cyw43_t *self, int *num_stas, uint8_t *macs) {
+    if (rodada.num < 0) return -5;
+    *num_stas = listar(macs, *num_stas);
+    return 0;
+}
+
+int __wrap_cyw43_ioctl(cyw43_t *self, uint32_t cmd, size_t len, uint8_t *buf, uint32_t iface) {
+    if (cmd != IOCTL_DESASSOCIAR || len != 10 || buf[0] != MOTIVO_AP_LOTADO || iface != CYW43_ITF_AP) return -1;
+    expulsar(buf + 4);
+    return 0;
+}
+
+static const estacoes_fonte_t FONTE = {listar, expulsar};
+
+// Estação i: 02:00:00:00:00:i (0 nunca é usado, fica para o lease "vazio")
+static void mac_de(uint8_t mac[6], int i) {
+    static const uint8_t BASE[6] = {0x02, 0, 0, 0, 0, 0};
+    memcpy(mac, BASE, 6);
+    mac[5] = (uint8_t)i;
+}
+
+// Rodada com as estações de primeira a ultima, menos as de "fora" (lista terminada em 0)
+static void associadas(int primeira, int ultima, const int *fora) {
+    rodada.num = 0;
+    for (int i = primeira; i <= ultima && rodada.num < RODADA_MAX; i++) {
+        bool ausente = false;
+        for (const int *f = fora; f && *f; f++) ausente |= *f == i;
+        if (!ausente) mac_de(rodada.macs[rodada.num++], i);
+    }
+}
+
+static void dar_lease(dhcp_server_t *d, int slot, int estacao) {
+    mac_de(d->lease[slot].mac, estacao);
+    d->lease[slot].expiry = 600;
+}
+
+static bool lease_livre(const dhcp_server_t *d, int slot) {
+    static const uint8_t VAZIO[6];
+    return memcmp(d->lease[slot].mac, VAZIO, 6) == 0 && d->lease[slot].expiry == 0;
+}
+
+static bool lease_de(const dhcp_server_t *d, int slot, int estacao) {
+    uint8_t mac[6];
+    mac_de(mac, estacao);
+    return memcmp(d->lease[slot].mac, mac, 6) == 0 && d->lease[slot].expiry != 0;
+}
+
+static bool na_tabela(const estacoes_t *e, int estacao) {
+    uint8_t mac[6];
+    mac_de(mac, estacao);
+    for (int i = 0; i < e->num; i++) {
+        if (memcmp(e->tabela[i].mac, mac, 6) == 0) return true;
+    }
+    return false;
+}
+
+static bool expulso(int indice, int estacao) {
+    uint8_t mac[6];
+    mac_de(mac, estacao);
+    return indice < num_expulsos && memcmp(expulsos[indice], mac, 6) == 0;
+}
+
+// Tabela com as estações 1..ESTACOES_MAX, cada uma com seu lease
+static void preencher(estacoes_t *e, dhcp_server_t *d, uint32_t agora_ms) {
+    associadas(1, ESTACOES_MAX, NULL);
+    for (int i = 0; i < ESTACOES_MAX && i < DHCPS_MAX_IP; i++) dar_lease(d, i, i + 1);
+    estacoes_conciliar(e, agora_ms);
+    CONFERIR(e->num == ESTACOES_MAX);
+}
+
+// A fonte tem mais associadas do que cabe na lista e as da tabela vieram por último: elas
+// não somem nem perdem o lease, e as novas que apareceram são expulsas
+static void testar_lista_cheia(dhcp_server_t *dhcp) {
+    static estacoes_t e;
+    estacoes_init(&e, &FONTE, dhcp);
+    preencher(&e, dhcp, 1000);
+    num_expulsos = 0;
+    associadas(100, 100 + RODADA_MAX - 1, NULL);
+    estacoes_conciliar(&e, 2000);
+    CONFERIR(e.listas_cheias == 1 && e.saidas == 0 && e.leases_liberados == 0);
+    CONFERIR(e.num == ESTACOES_MAX && num_expulsos == ESTACOES_LISTA_MAX);
+    CONFERIR(expulso(0, 100) && expulso(ESTACOES_LISTA_MAX - 1, 100 + ESTACOES_LISTA_MAX - 1));
+    for (int i = 0; i < ESTACOES_MAX && i < DHCPS_MAX_IP; i++) CONFERIR(lease_de(dhcp, i, i + 1));
+
+    // Exatamente ESTACOES_LISTA_MAX também pode ser corte: a excedente ainda é expulsa
+    num_expulsos = 0;
+    associadas(2, ESTACOES_LISTA_MAX + 1, NULL);
+    estacoes_conciliar(&e, 3000);
+    CONFERIR(e.listas_cheias == 2 && e.saidas == 0 && na_tabela(&e, 1) && lease_de(dhcp, 0, 1));
+    CONFERIR(num_expulsos == ESTACOES_LISTA_MAX + 1 - ESTACOES_MAX);
+
+    // Com a lista de volta abaixo do limite a estação 1, que não está nela, sai
+    associadas(2, ESTACOES_MAX, NULL);
+    estacoes_conciliar(&e, 4000);
+    CONFERIR(e.saidas == 1 && !na_tabela(&e, 1) && lease_livre(dhcp, 0));
+    memset(dhcp->lease, 0, sizeof(dhcp->lease));
+}
+
+// A fonte de estacoes.c: erro do driver conta como falha e não toca tabela nem leases
+static void testar_cyw43(dhcp_server_t *dhcp) {
+    static estacoes_t e;
+    estacoes_init(&e, &FONTE_CYW43, dhcp);
+    preencher(&e, dhcp, 1000);
+    num_expulsos = 0;
+    rodada.num = -1;
+    estacoes_conciliar(&e, 2000);
+    CONFERIR(e.falhas == 1 && e.num == ESTACOES_MAX && e.saidas == 0 && e.leases_liberados == 0);
+    for (int i = 0; i < ESTACOES_MAX && i < DHCPS_MAX_IP; i++) CONFERIR(lease_de(dhcp, i, i + 1));
+
+    associadas(1, NUM_ESTACOES, NULL);
+    estacoes_conciliar(&e, 3000);
+    CONFERIR(num_expulsos == 2 && expulso(0, NUM_ESTACOES - 1) && expulso(1, NUM_ESTACOES));
+    CONFERIR(e.num == ESTACOES_MAX && e.saidas == 0);
+}
+
+int main(void) {
+    static dhcp_server_t dhcp;
+    static estacoes_t e;
+    IP4_ADDR(ip_2_ip4(&dhcp.ip), 192, 168, 4, 1);
+    estacoes_init(&e, &FONTE, &dhcp);
+
+    // Todas associam de uma vez: as ESTACOES_MAX primeiras entram, as duas últimas saem.
+    // Uma delas já tinha pego lease, e há um lease esquecido de uma estação que nunca apareceu.
+    associadas(1, NUM_ESTACOES, NULL);
+    dar_lease(&dhcp, 0, 1);
+    dar_lease(&dhcp, 1, NUM_ESTACOES);
+    dar_lease(&dhcp, 2, 200);
+    estacoes_conciliar(&e, 1000);
+    CONFERIR(num_expulsos == 2);
+    CONFERIR(expulso(0, NUM_ESTACOES - 1) && expulso(1, NUM_ESTACOES));
+    CONFERIR(e.num == ESTACOES_MAX && e.expulsas == 2);
+    for (int i = 1; i <= ESTACOES_MAX; i++) CONFERIR(na_tabela(&e, i));
+    CONFERIR(lease_de(&dhcp, 0, 1));
+    CONFERIR(lease_livre(&dhcp, 1) && lease_livre(&dhcp, 2));
+    CONFERIR(e.leases_liberados == 2);
+
+    // A mesma lista de novo não muda a tabela e expulsa as mesmas duas
+    num_expulsos = 0;
+    estacoes_conciliar(&e, 2000);
+    CONFERIR(num_expulsos == 2 && e.expulsas == 4 && e.num == ESTACOES_MAX);
+    CONFERIR(e.tabela[0].desde_ms == 1000 && e.tabela[0].vista_ms == 2000);
+
+    // A estação 3 sai com lease; a vaga é de quem chegar, e as excedentes desistiram
+    num_expulsos = 0;
+    dar_lease(&dhcp, 3, 3);
+    dar_lease(&dhcp, 4, 4);
+    associadas(1, ESTACOES_MAX + 1, (const int[]){3, 0});
+    estacoes_conciliar(&e, 3000);
+    CONFERIR(num_expulsos == 0);
+    CONFERIR(e.saidas == 1 && e.num == ESTACOES_MAX);
+    CONFERIR(!na_tabela(&e, 3) && na_tabela(&e, ESTACOES_MAX + 1));
+    CONFERIR(lease_livre(&dhcp, 3));
+    CONFERIR(lease_de(&dhcp, 0, 1) && lease_de(&dhcp, 4, 4));
+    CONFERIR(e.leases_liberados == 3);
+
+    // Fonte falhando: nenhuma saída e nenhum lease liberado, nem o de quem nunca associou
+    dar_lease(&dhcp, 5, 201);
+    rodada.num = -1;
+    estacoes_conciliar(&e, 4000);
+    CONFERIR(e.falhas == 1 && e.saidas == 1 && e.num == ESTACOES_MAX);
+    CONFERIR(lease_de(&dhcp, 5, 201) && lease_de(&dhcp, 4, 4));
+
+    // Todas saem: a tabela esvazia e nenhum lease sobra
+    associadas(1, 0, NULL);
+    estacoes_conciliar(&e, 5000);
+    CONFERIR(e.num == 0 && e.saidas == 1 + ESTACOES_MAX);
+    for (int i = 0; i < DHCPS_MAX_IP; i++) CONFERIR(lease_livre(&dhcp, i));
+    CONFERIR(e.leases_liberados == 6);
+
+    char linha[160];
+    CONFERIR(estacoes_formatar(&e, 0, 5000, linha, sizeof(linha)) > 0);
+    CONFERIR(strstr(linha, "6 leases liberados, 1 falhas, 0 listas cheias") != NULL);
+    CONFERIR(estacoes_formatar(&e, 1, 5000, linha, sizeof(linha)) == 0);
+
+    testar_lista_cheia(&dhcp);
+    testar_cyw43(&dhcp);
+    return teste_fim("teste_estacoes");
+}
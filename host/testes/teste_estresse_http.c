@@ -0,0 +1,91 @@
+// Estresse por perfil de memória (lwipopts.h): rodadas de HTTP_MAX_CONEXOES conexões
+// simultâneas pedindo as rotas de resposta maior, todas com a fila de envio cheia antes do
+// primeiro ACK. Nenhum tcp_write pode ser recusado por heap ou pool, nenhuma conexão fica
+// aberta, e ao fim de cada rodada o heap e os pools do lwIP voltam ao que eram antes dela.
+// Compilado uma vez por perfil, com LWIP_TELEMETRIA=1 e o heap de MEM_SIZE da placa.
+//
+//   ./teste_estresse_http_<perfil> [rodadas]
+
+#define main firmware_main
+#include "picow_access_point.c"
+#undef main
+
+#include "lwip/stats.h"
+#include "teste.h"
+#include "tcp_captura.h"
+
+#if !MEM_STATS || !MEMP_STATS || MEM_LIBC_MALLOC
+#error "teste_estresse_http precisa de LWIP_TELEMETRIA=1 e MEM_LIBC_MALLOC=0"
+#endif
+
+static const char *const ROTAS[] = {"/bitdoglabtest", "/api/state", "/metrics", "/diario", "/estacoes", "/lwip"};
+#define NUM_ROTAS (int)(sizeof(ROTAS) / sizeof(ROTAS[0]))
+
+static TCP_SERVER_T servidor;
+
+typedef struct {
+    uint32_t usado;
+    uint32_t falhas;
+} uso_t;
+
+// Índice 0 é o heap, os demais os pools na ordem de memp_t
+static void medir(uso_t uso[MEMP_MAX + 1]) {
+    uso[0] = (uso_t){lwip_stats.mem.used, lwip_stats.mem.err};
+    for (int i = 0; i < MEMP_MAX; i++) uso[i + 1] = (uso_t){lwip_stats.memp[i]->used, lwip_stats.memp[i]->err};
+}
+
+static void rodada(int r) {
+    captura_t *c[HTTP_MAX_CONEXOES];
+    uso_t antes[MEMP_MAX + 1], depois[MEMP_MAX + 1];
+    medir(antes);
+
+    // Todas pedem antes de qualquer ACK; os IPs mudam a cada conexão para não cair na taxa
+    for (int k = 0; k < HTTP_MAX_CONEXOES; k++) {
+        int n = r * HTTP_MAX_CONEXOES + k;
+        err_t ret;
+        c[k] = captura_aceitar(tcp_server_accept, &servidor, 10 + n % 200, &ret);
+        CONFERIR(ret == ERR_OK && !c[k]->abortado);
+        char requisicao[80];
+        int len = snprintf(requisicao, sizeof(requisicao), "GET %s HTTP/1.1\r\nHost: 192.168.4.1\r\n\r\n",
+                           ROTAS[n % NUM_ROTAS]);
+        captura_entregar(c[k], requisicao, len);
+    }
+
+    // Um MSS confirmado por conexão, alternando, até nada mais ficar em voo
+    for (bool em_voo = true; em_voo;) {
+        em_voo = false;
+        for (int k = 0; k < HTTP_MAX_CONEXOES; k++) {
+            if (c[k]->pendente == 0) continue;
+            em_voo = true;
+            captura_confirmar(c[k], c[k]->pendente < TCP_MSS ? c[k]->pendente : TCP_MSS);
+        }
+    }
+
+    for (int k = 0; k < HTTP_MAX_CONEXOES; k++) {
+        CONFERIR(captura_contem(c[k], "HTTP/1.1 200 OK"));
+        CONFERIR(c[k]->fechado && !c[k]->abortado);
+        CONFERIR(c[k]->sem_memoria == 0);
+        captura_liberar(c[k]);
+    }
+    CONFERIR(servidor.conexoes_ativas == 0);
+    medir(depois);
+    for (int i = 0; i <= MEMP_MAX; i++) {
+        CONFERIR(depois[i].usado == antes[i].usado);
+        CONFERIR(depois[i].falhas == antes[i].falhas);
+    }
+}
+
+int main(int argc, char **argv) {
+    int rodadas = argc > 1 ? atoi(argv[1]) : 20;
+    captura_iniciar();
+    core1_worker_iniciar();
+    IP4_ADDR(&servidor.gw, 192, 168, 4, 1);
+    printf("teste_estresse_http: %d rodadas de %d conexoes; MEM_SIZE %d, TCP_SND_BUF %d, TCP_SND_QUEUELEN %d\n",
+           rodadas, HTTP_MAX_CONEXOES, MEM_SIZE, TCP_SND_BUF, TCP_SND_QUEUELEN);
+    for (int r = 0; r < rodadas; r++) rodada(r);
+    // Picos de heap e pools com a recomendação de tamanho, como em /lwip
+    lwip_telemetria_imprimir();
+    CONFERIR(lwip_stats.mem.err == 0);
+    for (int i = 0; i < MEMP_MAX; i++) CONFERIR(lwip_stats.memp[i]->err == 0);
+    return teste_fim("teste_estresse_http");
+}
@@ -0,0 +1,230 @@
+// Protocolo da malha (malha_protocolo.c) com NUM_NOS nós sobre um broadcast em memória com
+// perda e atraso fixo, codificando e decodificando cada datagrama: duplicados descartados
+// dentro e fora da janela de 32 relógios, reenvios em 10/20/40/80 ms que param no primeiro
+// eco, nó reiniciado (relógio 0) alcançando o grupo pela resposta ao seu batimento, e todos
+// concordando com o estado dentro do orçamento de reenvios.
+
+#include <string.h>
+#include "malha_protocolo.h"
+#include "teste.h"
+
+#define NUM_NOS 5
+#define LATENCIA_MS 1
+#define PERDA_PCT 20
+#define MAX_EM_VOO 256
+#define JANELA 32 // relógios acompanhados abaixo do maior visto de cada origem
+// Última tentativa da origem mais um repasse, cada salto com a latência
+#define ORCAMENTO_MS (MALHA_REENVIO_MS * ((1u << MALHA_REENVIOS) - 1) + MALHA_TTL * LATENCIA_MS)
+
+typedef struct {
+    uint8_t bytes[MALHA_MSG_TAM];
+    int destino;
+    uint32_t entrega_ms;
+} datagrama_t;
+
+static malha_t nos[NUM_NOS];
+static datagrama_t em_voo[MAX_EM_VOO];
+static int num_em_voo;
+static uint32_t perda_pct;
+static uint32_t semente = 2024;
+static uint32_t agora;
+
+// Congruencial fixo: a mesma sequência de perdas a cada execução
+static bool perdido(void) {
+    semente = semente * 1103515245u + 12345u;
+    return (semente >> 16) % 100 < perda_pct;
+}
+
+static void difundir(int de, const malha_msg_t *m) {
+    uint8_t buf[MALHA_MSG_TAM];
+    CONFERIR(malha_codificar(m, buf) == MALHA_MSG_TAM);
+    for (int i = 0; i < NUM_NOS; i++) {
+        if (i == de || perdido()) continue;
+        CONFERIR(num_em_voo < MAX_EM_VOO);
+        if (num_em_voo == MAX_EM_VOO) return;
+        datagrama_t *d = &em_voo[num_em_voo++];
+        memcpy(d->bytes, buf, sizeof(buf));
+        d->destino = i;
+        d->entrega_ms = agora + LATENCIA_MS;
+    }
+}
+
+// Um ms da malha: entrega o que chegou, com os repasses e respostas, depois os prazos de cada nó
+static void passo(void) {
+    agora++;
+    for (int i = 0; i < num_em_voo;) {
+        if (em_voo[i].entrega_ms > agora) {
+            i++;
+            continue;
+        }
+        datagrama_t d = em_voo[i];
+        em_voo[i] = em_voo[--num_em_voo];
+        malha_msg_t m, saida;
+        CONFERIR(malha_decodificar(d.bytes, sizeof(d.bytes), &m));
+        if (malha_receber(&nos[d.destino], &m, agora, &saida) & MALHA_ENVIAR) difundir(d.destino, &saida);
+    }
+    for (int i = 0; i < NUM_NOS; i++) {
+        malha_msg_t saida;
+        uint32_t proximo_ms;
+        if (malha_tick(&nos[i], agora, &saida, &proximo_ms)) difundir(i, &saida);
+    }
+}
+
+static void avancar(uint32_t ms) {
+    for (uint32_t fim = agora + ms; agora != fim;) passo();
+}
+
+static bool concordam(void) {
+    for (int i = 1; i < NUM_NOS; i++) {
+        if (nos[i].estado != nos[0].estado || nos[i].versao_relogio != nos[0].versao_relogio ||
+            nos[i].versao_origem != nos[0].versao_origem) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void iniciar_malha(uint32_t perda) {
+    agora = 0;
+    num_em_voo = 0;
+    perda_pct = perda;
+    for (int i = 0; i < NUM_NOS; i++) malha_init(&nos[i], i + 1, agora);
+    avancar(10); // primeiros batimentos: todos se conhecem
+}
+
+// Mudança local no nó i, difundida na hora; true se todos concordam dentro do orçamento
+static bool mudar(int i, bool estado) {
+    malha_msg_t saida;
+    malha_local(&nos[i], estado, agora, &saida);
+    difundir(i, &saida);
+    uint32_t inicio = agora;
+    while (!concordam() && agora - inicio < ORCAMENTO_MS) passo();
+    bool ok = concordam() && nos[0].estado == estado && nos[0].versao_origem == nos[i].id;
+    avancar(inicio + ORCAMENTO_MS + 1 - agora); // reenvios esgotados antes da próxima
+    return ok;
+}
+
+static malha_msg_t evento(uint16_t origem, uint32_t relogio, bool estado) {
+    malha_msg_t m = {MALHA_EVENTO, 1, estado, origem, origem, relogio};
+    return m;
+}
+
+static void testar_janela(void) {
+    malha_t n;
+    malha_msg_t m, saida;
+    malha_init(&n, 1, 0);
+    m = evento(7, 100, true);
+    CONFERIR(malha_receber(&n, &m, 0, &saida) == MALHA_APLICAR && n.estado);
+    CONFERIR(malha_receber(&n, &m, 0, &saida) == 0 && n.duplicados == 1);
+
+    // Dentro da janela: inédito passa (e não se aplica por ser mais velho), repetido cai
+    m = evento(7, 100 - JANELA, false);
+    CONFERIR(malha_receber(&n, &m, 0, &saida) == 0 && n.duplicados == 1 && n.estado);
+    CONFERIR(malha_receber(&n, &m, 0, &saida) == 0 && n.duplicados == 2);
+
+    // Fora da janela: velho demais, descartado como duplicado mesmo sem ter sido visto
+    m = evento(7, 100 - JANELA - 1, false);
+    CONFERIR(malha_receber(&n, &m, 0, &saida) == 0 && n.duplicados == 3);
+    m = evento(7, 1, false);
+    CONFERIR(malha_receber(&n, &m, 0, &saida) == 0 && n.duplicados == 4 && n.estado);
+
+    // Um salto além da janela esquece o que havia nela; outra origem tem janela própria
+    m = evento(7, 100 + JANELA + 5, false);
+    CONFERIR(malha_receber(&n, &m, 0, &saida) == MALHA_APLICAR && !n.estado);
+    m = evento(7, 100 + 5, true);
+    CONFERIR(malha_receber(&n, &m, 0, &saida) == 0 && n.duplicados == 4);
+    m = evento(9, 100, true);
+    CONFERIR(malha_receber(&n, &m, 0, &saida) == 0 && n.duplicados == 4);
+}
+
+static void testar_reenvios(void) {
+    malha_t n;
+    malha_msg_t saida, eco;
+    uint32_t proximo_ms, anterior = 0;
+    int num = 0;
+
+    // Sem eco: MALHA_REENVIOS tentativas com o intervalo dobrando, depois só batimentos
+    malha_init(&n, 1, 0);
+    CONFERIR(malha_tick(&n, 0, &saida, &proximo_ms) && saida.tipo == MALHA_BATIMENTO);
+    malha_local(&n, true, 0, &saida);
+    for (uint32_t t = 1; t < MALHA_BATIMENTO_MS; t++) {
+        if (!malha_tick(&n, t, &saida, &proximo_ms) || saida.tipo != MALHA_EVENTO) continue;
+        CONFERIR(t - anterior == (uint32_t)MALHA_REENVIO_MS << num);
+        CONFERIR(saida.origem == 1 && saida.relogio == 1 && saida.ttl == MALHA_TTL);
+        anterior = t;
+        num++;
+    }
+    CONFERIR(num == MALHA_REENVIOS && n.reenviados == MALHA_REENVIOS);
+
+    // Eco depois do primeiro reenvio: param ali. Um batimento mais velho antes dele não conta.
+    malha_init(&n, 1, 0);
+    malha_tick(&n, 0, &saida, &proximo_ms);
+    malha_local(&n, true, 0, &eco);
+    CONFERIR(malha_tick(&n, MALHA_REENVIO_MS, &saida, &proximo_ms) && saida.tipo == MALHA_EVENTO);
+    malha_msg_t velho = {MALHA_BATIMENTO, 1, 0, 3, 0, 0};
+    CONFERIR(malha_receber(&n, &velho, MALHA_REENVIO_MS + 1, &saida) == MALHA_ENVIAR);
+    CONFERIR(saida.tipo == MALHA_BATIMENTO && saida.relogio == 1 && n.reenvios == MALHA_REENVIOS - 1);
+    eco.remetente = 2;
+    eco.ttl--;
+    CONFERIR(malha_receber(&n, &eco, MALHA_REENVIO_MS + 5, &saida) == 0);
+    for (uint32_t t = MALHA_REENVIO_MS + 5; t < MALHA_BATIMENTO_MS; t++) {
+        if (malha_tick(&n, t, &saida, &proximo_ms)) CONFERIR(saida.tipo != MALHA_EVENTO);
+    }
+    CONFERIR(n.reenviados == 1);
+}
+
+// O nó 3 muda o estado mais de uma janela de vezes e reinicia: o primeiro evento depois do
+// boot (relógio 1) fica fora da janela dos vizinhos e é descartado, e o batimento que ele
+// manda logo em seguida recebe na hora a versão do grupo, que traz o relógio junto
+static void testar_reinicio(void) {
+    iniciar_malha(0);
+    for (int i = 0; i < JANELA + 8; i++) CONFERIR(mudar(2, i & 1));
+    CONFERIR(mudar(0, true));
+    uint32_t versao = nos[0].versao_relogio;
+
+    uint32_t duplicados[NUM_NOS];
+    for (int i = 0; i < NUM_NOS; i++) duplicados[i] = nos[i].duplicados;
+    malha_init(&nos[2], 3, agora);
+    malha_msg_t saida;
+    malha_local(&nos[2], false, agora, &saida);
+    CONFERIR(saida.relogio == 1);
+    difundir(2, &saida);
+    uint32_t inicio = agora;
+    while (!concordam() && agora - inicio < ORCAMENTO_MS) passo();
+    CONFERIR(concordam() && nos[2].estado && nos[2].versao_relogio == versao);
+    CONFERIR(nos[2].relogio >= versao && nos[2].reenviados == 0);
+    for (int i = 0; i < NUM_NOS; i++) {
+        if (i != 2) CONFERIR(nos[i].duplicados == duplicados[i] + 1);
+    }
+
+    // Com o relógio recuperado, a próxima mudança dele vence
+    CONFERIR(mudar(2, false));
+}
+
+// Mudanças de todos os nós com perda: cada uma alcança todos dentro do orçamento de reenvios
+static void testar_convergencia(void) {
+    iniciar_malha(PERDA_PCT);
+    int atrasadas = 0;
+    uint32_t duplicados = 0, reenviados = 0;
+    for (int r = 0; r < 60; r++) {
+        if (!mudar(r % NUM_NOS, !nos[r % NUM_NOS].estado)) atrasadas++;
+    }
+    CONFERIR(atrasadas == 0);
+    for (int i = 0; i < NUM_NOS; i++) {
+        duplicados += nos[i].duplicados;
+        reenviados += nos[i].reenviados;
+        CONFERIR(malha_num_vizinhos(&nos[i], agora) == NUM_NOS - 1);
+    }
+    // Com perda houve reenvio, e repasses e reenvios chegaram em dobro
+    CONFERIR(reenviados > 0 && duplicados > 0);
+    printf("teste_malha_protocolo: %d%% de perda, %lu reenvios e %lu duplicados em 60 mudancas\n",
+           PERDA_PCT, (unsigned long)reenviados, (unsigned long)duplicados);
+}
+
+int main(void) {
+    testar_janela();
+    testar_reenvios();
+    testar_reinicio();
+    testar_convergencia();
+    return teste_fim("teste_malha_protocolo");
+}
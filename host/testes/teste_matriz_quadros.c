@@ -0,0 +1,225 @@
+// Quadros da matriz 5x5 (matriz_quadros.c) até o fio: cada palavra passa por uma cópia do
+// programa ws2812.pio (autopull de 24 bits, deslocando pela esquerda), a forma de onda é
+// conferida contra as janelas do WS2812B e decodificada como a cadeia faria, LED a LED.
+// Depois, as cores lidas em cada (x, y) têm de bater com o desenho de cada padrão.
+
+#include <stdbool.h>
+#include <string.h>
+#include "matriz_quadros.h"
+#include "teste.h"
+
+// Ciclos por bit de ws2812.pio e a frequência de bits de matriz.c
+#define PIO_T1 2
+#define PIO_T2 5
+#define PIO_T3 3
+#define FREQ_BITS 800000
+#define CICLO_NS (1000000000 / (FREQ_BITS * (PIO_T1 + PIO_T2 + PIO_T3)))
+
+// Janelas do datasheet do WS2812B (rev. 5), em ns
+#define T0H_MIN 220
+#define T0H_MAX 380
+#define T1H_MIN 580
+#define T1H_MAX 1000
+#define TL_MIN 220
+#define TL_MAX 1000
+#define RESET_NS 280000
+
+#define BITS_QUADRO (MATRIZ_NUM_LEDS * 24)
+#define CICLOS_QUADRO (BITS_QUADRO * (PIO_T1 + PIO_T2 + PIO_T3))
+
+typedef struct {
+    uint8_t r, g, b;
+} cor_t;
+
+static uint8_t onda[CICLOS_QUADRO];
+static uint32_t erros_tempo;
+
+// Um ciclo de PIO por amostra: out x,1 (baixo por T3), jmp (alto por T1), e alto ou baixo por T2
+static int gerar_onda(const uint32_t quadro[MATRIZ_NUM_LEDS]) {
+    int n = 0;
+    for (int i = 0; i < MATRIZ_NUM_LEDS; i++) {
+        uint32_t osr = quadro[i]; // autopull a cada 24 bits, deslocamento para a esquerda
+        for (int b = 0; b < 24; b++) {
+            int x = osr >> 31;
+            osr <<= 1;
+            for (int c = 0; c < PIO_T3; c++) onda[n++] = 0;
+            for (int c = 0; c < PIO_T1; c++) onda[n++] = 1;
+            for (int c = 0; c < PIO_T2; c++) onda[n++] = (uint8_t)x;
+        }
+    }
+    return n;
+}
+
+// O primeiro LED da cadeia fica com os primeiros 24 bits (G, R, B, MSB primeiro) e repassa o resto
+static void decodificar(int ciclos, cor_t leds[MATRIZ_NUM_LEDS]) {
+    uint8_t bits[BITS_QUADRO];
+    int num_bits = 0;
+    int i = 0;
+    while (i < ciclos) {
+        while (i < ciclos && !onda[i]) i++;
+        if (i >= ciclos) break;
+        int alto = 0, baixo = 0;
+        while (i < ciclos && onda[i]) alto++, i++;
+        while (i < ciclos && !onda[i]) baixo++, i++;
+        int alto_ns = alto * CICLO_NS, baixo_ns = baixo * CICLO_NS;
+        bool um = alto_ns >= T1H_MIN && alto_ns <= T1H_MAX;
+        bool zero = alto_ns >= T0H_MIN && alto_ns <= T0H_MAX;
+        // O baixo do último bit se funde com o reset
+        bool ultimo = i >= ciclos;
+        if ((!um && !zero) || (!ultimo && (baixo_ns < TL_MIN || baixo_ns > TL_MAX)) || num_bits >= BITS_QUADRO) {
+            erros_tempo++;
+            continue;
+        }
+        bits[num_bits++] = um;
+    }
+    if (num_bits != BITS_QUADRO) erros_tempo++;
+    memset(leds, 0, MATRIZ_NUM_LEDS * sizeof(cor_t));
+    for (int b = 0; b < num_bits; b++) {
+        cor_t *c = &leds[b / 24];
+        uint8_t *canal = b % 24 < 8 ? &c->g : b % 24 < 16 ? &c->r : &c->b;
+        *canal = (uint8_t)(*canal << 1 | bits[b]);
+    }
+}
+
+// Gera o quadro n e o lê de volta como a matriz o mostraria, em coordenadas (x, y)
+static int ver_quadro(matriz_padrao_t padrao, uint32_t n, cor_t tela[MATRIZ_LADO][MATRIZ_LADO]) {
+    uint32_t quadro[MATRIZ_NUM_LEDS];
+    int animado = matriz_gerar_quadro(padrao, n, quadro);
+    for (int i = 0; i < MATRIZ_NUM_LEDS; i++) CONFERIR((quadro[i] & 0xff) == 0); // 8 bits baixos sobram
+    cor_t leds[MATRIZ_NUM_LEDS];
+    decodificar(gerar_onda(quadro), leds);
+    for (int y = 0; y < MATRIZ_LADO; y++) {
+        for (int x = 0; x < MATRIZ_LADO; x++) tela[y][x] = leds[matriz_indice(x, y)];
+    }
+    return animado;
+}
+
+static bool cor_igual(cor_t c, uint8_t r, uint8_t g, uint8_t b) {
+    return c.r == r && c.g == g && c.b == b;
+}
+
+static int acesos(cor_t tela[MATRIZ_LADO][MATRIZ_LADO]) {
+    int n = 0;
+    for (int y = 0; y < MATRIZ_LADO; y++) {
+        for (int x = 0; x < MATRIZ_LADO; x++) n += !cor_igual(tela[y][x], 0, 0, 0);
+    }
+    return n;
+}
+
+static uint8_t maior_canal(cor_t tela[MATRIZ_LADO][MATRIZ_LADO]) {
+    uint8_t m = 0;
+    for (int y = 0; y < MATRIZ_LADO; y++) {
+        for (int x = 0; x < MATRIZ_LADO; x++) {
+            cor_t c = tela[y][x];
+            if (c.r > m) m = c.r;
+            if (c.g > m) m = c.g;
+            if (c.b > m) m = c.b;
+        }
+    }
+    return m;
+}
+
+static void testar_cadeia(void) {
+    // Serpentina a partir do canto inferior direito; cada posição aparece uma vez
+    CONFERIR(matriz_indice(4, 4) == 0 && matriz_indice(0, 4) == 4);
+    CONFERIR(matriz_indice(0, 3) == 5 && matriz_indice(4, 3) == 9);
+    CONFERIR(matriz_indice(4, 0) == 20 && matriz_indice(0, 0) == 24);
+    uint32_t vistos = 0;
+    for (int y = 0; y < MATRIZ_LADO; y++) {
+        for (int x = 0; x < MATRIZ_LADO; x++) vistos |= 1u << matriz_indice(x, y);
+    }
+    CONFERIR(vistos == (1u << MATRIZ_NUM_LEDS) - 1);
+
+    // Cada canal chega no seu LED, com valores que exercitam todos os bits
+    uint32_t quadro[MATRIZ_NUM_LEDS];
+    for (int i = 0; i < MATRIZ_NUM_LEDS; i++) quadro[i] = ws2812_codificar(i * 10, 0xa5 ^ i, 255 - i);
+    cor_t leds[MATRIZ_NUM_LEDS];
+    decodificar(gerar_onda(quadro), leds);
+    bool ok = true;
+    for (int i = 0; i < MATRIZ_NUM_LEDS; i++) ok &= cor_igual(leds[i], i * 10, 0xa5 ^ i, 255 - i);
+    CONFERIR(ok);
+
+    // O quadro inteiro e o reset cabem no período de 50 ms com folga
+    uint32_t quadro_ns = CICLOS_QUADRO * CICLO_NS;
+    printf("teste_matriz_quadros: bit de %d ns, quadro de %u us no fio\n", (PIO_T1 + PIO_T2 + PIO_T3) * CICLO_NS,
+           quadro_ns / 1000);
+    CONFERIR(quadro_ns + RESET_NS < 1000000000u / MATRIZ_QUADRO_HZ);
+}
+
+static void testar_repouso(void) {
+    cor_t tela[MATRIZ_LADO][MATRIZ_LADO];
+    uint8_t menor = 255, maior = 0;
+    for (uint32_t n = 0; n < 4 * MATRIZ_QUADRO_HZ; n++) {
+        CONFERIR(ver_quadro(MATRIZ_REPOUSO, n, tela) == 1);
+        CONFERIR(acesos(tela) == 1 && tela[2][2].r == 0 && tela[2][2].b == 0);
+        if (tela[2][2].g < menor) menor = tela[2][2].g;
+        if (tela[2][2].g > maior) maior = tela[2][2].g;
+    }
+    CONFERIR(menor == 1 && maior == 1 + MATRIZ_BRILHO_MAX / 8);
+    ver_quadro(MATRIZ_REPOUSO, MATRIZ_QUADRO_HZ, tela);
+    CONFERIR(tela[2][2].g == maior); // pico depois de 1 s
+}
+
+static void testar_estrobo(void) {
+    cor_t tela[MATRIZ_LADO][MATRIZ_LADO];
+    int cheios = 0;
+    for (uint32_t n = 0; n < MATRIZ_QUADRO_HZ; n++) {
+        CONFERIR(ver_quadro(MATRIZ_ESTROBO, n, tela) == 1);
+        int a = acesos(tela);
+        CONFERIR(a == 0 || a == MATRIZ_NUM_LEDS);
+        if (a) {
+            cheios++;
+            CONFERIR(cor_igual(tela[0][0], MATRIZ_BRILHO_MAX, 0, 0) && cor_igual(tela[4][4], MATRIZ_BRILHO_MAX, 0, 0));
+        }
+    }
+    CONFERIR(cheios == 4); // dois flashes de 100 ms por segundo
+}
+
+static void testar_giro(void) {
+    static const uint8_t BORDA[][2] = {
+        {0, 0}, {1, 0}, {2, 0}, {3, 0}, {4, 0}, {4, 1}, {4, 2}, {4, 3},
+        {4, 4}, {3, 4}, {2, 4}, {1, 4}, {0, 4}, {0, 3}, {0, 2}, {0, 1},
+    };
+    cor_t tela[MATRIZ_LADO][MATRIZ_LADO];
+    for (uint32_t n = 0; n < 40; n++) {
+        CONFERIR(ver_quadro(MATRIZ_GIRO, n, tela) == 1);
+        const uint8_t *cabeca = BORDA[n % 16];
+        const uint8_t *rastro = BORDA[(n + 15) % 16];
+        CONFERIR(cor_igual(tela[cabeca[1]][cabeca[0]], MATRIZ_BRILHO_MAX, 0, 0));
+        CONFERIR(cor_igual(tela[rastro[1]][rastro[0]], MATRIZ_BRILHO_MAX >> 2, 0, 0));
+        CONFERIR(cor_igual(tela[2][2], MATRIZ_BRILHO_MAX / 4, 0, 0));
+        CONFERIR(acesos(tela) == 4);
+    }
+}
+
+static void testar_iniciando(void) {
+    cor_t tela[MATRIZ_LADO][MATRIZ_LADO];
+    CONFERIR(ver_quadro(MATRIZ_INICIANDO, 0, tela) == 0); // estático: o tick para depois do primeiro quadro
+    CONFERIR(acesos(tela) == 2 * MATRIZ_LADO - 1);
+    for (int k = 0; k < MATRIZ_LADO; k++) {
+        CONFERIR(cor_igual(tela[2][k], 0, 0, MATRIZ_BRILHO_MAX / 4));
+        CONFERIR(cor_igual(tela[k][2], 0, 0, MATRIZ_BRILHO_MAX / 4));
+    }
+}
+
+static void testar_brilho(void) {
+    cor_t tela[MATRIZ_LADO][MATRIZ_LADO];
+    for (int p = 0; p < NUM_PADROES_MATRIZ; p++) {
+        for (uint32_t n = 0; n < 2 * MATRIZ_QUADRO_HZ; n++) {
+            ver_quadro(p, n, tela);
+            CONFERIR(maior_canal(tela) <= MATRIZ_BRILHO_MAX);
+        }
+    }
+    CONFERIR(ver_quadro(MATRIZ_APAGADA, 0, tela) == 0 && acesos(tela) == 0);
+}
+
+int main(void) {
+    testar_cadeia();
+    testar_repouso();
+    testar_estrobo();
+    testar_giro();
+    testar_iniciando();
+    testar_brilho();
+    CONFERIR(erros_tempo == 0);
+    return teste_fim("teste_matriz_quadros");
+}
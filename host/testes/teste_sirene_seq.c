@@ -0,0 +1,190 @@
+// Sequenciador de tons (sirene_seq.c) contra um PWM simulado do RP2040: a fatia do buzzer
+// conta a 1 MHz e só troca TOP e nível no wrap (buffer duplo); a fatia de tick chama o mesmo
+// passo de sirene.c a cada 10 ms. Confere que cada período tocado corresponde ao último
+// passo escrito, com 50% de trabalho e sem período cortado, e os tempos de cada tom.
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sirene.h"
+#include "teste.h"
+
+#define TICK_CONTAGENS (SIRENE_CONTAGEM_HZ / SIRENE_TICK_HZ)
+#define MAX_TICKS 1000
+
+// Duração de um ciclo de cada tom, em ticks, pelas normas citadas em sirene_seq.h
+static const uint16_t CICLO_TICKS[NUM_TONS] = {
+    [TOM_CONTINUO] = 100, [TOM_TEMPORAL3] = 400, [TOM_VARREDURA] = 150, [TOM_YELP] = 30, [TOM_BITONAL] = 50,
+};
+
+typedef struct {
+    uint16_t top, nivel;           // em uso no período atual
+    uint16_t top_prox, nivel_prox; // escritos, valem no próximo wrap
+    uint16_t freq_atual;
+    sirene_seq_t seq;
+} buzzer_sim_t;
+
+// Igual a sirene_aplicar_passo, com as escritas de registrador no buffer da simulação
+static uint16_t aplicar_passo(buzzer_sim_t *b) {
+    uint16_t freq = sirene_seq_avancar(&b->seq);
+    if (freq == b->freq_atual) return freq;
+    b->freq_atual = freq;
+    sirene_pwm_t p = sirene_calcular_pwm(freq);
+    if (p.top) b->top_prox = p.top;
+    b->nivel_prox = p.nivel;
+    return freq;
+}
+
+typedef struct {
+    uint32_t periodos;
+    uint32_t errados;       // período que não corresponde ao último passo escrito
+    uint32_t trabalho_ruim; // nível diferente de metade do período
+    uint32_t som_contagens; // tempo com o buzzer vibrando
+    uint32_t maior_periodo;
+    double erro_freq_max;   // erro relativo entre a frequência tocada e a pedida
+} medida_t;
+
+static medida_t simular(tom_t tom, uint32_t ticks, uint16_t *alvo) {
+    medida_t m = {0};
+    buzzer_sim_t b = {.top = SIRENE_TOP_REPOUSO, .top_prox = SIRENE_TOP_REPOUSO};
+    // sirene_tocar: passo 0 imediato, com a fatia do buzzer já rodando no TOP de repouso
+    sirene_seq_init(&b.seq, tom);
+    b.freq_atual = UINT16_MAX;
+    alvo[0] = aplicar_passo(&b);
+    uint32_t k = 0;          // último tick já aplicado
+    uint64_t inicio = 0;     // começo do período atual do buzzer
+    uint32_t k_inicio = 0;   // último tick escrito antes dele
+    uint64_t fim = (uint64_t)ticks * TICK_CONTAGENS;
+    while (inicio < fim) {
+        uint64_t wrap = inicio + b.top + 1;
+        uint64_t tick = (uint64_t)(k + 1) * TICK_CONTAGENS;
+        if (tick < wrap && k + 1 < ticks) {
+            alvo[++k] = aplicar_passo(&b);
+            continue;
+        }
+        // Wrap: fecha o período e carrega os registradores do buffer
+        uint32_t len = b.top + 1;
+        if (inicio > 0) { // o primeiro período é o de repouso
+            m.periodos++;
+            uint16_t pedido = alvo[k_inicio];
+            if (pedido == 0) {
+                m.errados += b.nivel != 0;
+            } else {
+                sirene_pwm_t p = sirene_calcular_pwm(pedido);
+                m.errados += b.top != p.top || b.nivel == 0;
+                double tocada = (double)SIRENE_CONTAGEM_HZ / len;
+                double erro = (tocada > pedido ? tocada - pedido : pedido - tocada) / pedido;
+                if (erro > m.erro_freq_max) m.erro_freq_max = erro;
+            }
+            if (b.nivel) {
+                m.trabalho_ruim += abs(2 * (int)b.nivel - (int)len) > 1;
+                m.som_contagens += len;
+            }
+            if (len > m.maior_periodo) m.maior_periodo = len;
+        }
+        b.top = b.top_prox;
+        b.nivel = b.nivel_prox;
+        inicio = wrap;
+        k_inicio = k;
+    }
+    return m;
+}
+
+static void testar_tom(tom_t tom) {
+    static uint16_t alvo[MAX_TICKS];
+    uint32_t ticks = 2 * CICLO_TICKS[tom];
+    medida_t m = simular(tom, ticks, alvo);
+    const char *nome = sirene_nome_tom(tom);
+
+    uint32_t com_som = 0;
+    for (uint32_t i = 0; i < ticks; i++) com_som += alvo[i] != 0;
+    uint32_t esperado = com_som * TICK_CONTAGENS;
+    uint32_t diferenca = m.som_contagens > esperado ? m.som_contagens - esperado : esperado - m.som_contagens;
+
+    printf("teste_sirene_seq %-9s %5u períodos, som %5.3f s (passos %5.3f s), erro de frequência %.3f%%\n",
+           nome, m.periodos, m.som_contagens / 1e6, esperado / 1e6, m.erro_freq_max * 100);
+    CONFERIR(m.periodos > 0);
+    CONFERIR(m.errados == 0);
+    CONFERIR(m.trabalho_ruim == 0);
+    CONFERIR(m.erro_freq_max < 0.002);
+    // Cada borda atrasa no máximo um período do buzzer, e o atraso de ligar compensa o de desligar
+    CONFERIR(diferenca <= 4 * m.maior_periodo);
+}
+
+static void testar_ciclos(void) {
+    for (int t = 0; t < NUM_TONS; t++) {
+        sirene_seq_t s;
+        sirene_seq_init(&s, t);
+        uint32_t n = 0;
+        do {
+            sirene_seq_avancar(&s);
+            n++;
+        } while ((s.indice != 0 || s.tick != 0) && n < MAX_TICKS);
+        CONFERIR(n == CICLO_TICKS[t]);
+    }
+
+    // Temporal-3: três bipes de 0,5 s separados por 0,5 s e pausa de 1,5 s
+    sirene_seq_t s;
+    sirene_seq_init(&s, TOM_TEMPORAL3);
+    char padrao[41] = {0};
+    for (int i = 0; i < 400; i++) {
+        uint16_t f = sirene_seq_avancar(&s);
+        if (i % 10 == 0) padrao[i / 10] = f ? '#' : '.';
+    }
+    CONFERIR(strcmp(padrao, "#####.....#####.....#####...............") == 0);
+
+    // Varredura sobe sem voltar de 500 Hz até perto de 1200 Hz e silencia
+    sirene_seq_init(&s, TOM_VARREDURA);
+    uint16_t anterior = 0, ultimo = 0;
+    bool monotona = true;
+    for (int i = 0; i < 100; i++) {
+        ultimo = sirene_seq_avancar(&s);
+        if (i == 0) CONFERIR(ultimo == 500);
+        monotona &= ultimo >= anterior;
+        anterior = ultimo;
+    }
+    CONFERIR(monotona && ultimo >= 1190 && ultimo < 1200);
+    CONFERIR(sirene_seq_avancar(&s) == 0);
+
+    // Yelp fica entre 800 e 1600 Hz
+    sirene_seq_init(&s, TOM_YELP);
+    bool faixa = true;
+    for (int i = 0; i < 60; i++) {
+        uint16_t f = sirene_seq_avancar(&s);
+        faixa &= f >= 800 && f <= 1600;
+    }
+    CONFERIR(faixa);
+}
+
+static void testar_pwm(void) {
+    sirene_pwm_t p = sirene_calcular_pwm(0);
+    CONFERIR(p.top == 0 && p.nivel == 0);
+    bool ok = true;
+    for (uint32_t f = 1; f <= UINT16_MAX; f++) {
+        p = sirene_calcular_pwm(f);
+        uint32_t efetiva = f < SIRENE_FREQ_MIN_HZ ? SIRENE_FREQ_MIN_HZ : f;
+        ok &= p.top > 0 && p.top == SIRENE_CONTAGEM_HZ / efetiva - 1 && p.nivel == (p.top + 1) / 2;
+    }
+    CONFERIR(ok);
+    CONFERIR(sirene_calcular_pwm(1).top == SIRENE_CONTAGEM_HZ / SIRENE_FREQ_MIN_HZ - 1);
+}
+
+static void testar_nomes(void) {
+    for (int t = 0; t < NUM_TONS; t++) {
+        const char *nome = sirene_nome_tom(t);
+        CONFERIR(sirene_tom_por_nome(nome, strlen(nome)) == (tom_t)t);
+    }
+    CONFERIR(sirene_tom_por_nome("yel", 3) == NUM_TONS);
+    // Tom inválido toca o contínuo
+    sirene_seq_t s;
+    sirene_seq_init(&s, NUM_TONS);
+    CONFERIR(sirene_seq_avancar(&s) == 2700);
+}
+
+int main(void) {
+    for (int t = 0; t < NUM_TONS; t++) testar_tom(t);
+    testar_ciclos();
+    testar_pwm();
+    testar_nomes();
+    return teste_fim("teste_sirene_seq");
+}
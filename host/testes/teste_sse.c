@@ -0,0 +1,151 @@
+// /eventos com muitos assinantes: o estado atual chega logo na assinatura, mesmo antes de
+// qualquer mudança; uma mudança chega a todos no mesmo publicar; assinante com a janela
+// cheia recebe só o estado mais recente; e nada além do pcb fica alocado por assinante.
+//
+// Imprime a latência do publicar até o último tcp_write e o heap retido por assinante.
+
+#include <malloc.h>
+#include <time.h>
+
+#define main firmware_main
+#include "picow_access_point.c"
+#undef main
+
+#include "teste.h"
+#include "tcp_captura.h"
+
+static const char ASSINAR[] = "GET /eventos HTTP/1.1\r\nHost: 192.168.4.1\r\n\r\n";
+
+// Heap vivo, para o custo de cada assinante; os pcbs da captura são alocados fora da medida
+static bool contando;
+static long heap_vivo;
+void *__real_malloc(size_t n);
+void *__real_calloc(size_t n, size_t tam);
+void *__real_realloc(void *p, size_t n);
+void __real_free(void *p);
+
+void *__wrap_malloc(size_t n) {
+    void *p = __real_malloc(n);
+    if (contando && p) heap_vivo += malloc_usable_size(p);
+    return p;
+}
+
+void *__wrap_calloc(size_t n, size_t tam) {
+    void *p = __real_calloc(n, tam);
+    if (contando && p) heap_vivo += malloc_usable_size(p);
+    return p;
+}
+
+void *__wrap_realloc(void *antigo, size_t n) {
+    if (contando && antigo) heap_vivo -= malloc_usable_size(antigo);
+    void *p = __real_realloc(antigo, n);
+    if (contando && p) heap_vivo += malloc_usable_size(p);
+    return p;
+}
+
+void __wrap_free(void *p) {
+    if (contando && p) heap_vivo -= malloc_usable_size(p);
+    __real_free(p);
+}
+
+static TCP_SERVER_T servidor;
+static captura_t *assinantes[SSE_MAX_ASSINANTES];
+
+static uint64_t agora_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void mudar_red(int8_t valor) {
+    int8_t valores[NUM_ATUADORES] = {-1, -1, -1, -1, -1};
+    valores[ATUADOR_RED] = valor;
+    aplicar_comandos(valores, DIARIO_FONTE_HTTP);
+}
+
+static void testar_assinatura(void) {
+    captura_t *c[SSE_MAX_ASSINANTES];
+    for (int i = 0; i < SSE_MAX_ASSINANTES; i++) c[i] = captura_nova(10 + i);
+
+    contando = true;
+    for (int i = 0; i < SSE_MAX_ASSINANTES; i++) {
+        CONFERIR(tcp_server_accept(&servidor, c[i]->pcb, ERR_OK) == ERR_OK);
+        CONFERIR(captura_entregar(c[i], ASSINAR, sizeof(ASSINAR) - 1) == ERR_OK);
+        // Confirmado, o cabeçalho e o primeiro evento saem da fila de envio do lwIP
+        captura_confirmar(c[i], c[i]->pendente);
+    }
+    contando = false;
+
+    for (int i = 0; i < SSE_MAX_ASSINANTES; i++) {
+        assinantes[i] = c[i];
+        CONFERIR(captura_contem(c[i], "Content-Type: text/event-stream"));
+        // Nenhuma mudança ainda: o evento vem do estado publicado na assinatura
+        CONFERIR(captura_contem(c[i], "event: estado\ndata: {\"alarme\":0"));
+        CONFERIR(!c[i]->fechado && !c[i]->abortado);
+    }
+    CONFERIR(sse_num_assinantes() == SSE_MAX_ASSINANTES);
+    CONFERIR(servidor.conexoes_ativas == 0);
+    CONFERIR(heap_vivo < (long)sizeof(TCP_CONNECT_STATE_T));
+    printf("teste_sse: heap retido por assinante %ld bytes (estado da conexao: %zu)\n",
+        heap_vivo / SSE_MAX_ASSINANTES, sizeof(TCP_CONNECT_STATE_T));
+
+    // Sem vaga, o excedente recebe 503 e a conexão é fechada
+    err_t ret;
+    captura_t *excedente = captura_aceitar(tcp_server_accept, &servidor, 40, &ret);
+    captura_entregar(excedente, ASSINAR, sizeof(ASSINAR) - 1);
+    CONFERIR(captura_contem(excedente, "503") && excedente->fechado);
+}
+
+static void testar_latencia(void) {
+    enum { RODADAS = 200 };
+    const struct timespec folga = {.tv_nsec = 1000000}; // o core1 esvazia a fila entre as rodadas
+    uint64_t total = 0, maximo = 0;
+    for (int r = 0; r < RODADAS; r++) {
+        for (int i = 0; i < SSE_MAX_ASSINANTES; i++) {
+            captura_confirmar(assinantes[i], assinantes[i]->pendente);
+            captura_limpar(assinantes[i]);
+        }
+        nanosleep(&folga, NULL);
+        uint64_t t0 = agora_ns();
+        mudar_red(r & 1 ? 0 : 1);
+        uint64_t dt = agora_ns() - t0;
+        total += dt;
+        if (dt > maximo) maximo = dt;
+        for (int i = 0; i < SSE_MAX_ASSINANTES; i++) {
+            CONFERIR(captura_contem(assinantes[i], r & 1 ? "\"red\":0" : "\"red\":1"));
+        }
+    }
+    printf("teste_sse: mudanca ate %d assinantes: media %llu ns, max %llu ns\n",
+        SSE_MAX_ASSINANTES, (unsigned long long)(total / RODADAS), (unsigned long long)maximo);
+}
+
+// Janela cheia: as mudanças intermediárias são descartadas e só a última é entregue
+static void testar_assinante_lento(void) {
+    captura_t *c = assinantes[0];
+    captura_confirmar(c, c->pendente);
+    captura_limpar(c);
+    uint32_t escritas = c->escritas;
+    u16_t janela = c->pcb->snd_buf;
+    c->pcb->snd_buf = 8;
+    mudar_red(1);
+    int8_t valores[NUM_ATUADORES] = {-1, -1, -1, -1, -1};
+    valores[ATUADOR_GREEN] = 1;
+    aplicar_comandos(valores, DIARIO_FONTE_HTTP);
+    CONFERIR(c->len == 0);
+    c->pcb->snd_buf = janela;
+    captura_poll(c);
+    CONFERIR(captura_contem(c, "\"red\":1,\"green\":1"));
+    CONFERIR(c->escritas == escritas + 1);
+}
+
+int main(void) {
+    captura_iniciar();
+    core1_worker_iniciar(); // as saídas publicadas são as aceitas pela fila do core1
+    IP4_ADDR(&servidor.gw, 192, 168, 4, 1);
+    testar_assinatura();
+    testar_latencia();
+    testar_assinante_lento();
+    for (int i = 0; i < SSE_MAX_ASSINANTES; i++) captura_fin(assinantes[i]);
+    CONFERIR(sse_num_assinantes() == 0);
+    return teste_fim("teste_sse");
+}
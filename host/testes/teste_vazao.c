@@ -0,0 +1,101 @@
+// Ativo de 64 KB servido por http_stream, da flash e por um gerador de pedaços pequenos.
+// O cliente confirma tudo o que está em voo uma vez por RTT: o número de RTTs dá a vazão
+// limitada pela janela (TCP_SND_BUF/TCP_SND_QUEUELEN); o tempo de CPU dá o custo por byte.
+//
+//   ./teste_vazao [repeticoes]
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "http_stream.h"
+#include "teste.h"
+#include "tcp_captura.h"
+
+#define ATIVO_LEN (64 * 1024)
+#define GERADOR_PEDACO 16 // saídas bem menores que um segmento, para exigir a coalescência
+#define RTT_MS 5          // ida e volta típica de um cliente no AP
+
+static const char CABECALHOS[] = "HTTP/1.1 200 OK\nContent-Type: application/octet-stream\nConnection: close\n\n";
+static uint8_t ativo[ATIVO_LEN];
+
+typedef struct {
+    uint32_t pos;
+} gerador_t;
+
+static int gerar(void *ctx, char *buf, int max) {
+    gerador_t *g = ctx;
+    int n = ATIVO_LEN - g->pos;
+    if (n > GERADOR_PEDACO) n = GERADOR_PEDACO;
+    if (n > max) n = max;
+    memcpy(buf, ativo + g->pos, n);
+    g->pos += n;
+    return n;
+}
+
+typedef struct {
+    uint32_t rtts;
+    uint32_t escritas;
+    uint32_t saidas;
+    bool integro;
+} transferencia_t;
+
+static transferencia_t transferir(bool da_flash) {
+    transferencia_t t = {0};
+    static http_stream_t s;
+    gerador_t g = {0};
+    captura_iniciar();
+    captura_t *c = captura_nova(10);
+    http_stream_init(&s, c->pcb);
+    CONFERIR(http_stream_escrever(&s, CABECALHOS, sizeof(CABECALHOS) - 1) == ERR_OK);
+    if (da_flash) http_stream_flash(&s, ativo, ATIVO_LEN);
+    else http_stream_gerador(&s, gerar, &g);
+    CONFERIR(http_stream_bombear(&s) == ERR_OK);
+
+    bool fim = false;
+    while (!fim && t.rtts < 10000) {
+        u16_t em_voo = c->pendente;
+        if (em_voo == 0) break; // parado sem nada em voo: o stream travou
+        t.rtts++;
+        captura_confirmar(c, em_voo);
+        fim = http_stream_confirmar(&s, em_voo);
+        if (!fim) CONFERIR(http_stream_bombear(&s) == ERR_OK);
+    }
+    CONFERIR(fim);
+    t.escritas = c->escritas;
+    t.saidas = c->saidas;
+    t.integro = c->len == sizeof(CABECALHOS) - 1 + ATIVO_LEN &&
+                memcmp(c->saida, CABECALHOS, sizeof(CABECALHOS) - 1) == 0 &&
+                memcmp(c->saida + sizeof(CABECALHOS) - 1, ativo, ATIVO_LEN) == 0;
+    return t;
+}
+
+static double agora_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void medir(const char *nome, bool da_flash, int repeticoes) {
+    transferencia_t t = transferir(da_flash);
+    CONFERIR(t.integro);
+    // Cada RTT leva no máximo uma janela; menos que isso indica que o stream deixou espaço livre
+    CONFERIR(t.rtts <= (ATIVO_LEN + TCP_SND_BUF - 1) / (TCP_SND_BUF / 2));
+    if (!da_flash) CONFERIR(t.escritas < ATIVO_LEN / HTTP_STREAM_BLOCO * 2);
+
+    double inicio = agora_s();
+    for (int i = 0; i < repeticoes; i++) transferir(da_flash);
+    double cpu = (agora_s() - inicio) / repeticoes;
+
+    printf("teste_vazao %-7s %u RTTs, %u tcp_write, %u tcp_output; %.0f KB/s com RTT de %d ms; CPU %.1f MB/s\n",
+           nome, t.rtts, t.escritas, t.saidas, ATIVO_LEN / 1024.0 / (t.rtts * RTT_MS / 1000.0), RTT_MS,
+           ATIVO_LEN / cpu / 1e6);
+}
+
+int main(int argc, char **argv) {
+    int repeticoes = argc > 1 ? atoi(argv[1]) : 20;
+    for (int i = 0; i < ATIVO_LEN; i++) ativo[i] = (uint8_t)(i * 131 + (i >> 8));
+    printf("teste_vazao: TCP_SND_BUF %d, TCP_SND_QUEUELEN %d, TCP_MSS %d\n", TCP_SND_BUF, TCP_SND_QUEUELEN, TCP_MSS);
+    medir("flash", true, repeticoes);
+    medir("gerador", false, repeticoes);
+    return teste_fim("teste_vazao");
+}
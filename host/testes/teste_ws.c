@@ -0,0 +1,236 @@
+// Cliente WebSocket roteirizado contra /ws: handshake com cabeçalhos em qualquer caixa,
+// 400/426 para pedidos de upgrade incompletos, ACKs de texto e binário (inclusive de erro e
+// de parâmetros numéricos inválidos), ping, quadro partido byte a byte, opcode desconhecido
+// fechando com 1002 e falta de vagas.
+
+#define main firmware_main
+#include "picow_access_point.c"
+#undef main
+
+#include "teste.h"
+#include "tcp_captura.h"
+#include "websocket.h"
+
+static TCP_SERVER_T servidor;
+static uint8_t proximo_ip = 10;
+
+static captura_t *pedir(const char *requisicao) {
+    err_t ret;
+    captura_t *c = captura_aceitar(tcp_server_accept, &servidor, proximo_ip++, &ret);
+    CONFERIR(ret == ERR_OK);
+    captura_entregar(c, requisicao, strlen(requisicao));
+    return c;
+}
+
+// Exemplo da RFC 6455 §1.3, com os nomes dos cabeçalhos em minúsculas
+static captura_t *conectar(void) {
+    captura_t *c = pedir("GET /ws HTTP/1.1\r\nHost: 192.168.4.1\r\nupgrade: WebSocket\r\nconnection: Upgrade\r\n"
+                         "sec-websocket-key: dGhlIHNhbXBsZSBub25jZQ==\r\nsec-websocket-version: 13\r\n\r\n");
+    CONFERIR(captura_contem(c, "HTTP/1.1 101 Switching Protocols"));
+    CONFERIR(captura_contem(c, "Sec-WebSocket-Accept: s3pPLMBiTxaQ9kYGzzhZRbK+xOo="));
+    captura_limpar(c);
+    return c;
+}
+
+// Quadro do cliente: FIN, máscara fixa, payload curto
+static size_t quadro(uint8_t *out, uint8_t opcode, const void *payload, uint8_t len) {
+    static const uint8_t mascara[4] = {0x37, 0xfa, 0x21, 0x3d};
+    out[0] = 0x80 | opcode;
+    out[1] = 0x80 | len;
+    memcpy(out + 2, mascara, 4);
+    for (uint8_t i = 0; i < len; i++) out[6 + i] = ((const uint8_t*)payload)[i] ^ mascara[i & 3];
+    return 6 + len;
+}
+
+static void enviar(captura_t *c, uint8_t opcode, const void *payload, uint8_t len) {
+    uint8_t q[6 + WS_MAX_PAYLOAD];
+    // O cliente confirma o que leu: sem isso a fila de envio do lwIP enche como na placa
+    captura_confirmar(c, c->pendente);
+    captura_limpar(c);
+    captura_entregar(c, q, quadro(q, opcode, payload, len));
+}
+
+static bool saida_igual(const captura_t *c, const void *esperado, size_t len) {
+    return c->len == len && memcmp(c->saida, esperado, len) == 0;
+}
+
+static void testar_handshake_invalido(void) {
+    captura_t *c = pedir("GET /ws HTTP/1.1\r\nUpgrade: websocket\r\nSec-WebSocket-Version: 13\r\n\r\n");
+    CONFERIR(captura_contem(c, "HTTP/1.1 400 Bad Request") && c->fechado);
+
+    c = pedir("GET /ws HTTP/1.1\r\nSec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n");
+    CONFERIR(captura_contem(c, "HTTP/1.1 400 Bad Request") && c->fechado);
+
+    c = pedir("GET /ws HTTP/1.1\r\nUpgrade: h2c\r\nSec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n");
+    CONFERIR(captura_contem(c, "HTTP/1.1 400 Bad Request") && c->fechado);
+
+    c = pedir("GET /ws HTTP/1.1\r\nUpgrade: websocket\r\nSec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 8\r\n\r\n");
+    CONFERIR(captura_contem(c, "HTTP/1.1 426 Upgrade Required") && captura_contem(c, "Sec-WebSocket-Version: 13"));
+    CONFERIR(c->fechado);
+
+    // Nome do cabeçalho só no corpo não conta
+    c = pedir("GET /ws HTTP/1.1\r\nUpgrade: websocket\r\nSec-WebSocket-Version: 13\r\n\r\nSec-WebSocket-Key: x\r\n");
+    CONFERIR(captura_contem(c, "HTTP/1.1 400 Bad Request"));
+    CONFERIR(servidor.conexoes_ativas == 0);
+}
+
+static void testar_comandos(void) {
+    captura_t *c = conectar();
+
+    enviar(c, WS_OP_TEXTO, "red=1", 5);
+    CONFERIR(saida_igual(c, "\x81\x02ok", 4));
+    CONFERIR(core1_saida(LED_RED));
+
+    enviar(c, WS_OP_TEXTO, "nada=1", 6);
+    CONFERIR(saida_igual(c, "\x81\x04" "erro", 6));
+
+    enviar(c, WS_OP_BINARIO, "r\x00", 2);
+    CONFERIR(saida_igual(c, "\x82\x01\x00", 3));
+    CONFERIR(!core1_saida(LED_RED));
+
+    enviar(c, WS_OP_BINARIO, "q\x01", 2);
+    CONFERIR(saida_igual(c, "\x82\x01\x01", 3));
+
+    enviar(c, WS_OP_PING, "abc", 3);
+    CONFERIR(saida_igual(c, "\x8a\x03" "abc", 5));
+
+    enviar(c, WS_OP_PONG, NULL, 0);
+    CONFERIR(c->len == 0 && !c->fechado);
+
+    // Quadro entregue um byte por segmento
+    uint8_t q[16];
+    size_t n = quadro(q, WS_OP_TEXTO, "green=1", 7);
+    captura_limpar(c);
+    for (size_t i = 0; i < n; i++) captura_entregar(c, q + i, 1);
+    CONFERIR(saida_igual(c, "\x81\x02ok", 4));
+    CONFERIR(core1_saida(LED_GREEN));
+
+    // Dois quadros no mesmo segmento
+    n = quadro(q, WS_OP_PING, NULL, 0);
+    n += quadro(q + n, WS_OP_PING, NULL, 0);
+    captura_limpar(c);
+    captura_entregar(c, q, n);
+    CONFERIR(saida_igual(c, "\x8a\x00\x8a\x00", 4));
+
+    enviar(c, WS_OP_FECHAR, "\x03\xe8", 2);
+    CONFERIR(saida_igual(c, "\x88\x02\x03\xe8", 4) && c->fechado);
+}
+
+// Parâmetros numéricos fora da faixa, com lixo ou estourando long não são aplicados (o
+// limiar de temperatura é levado para a faixa)
+static void testar_parametros(void) {
+    captura_t *c = conectar();
+    microfone_stats_t s;
+    enviar(c, WS_OP_TEXTO, "som_limiar=300&som_ms=2000", 26);
+    CONFERIR(saida_igual(c, "\x81\x02ok", 4));
+    microfone_stats(&s, false);
+    CONFERIR(s.limiar_rms == 300 && s.sustentado_ms == 2000);
+
+    static const char *const INVALIDOS[] = {
+        "som_ms=abc", "som_ms=70000", "som_ms=10", "som_ms=-5", "som_ms=1500x", "som_ms=99999999999999999999",
+        "som_limiar=0", "som_limiar=4096", "som_limiar=+9", "som_limiar=", "som_limiar=500&som_ms=5",
+    };
+    for (size_t i = 0; i < sizeof(INVALIDOS) / sizeof(INVALIDOS[0]); i++) {
+        enviar(c, WS_OP_TEXTO, INVALIDOS[i], strlen(INVALIDOS[i]));
+        CONFERIR(saida_igual(c, "\x81\x04" "erro", 6));
+    }
+    microfone_stats(&s, false);
+    CONFERIR(s.limiar_rms == 300 && s.sustentado_ms == 2000);
+
+    enviar(c, WS_OP_TEXTO, "som_ms=32", 9);
+    CONFERIR(saida_igual(c, "\x81\x02ok", 4));
+    microfone_stats(&s, false);
+    CONFERIR(s.limiar_rms == 300 && s.sustentado_ms == SOM_SUSTENTADO_MIN_MS);
+
+    // temp_limiar: graus inteiros, levados para a faixa; lixo, sinal ou estouro são recusados
+    static const struct {
+        const char *comando;
+        bool aceito;
+        int32_t limiar_mc; // depois do comando
+    } TEMPERATURAS[] = {
+        {"temp_limiar=80", true, 80000}, {"temp_limiar=5", true, TEMP_LIMIAR_MIN_MC},
+        {"temp_limiar=500", true, TEMP_LIMIAR_MAX_MC}, {"temp_limiar=75", true, 75000},
+        {"temp_limiar=75.5", false, 75000}, {"temp_limiar=-40", false, 75000},
+        {"temp_limiar=", false, 75000}, {"temp_limiar=99999999999999999999", false, 75000},
+    };
+    for (size_t i = 0; i < sizeof(TEMPERATURAS) / sizeof(TEMPERATURAS[0]); i++) {
+        enviar(c, WS_OP_TEXTO, TEMPERATURAS[i].comando, strlen(TEMPERATURAS[i].comando));
+        CONFERIR(TEMPERATURAS[i].aceito ? saida_igual(c, "\x81\x02ok", 4) : saida_igual(c, "\x81\x04" "erro", 6));
+        temperatura_leitura_t l;
+        temperatura_leitura(&l);
+        CONFERIR(l.filtro.limiar_mc == TEMPERATURAS[i].limiar_mc);
+    }
+
+    // periodo= inválido recusa o comando inteiro: o padrão pedido junto não é aplicado
+    enviar(c, WS_OP_TEXTO, "padrao=sos&periodo=100", 22);
+    CONFERIR(saida_igual(c, "\x81\x02ok", 4) && alarme_padrao() == ALARME_SOS);
+    static const char *const PERIODOS_INVALIDOS[] = {
+        "padrao=pulso&periodo=65636", "padrao=pulso&periodo=5", "padrao=pulso&periodo=2001",
+        "padrao=pulso&periodo=abc", "padrao=pulso&periodo=", "padrao=pulso&periodo=-100",
+    };
+    for (size_t i = 0; i < sizeof(PERIODOS_INVALIDOS) / sizeof(PERIODOS_INVALIDOS[0]); i++) {
+        enviar(c, WS_OP_TEXTO, PERIODOS_INVALIDOS[i], strlen(PERIODOS_INVALIDOS[i]));
+        CONFERIR(saida_igual(c, "\x81\x04" "erro", 6) && alarme_padrao() == ALARME_SOS);
+    }
+    enviar(c, WS_OP_TEXTO, "padrao=pulso&periodo=2000", 25);
+    CONFERIR(saida_igual(c, "\x81\x02ok", 4) && alarme_padrao() == ALARME_PULSO);
+
+    // cor= com exatamente seis dígitos hexadecimais; fade/pulsar limitados pela rampa
+    static const struct {
+        const char *comando;
+        bool aceito;
+    } CORES[] = {
+        {"cor=ff8000", true}, {"cor=%2300ff00&fade=2560", true}, {"cor=#0000ff&pulsar=5120", true},
+        {"cor=ff80", false}, {"cor=ff80000", false}, {"cor=ff80zz", false}, {"cor=+f8000", false},
+        {"cor=0x8000", false}, {"cor=", false}, {"cor=ff8000&fade=2561", false},
+        {"cor=ff8000&fade=65636", false}, {"cor=ff8000&pulsar=5121", false}, {"cor=ff8000&pulsar=-1", false},
+        {"cor=ff8000&fade=abc", false},
+    };
+    for (size_t i = 0; i < sizeof(CORES) / sizeof(CORES[0]); i++) {
+        enviar(c, WS_OP_TEXTO, CORES[i].comando, strlen(CORES[i].comando));
+        CONFERIR(CORES[i].aceito ? saida_igual(c, "\x81\x02ok", 4) : saida_igual(c, "\x81\x04" "erro", 6));
+    }
+    captura_fin(c);
+}
+
+static void testar_erros_protocolo(void) {
+    captura_t *c = conectar();
+    enviar(c, 0x3, "x", 1); // opcode reservado
+    CONFERIR(saida_igual(c, "\x88\x02\x03\xea", 4) && c->fechado);
+
+    c = conectar();
+    enviar(c, 0x0, "x", 1); // continuação sem quadro inicial
+    CONFERIR(saida_igual(c, "\x88\x02\x03\xea", 4) && c->fechado);
+
+    // Sem máscara
+    c = conectar();
+    captura_limpar(c);
+    captura_entregar(c, "\x81\x02ok", 4);
+    CONFERIR(saida_igual(c, "\x88\x02\x03\xea", 4) && c->fechado);
+}
+
+static void testar_vagas(void) {
+    captura_t *c[WS_MAX_CLIENTES];
+    for (int i = 0; i < WS_MAX_CLIENTES; i++) c[i] = conectar();
+    captura_t *excedente = pedir("GET /ws HTTP/1.1\r\nUpgrade: websocket\r\nSec-WebSocket-Version: 13\r\n"
+                                 "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n\r\n");
+    CONFERIR(captura_contem(excedente, "503") && excedente->fechado);
+    for (int i = 0; i < WS_MAX_CLIENTES; i++) {
+        captura_fin(c[i]);
+        CONFERIR(c[i]->fechado);
+    }
+    captura_fin(conectar());
+}
+
+int main(void) {
+    captura_iniciar();
+    core1_worker_iniciar();
+    ws_servidor_init(comando_ws);
+    IP4_ADDR(&servidor.gw, 192, 168, 4, 1);
+    testar_handshake_invalido();
+    testar_comandos();
+    testar_parametros();
+    testar_erros_protocolo();
+    testar_vagas();
+    return teste_fim("teste_ws");
+}
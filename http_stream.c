@@ -0,0 +1,119 @@
+#include <string.h>
+#include "http_stream.h"
+
+static bool http_stream_fim(const http_stream_t *s) {
+    if (s->dados) return s->dados_pos == s->dados_len;
+    if (s->gerar) return s->gerador_fim && s->bloco_len == 0;
+    return true;
+}
+
+static u16_t http_stream_espaco(const http_stream_t *s) {
+    if (tcp_sndqueuelen(s->pcb) + HTTP_STREAM_FOLGA_FILA >= TCP_SND_QUEUELEN) return 0;
+    return tcp_sndbuf(s->pcb);
+}
+
+void http_stream_init(http_stream_t *s, struct tcp_pcb *pcb) {
+    s->pcb = pcb;
+    s->dados = NULL;
+    s->dados_len = 0;
+    s->dados_pos = 0;
+    s->gerar = NULL;
+    s->ctx = NULL;
+    s->gerador_fim = false;
+    s->bloco_len = 0;
+    s->enfileirado = 0;
+    s->confirmado = 0;
+}
+
+err_t http_stream_escrever(http_stream_t *s, const void *dados, u16_t len) {
+    err_t err = tcp_write(s->pcb, dados, len, TCP_WRITE_FLAG_COPY | TCP_WRITE_FLAG_MORE);
+    if (err == ERR_OK) s->enfileirado += len;
+    return err;
+}
+
+void http_stream_flash(http_stream_t *s, const void *dados, uint32_t len) {
+    s->dados = dados;
+    s->dados_len = len;
+    s->dados_pos = 0;
+}
+
+void http_stream_gerador(http_stream_t *s, http_gerador_fn gerar, void *ctx) {
+    s->gerar = gerar;
+    s->ctx = ctx;
+    s->gerador_fim = false;
+    s->bloco_len = 0;
+}
+
+// Flash: fatias do tamanho da janela livre, referenciadas sem cópia
+static err_t http_stream_bombear_flash(http_stream_t *s, u16_t espaco) {
+    uint32_t restante = s->dados_len - s->dados_pos;
+    u16_t n = restante < espaco ? restante : espaco;
+    err_t err = tcp_write(s->pcb, s->dados + s->dados_pos, n, n < restante ? TCP_WRITE_FLAG_MORE : 0);
+    if (err == ERR_OK) {
+        s->dados_pos += n;
+        s->enfileirado += n;
+    }
+    return err;
+}
+
+// Gerador: várias saídas pequenas viram um único tcp_write do bloco
+static err_t http_stream_bombear_gerador(http_stream_t *s, u16_t espaco) {
+    u16_t max = espaco < sizeof(s->bloco) ? espaco : sizeof(s->bloco);
+    while (!s->gerador_fim && max - s->bloco_len >= HTTP_STREAM_MIN_GERADOR) {
+        int n = s->gerar(s->ctx, s->bloco + s->bloco_len, max - s->bloco_len);
+        if (n <= 0) {
+            s->gerador_fim = true;
+        } else {
+            s->bloco_len += n;
+        }
+    }
+    if (s->bloco_len == 0) return s->gerador_fim ? ERR_OK : ERR_MEM;
+    if (s->bloco_len > espaco) return ERR_MEM;
+
+    err_t err = tcp_write(s->pcb, s->bloco, s->bloco_len, TCP_WRITE_FLAG_COPY | (s->gerador_fim ? 0 : TCP_WRITE_FLAG_MORE));
+    if (err == ERR_OK) {
+        s->enfileirado += s->bloco_len;
+        s->bloco_len = 0;
+    }
+    return err;
+}
+
+err_t http_stream_bombear(http_stream_t *s) {
+    err_t err = ERR_OK;
+    while (err == ERR_OK && !http_stream_fim(s)) {
+        u16_t espaco = http_stream_espaco(s);
+        if (espaco == 0) break;
+        err = s->dados ? http_stream_bombear_flash(s, espaco) : http_stream_bombear_gerador(s, espaco);
+    }
+    if (err == ERR_MEM) err = ERR_OK;
+    if (err == ERR_OK) tcp_output(s->pcb);
+    return err;
+}
+
+bool http_stream_confirmar(http_stream_t *s, u16_t len) {
+    s->confirmado += len;
+    return http_stream_fim(s) && s->confirmado >= s->enfileirado;
+}
+
+static int http_linhas_gerar(void *ctx, char *buf, int max) {
+    http_linhas_t *l = (http_linhas_t*)ctx;
+    if (l->pos == l->len) {
+        l->len = l->formatar(l->indice, l->linha, sizeof(l->linha));
+        l->pos = 0;
+        if (l->len == 0) return 0;
+        l->indice++;
+    }
+    int n = l->len - l->pos;
+    if (n > max) n = max;
+    memcpy(buf, l->linha + l->pos, n);
+    l->pos += n;
+    return n;
+}
+
+void http_stream_linhas(http_stream_t *s, http_linhas_t *l, http_linha_fn formatar) {
+    l->formatar = formatar;
+    l->indice = 0;
+    l->pos = 0;
+    l->len = 0;
+    http_stream_gerador(s, http_linhas_gerar, l);
+}
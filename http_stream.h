@@ -0,0 +1,61 @@
+#ifndef HTTP_STREAM_H
+#define HTTP_STREAM_H
+
+#include <stdbool.h>
+#include "lwip/tcp.h"
+
+#define HTTP_STREAM_BLOCO 536       // saídas do gerador acumuladas antes de cada tcp_write
+#define HTTP_STREAM_MIN_GERADOR 64  // espaço mínimo oferecido a cada chamada do gerador
+#define HTTP_STREAM_FOLGA_FILA 4    // pbufs de TCP_SND_QUEUELEN reservadas para outras escritas
+#define HTTP_LINHA_MAX 224          // maior linha de um relatório em texto
+
+// Escreve até max bytes do corpo em buf e retorna quantos escreveu; 0 indica o fim.
+// Sempre que max >= HTTP_STREAM_MIN_GERADOR deve produzir ao menos um byte se ainda houver dados.
+typedef int (*http_gerador_fn)(void *ctx, char *buf, int max);
+
+// Formata a linha indice em linha (com '\n') e retorna o tamanho; 0 indica o fim
+typedef int (*http_linha_fn)(uint16_t indice, char *linha, int max);
+
+// Adaptador de relatórios linha a linha para http_gerador_fn: cada linha é formatada
+// uma única vez e entregue em pedaços do tamanho que o stream pedir
+typedef struct {
+    http_linha_fn formatar;
+    uint16_t indice;
+    uint16_t pos;
+    uint16_t len;
+    char linha[HTTP_LINHA_MAX];
+} http_linhas_t;
+
+typedef struct {
+    struct tcp_pcb *pcb;
+    const uint8_t *dados;   // corpo em flash, enviado sem cópia
+    uint32_t dados_len;
+    uint32_t dados_pos;
+    http_gerador_fn gerar;
+    void *ctx;
+    bool gerador_fim;
+    uint16_t bloco_len;
+    uint32_t enfileirado;   // bytes entregues ao tcp_write
+    uint32_t confirmado;    // bytes confirmados pelo cliente
+    char bloco[HTTP_STREAM_BLOCO];
+} http_stream_t;
+
+void http_stream_init(http_stream_t *s, struct tcp_pcb *pcb);
+
+// Escreve dados curtos (cabeçalhos) por cópia, contabilizando-os na confirmação
+err_t http_stream_escrever(http_stream_t *s, const void *dados, u16_t len);
+
+void http_stream_flash(http_stream_t *s, const void *dados, uint32_t len);
+void http_stream_gerador(http_stream_t *s, http_gerador_fn gerar, void *ctx);
+
+// Usa um http_linhas_t (que precisa viver até o fim da resposta) como gerador
+void http_stream_linhas(http_stream_t *s, http_linhas_t *l, http_linha_fn formatar);
+
+// Enfileira o quanto couber em tcp_sndbuf/TCP_SND_QUEUELEN e chama tcp_output uma vez.
+// ERR_MEM não é erro: o envio continua no próximo tcp_sent.
+err_t http_stream_bombear(http_stream_t *s);
+
+// Contabiliza bytes do tcp_sent; true quando o corpo inteiro foi confirmado
+bool http_stream_confirmar(http_stream_t *s, u16_t len);
+
+#endif
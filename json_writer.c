@@ -0,0 +1,69 @@
+#include <stdio.h>
+#include <string.h>
+#include "json_writer.h"
+
+static void json_descarregar(json_writer_t *w) {
+    if (w->pcb && w->usado && w->err == ERR_OK) {
+        w->err = tcp_write(w->pcb, w->bloco, w->usado, TCP_WRITE_FLAG_COPY | TCP_WRITE_FLAG_MORE);
+    }
+    w->usado = 0;
+}
+
+void json_init(json_writer_t *w, struct tcp_pcb *pcb) {
+    w->pcb = pcb;
+    w->err = ERR_OK;
+    w->len = 0;
+    w->primeiro = true;
+    w->usado = 0;
+}
+
+void json_bruto(json_writer_t *w, const char *s, int len) {
+    w->len += len;
+    if (!w->pcb) return;
+    while (len > 0) {
+        int n = JSON_BLOCO - w->usado;
+        if (n > len) n = len;
+        memcpy(w->bloco + w->usado, s, n);
+        w->usado += n;
+        s += n;
+        len -= n;
+        if (w->usado == JSON_BLOCO) json_descarregar(w);
+    }
+}
+
+static void json_nome(json_writer_t *w, const char *nome) {
+    if (!w->primeiro) json_bruto(w, ",", 1);
+    w->primeiro = false;
+    json_bruto(w, "\"", 1);
+    json_bruto(w, nome, strlen(nome));
+    json_bruto(w, "\":", 2);
+}
+
+void json_abrir_objeto(json_writer_t *w) {
+    json_bruto(w, "{", 1);
+    w->primeiro = true;
+}
+
+void json_fechar_objeto(json_writer_t *w) {
+    json_bruto(w, "}", 1);
+    w->primeiro = false;
+}
+
+void json_campo_int(json_writer_t *w, const char *nome, int valor) {
+    char num[12];
+    json_nome(w, nome);
+    json_bruto(w, num, snprintf(num, sizeof(num), "%d", valor));
+}
+
+// Os valores vêm do próprio firmware; não há escape de aspas
+void json_campo_str(json_writer_t *w, const char *nome, const char *valor) {
+    json_nome(w, nome);
+    json_bruto(w, "\"", 1);
+    json_bruto(w, valor, strlen(valor));
+    json_bruto(w, "\"", 1);
+}
+
+int json_concluir(json_writer_t *w) {
+    json_descarregar(w);
+    return w->err == ERR_OK ? w->len : -1;
+}
@@ -0,0 +1,30 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <stdbool.h>
+#include "lwip/tcp.h"
+
+#define JSON_BLOCO 64 // bytes acumulados na pilha antes de cada tcp_write
+
+// Escreve JSON direto na fila de envio do pcb, sem buffer intermediário no heap.
+// Com pcb == NULL apenas conta bytes, o que permite calcular o Content-Length antes.
+typedef struct {
+    struct tcp_pcb *pcb;
+    err_t err;
+    int len;
+    bool primeiro;
+    uint8_t usado;
+    char bloco[JSON_BLOCO];
+} json_writer_t;
+
+void json_init(json_writer_t *w, struct tcp_pcb *pcb);
+void json_bruto(json_writer_t *w, const char *s, int len);
+void json_abrir_objeto(json_writer_t *w);
+void json_fechar_objeto(json_writer_t *w);
+void json_campo_int(json_writer_t *w, const char *nome, int valor);
+void json_campo_str(json_writer_t *w, const char *nome, const char *valor);
+
+// Descarrega o bloco pendente; retorna o total escrito ou -1 em caso de erro
+int json_concluir(json_writer_t *w);
+
+#endif
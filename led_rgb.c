@@ -0,0 +1,130 @@
+#include "hardware/pwm.h"
+#include "hardware/irq.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+#include "bitdoglab.h"
+#include "led_rgb.h"
+
+// Gama 2,2 aproximada por 0,741·x² + 0,259·x³ (erro abaixo de 1% da escala), avaliada pelo compilador
+#define GAMA(x) ((uint16_t)((741ull * (x) * (x) * 255 + 259ull * (x) * (x) * (x)) * 65535 / (1000ull * 255 * 255 * 255)))
+#define GAMA4(i) GAMA(i), GAMA(i + 1), GAMA(i + 2), GAMA(i + 3)
+#define GAMA16(i) GAMA4(i), GAMA4(i + 4), GAMA4(i + 8), GAMA4(i + 12)
+#define GAMA64(i) GAMA16(i), GAMA16(i + 16), GAMA16(i + 32), GAMA16(i + 48)
+
+// Fração do período (0..65535) para cada brilho de 8 bits
+static const uint16_t TABELA_GAMA[256] = {GAMA64(0), GAMA64(64), GAMA64(128), GAMA64(192)};
+
+static const uint PINOS[3] = {LED_RED, LED_GREEN, LED_BLUE};
+
+static uint slice[3];
+static uint canal[3];
+static uint16_t top_fatia[NUM_PWM_SLICES];
+static bool iniciado;
+
+static uint8_t rampa[LED_RGB_MAX_PASSOS][3];
+static uint16_t num_passos;
+static uint16_t indice;
+static int8_t sentido; // +1/-1 no pulso, 0 no fade
+static volatile uint8_t atual[3];
+
+static void led_rgb_escrever(int c) {
+    uint16_t frac = TABELA_GAMA[atual[c]];
+    uint32_t top = top_fatia[slice[c]];
+    uint32_t nivel = frac == UINT16_MAX ? top + 1 : ((uint32_t)frac * (top + 1)) >> 16;
+    pwm_set_chan_level(slice[c], canal[c], nivel);
+}
+
+static void led_rgb_passo(void) {
+    for (int c = 0; c < 3; c++) {
+        atual[c] = rampa[indice][c];
+        led_rgb_escrever(c);
+    }
+    if (sentido == 0) {
+        if (++indice >= num_passos) pwm_set_enabled(LED_RGB_SLICE_TICK, false);
+    } else {
+        if (indice == num_passos - 1) sentido = -1;
+        else if (indice == 0) sentido = 1;
+        indice += sentido;
+    }
+}
+
+static void led_rgb_irq(void) {
+    if (!(pwm_get_irq_status_mask() & (1u << LED_RGB_SLICE_TICK))) return;
+    pwm_clear_irq(LED_RGB_SLICE_TICK);
+    led_rgb_passo();
+}
+
+void led_rgb_iniciar(void) {
+    uint fatia_buzzer = pwm_gpio_to_slice_num(BUZZER);
+    pwm_config c = pwm_get_default_config();
+    pwm_config_set_wrap(&c, LED_RGB_TOP);
+    for (int i = 0; i < 3; i++) {
+        slice[i] = pwm_gpio_to_slice_num(PINOS[i]);
+        canal[i] = pwm_gpio_to_channel(PINOS[i]);
+        // A fatia do buzzer já foi configurada pela sirene, que informa o TOP
+        if (slice[i] != fatia_buzzer && top_fatia[slice[i]] != LED_RGB_TOP) {
+            pwm_init(slice[i], &c, true);
+            top_fatia[slice[i]] = LED_RGB_TOP;
+        }
+        pwm_set_chan_level(slice[i], canal[i], 0);
+        gpio_set_function(PINOS[i], GPIO_FUNC_PWM);
+    }
+    iniciado = true;
+
+    pwm_config t = pwm_get_default_config();
+    pwm_config_set_clkdiv(&t, 125.0f);
+    pwm_config_set_wrap(&t, clock_get_hz(clk_sys) / 125 / LED_RGB_TICK_HZ - 1);
+    pwm_init(LED_RGB_SLICE_TICK, &t, false);
+    pwm_clear_irq(LED_RGB_SLICE_TICK);
+    pwm_set_irq_enabled(LED_RGB_SLICE_TICK, true);
+    irq_add_shared_handler(PWM_IRQ_WRAP, led_rgb_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(PWM_IRQ_WRAP, true);
+}
+
+// Chamada no core1 fora da interrupção. A rampa é interpolada aqui, uma vez; a
+// interrupção só copia um passo por tick.
+void led_rgb_aplicar(rgb_cor_t cor, rgb_efeito_t efeito, uint16_t duracao_ms) {
+    pwm_set_enabled(LED_RGB_SLICE_TICK, false);
+    pwm_clear_irq(LED_RGB_SLICE_TICK);
+
+    uint8_t de[3] = {atual[0], atual[1], atual[2]};
+    uint8_t para[3] = {cor.r, cor.g, cor.b};
+    if (efeito == RGB_PULSAR) {
+        de[0] = de[1] = de[2] = 0;
+        duracao_ms /= 2;
+    }
+    uint32_t passos = (uint32_t)duracao_ms * LED_RGB_TICK_HZ / 1000;
+    if (passos > LED_RGB_MAX_PASSOS) passos = LED_RGB_MAX_PASSOS;
+    if (efeito == RGB_FIXO || passos < 2) {
+        for (int c = 0; c < 3; c++) {
+            atual[c] = para[c];
+            led_rgb_escrever(c);
+        }
+        return;
+    }
+
+    for (uint32_t i = 0; i < passos; i++) {
+        for (int c = 0; c < 3; c++) {
+            rampa[i][c] = de[c] + ((int32_t)para[c] - de[c]) * (int32_t)(i + 1) / (int32_t)passos;
+        }
+    }
+    num_passos = passos;
+    indice = 0;
+    sentido = efeito == RGB_PULSAR ? 1 : 0;
+    pwm_set_counter(LED_RGB_SLICE_TICK, 0);
+    pwm_set_enabled(LED_RGB_SLICE_TICK, true);
+}
+
+rgb_cor_t led_rgb_cor(void) {
+    rgb_cor_t cor = {atual[0], atual[1], atual[2]};
+    return cor;
+}
+
+void led_rgb_atualizar_top(uint s, uint16_t top) {
+    uint32_t irq = save_and_disable_interrupts();
+    top_fatia[s] = top;
+    for (int c = 0; c < 3 && iniciado; c++) {
+        if (slice[c] == s) led_rgb_escrever(c);
+    }
+    restore_interrupts(irq);
+}
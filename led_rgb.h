@@ -0,0 +1,36 @@
+#ifndef LED_RGB_H
+#define LED_RGB_H
+
+#include <stdint.h>
+#include "pico/stdlib.h"
+
+// LED RGB em PWM com correção gama. Roda no core1: a interrupção de wrap de uma fatia
+// dedicada consome uma rampa pré-calculada, então o fade não ocupa o laço do core1.
+
+#ifndef LED_RGB_SLICE_TICK
+#define LED_RGB_SLICE_TICK 1 // fatia sem pinos usados na placa, base de tempo dos efeitos
+#endif
+#define LED_RGB_TICK_HZ 100
+#define LED_RGB_TOP 4095       // 12 bits a ~30 kHz na fatia própria do vermelho/azul
+#define LED_RGB_MAX_PASSOS 256 // passos da rampa (2,56 s a 100 Hz); fades mais longos ficam mais grossos
+#define LED_RGB_MAX_MS (LED_RGB_MAX_PASSOS * 1000 / LED_RGB_TICK_HZ) // rampa mais longa que cabe
+
+typedef struct {
+    uint8_t r, g, b;
+} rgb_cor_t;
+
+typedef enum {
+    RGB_FIXO,    // aplica a cor imediatamente
+    RGB_FADE,    // rampa da cor atual até a nova em duracao_ms
+    RGB_PULSAR,  // apaga e acende a cor em ciclos de duracao_ms
+} rgb_efeito_t;
+
+void led_rgb_iniciar(void);
+void led_rgb_aplicar(rgb_cor_t cor, rgb_efeito_t efeito, uint16_t duracao_ms);
+rgb_cor_t led_rgb_cor(void);
+
+// O verde (GPIO 11) divide a fatia 5 com o buzzer: quem muda o TOP de uma fatia avisa
+// aqui para o nível dos LEDs dela ser reescalado no mesmo wrap
+void led_rgb_atualizar_top(uint slice, uint16_t top);
+
+#endif
@@ -0,0 +1,65 @@
+#include "lwip_telemetria.h"
+
+#if LWIP_TELEMETRIA
+
+#include <stdio.h>
+#include "lwip/stats.h"
+#include "lwip/memp.h"
+#include "lwip/priv/memp_priv.h"
+#include "http_stream.h"
+
+// Mesma ordem do enum memp_t: o lwIP gera os dois a partir de memp_std.h
+static const char *const NOMES_POOLS[MEMP_MAX] = {
+#define LWIP_MEMPOOL(name, num, size, desc) #name,
+#include "lwip/priv/memp_std.h"
+};
+
+// Folga de 25% (mínimo 2) sobre o pico; com falhas, pelo menos 50% acima do atual
+static uint32_t recomendar(uint32_t avail, uint32_t pico, uint32_t falhas) {
+    uint32_t folga = pico / 4 > 2 ? pico / 4 : 2;
+    uint32_t r = pico + folga;
+    if (falhas && r < avail + avail / 2) r = avail + avail / 2;
+    return r;
+}
+
+static int linha_heap(char *linha, int max) {
+    const struct stats_mem *m = &lwip_stats.mem;
+    uint32_t r = (recomendar(m->avail, m->max, m->err) + 255) & ~255u;
+    return snprintf(linha, max, "heap avail=%lu usado=%lu pico=%lu falhas=%lu -> MEM_SIZE %lu (%+ld B)\n",
+        (unsigned long)m->avail, (unsigned long)m->used, (unsigned long)m->max, (unsigned long)m->err,
+        (unsigned long)r, (long)r - (long)m->avail);
+}
+
+static int linha_pool(int i, char *linha, int max) {
+    const struct stats_mem *m = lwip_stats.memp[i];
+    uint32_t r = recomendar(m->avail, m->max, m->err);
+    long bytes = ((long)r - (long)m->avail) * memp_pools[i]->size;
+    const char *opcao = i == MEMP_PBUF_POOL ? "PBUF_POOL_SIZE" : "MEMP_NUM_";
+    return snprintf(linha, max, "pool %s avail=%lu usado=%lu pico=%lu falhas=%lu tam=%u -> %s%s %lu (%+ld B)\n",
+        NOMES_POOLS[i], (unsigned long)m->avail, (unsigned long)m->used, (unsigned long)m->max,
+        (unsigned long)m->err, memp_pools[i]->size, opcao, i == MEMP_PBUF_POOL ? "" : NOMES_POOLS[i],
+        (unsigned long)r, bytes);
+}
+
+static int linha_enlace(char *linha, int max) {
+    const struct stats_proto *l = &lwip_stats.link;
+    return snprintf(linha, max, "link xmit=%lu recv=%lu drop=%lu memerr=%lu err=%lu\n",
+        (unsigned long)l->xmit, (unsigned long)l->recv, (unsigned long)l->drop,
+        (unsigned long)l->memerr, (unsigned long)l->err);
+}
+
+int lwip_telemetria_formatar_linha(uint16_t indice, char *linha, int max) {
+    if (indice == 0) return linha_heap(linha, max);
+    if (indice <= MEMP_MAX) return linha_pool(indice - 1, linha, max);
+    if (indice == MEMP_MAX + 1) return linha_enlace(linha, max);
+    return 0;
+}
+
+void lwip_telemetria_imprimir(void) {
+    char linha[HTTP_LINHA_MAX];
+    for (uint16_t i = 0; lwip_telemetria_formatar_linha(i, linha, sizeof(linha)) > 0; i++) {
+        fputs(linha, stdout);
+    }
+}
+
+#endif
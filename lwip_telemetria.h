@@ -0,0 +1,19 @@
+#ifndef LWIP_TELEMETRIA_H
+#define LWIP_TELEMETRIA_H
+
+#include <stdint.h>
+#include "lwip/opt.h"
+
+// Uso, pico e falhas do heap e de cada pool do lwIP, com o tamanho sugerido para
+// lwipopts.h. Ligado com LWIP_TELEMETRIA=1, que liga MEM/MEMP/LINK_STATS sem LWIP_DEBUG.
+// Os picos só valem como recomendação depois de uma carga representativa.
+
+#if LWIP_TELEMETRIA
+
+// Uma linha por heap/pool/enlace (http_linha_fn); retorna 0 depois da última
+int lwip_telemetria_formatar_linha(uint16_t indice, char *linha, int max);
+void lwip_telemetria_imprimir(void);
+
+#endif
+
+#endif
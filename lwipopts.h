@@ -12,41 +12,94 @@
 #ifndef LWIP_SOCKET
 #define LWIP_SOCKET                 0
 #endif
+// Os testes por perfil do host passam MEM_LIBC_MALLOC=0 para usar o heap de MEM_SIZE da placa
+#ifndef MEM_LIBC_MALLOC
 #if PICO_CYW43_ARCH_POLL
 #define MEM_LIBC_MALLOC             1
 #else
 // MEM_LIBC_MALLOC is incompatible with non polling versions
 #define MEM_LIBC_MALLOC             0
 #endif
+#endif
 #define MEM_ALIGNMENT               4
+
+// Perfis de memória escolhidos com -DLWIP_PERFIL=portal|clientes|vazao no CMake, que
+// também ajusta os limites de conexão da aplicação. Sem perfil vale o ajuste original.
+#if defined(LWIP_PERFIL_PORTAL)
+// Portal cativo com pouca RAM: segmentos pequenos, uma ou duas conexões por vez.
+// O heap guarda as cópias de tcp_write: cabem as duas conexões do perfil com a fila de
+// envio cheia (dados mais ~80 B de pbuf e cabeçalhos por segmento) e uma resposta DHCP
+#define MEM_SIZE                    (2 * (TCP_SND_BUF + TCP_SND_QUEUELEN * 80) + 600)
+#define TCP_MSS                     536
+#define TCP_WND                     (4 * TCP_MSS)
+#define TCP_SND_BUF                 (4 * TCP_MSS)
+#define MEMP_NUM_TCP_SEG            16
+#define MEMP_NUM_TCP_PCB            5
+#define MEMP_NUM_ARP_QUEUE          4
+#define PBUF_POOL_SIZE              8
+#define LWIP_PERFIL_ENXUTO          1
+#elif defined(LWIP_PERFIL_CLIENTES)
+// AP com muitos clientes: mais pcbs e entradas ARP, janela menor por conexão. O heap cobre
+// o pico de ~12,5 KB do teste_estresse_http_clientes (8 conexões respondendo ao mesmo tempo)
+// com 25% de folga; com 12000 as respostas recebiam ERR_MEM
+#define MEM_SIZE                    16000
+#define TCP_MSS                     1460
+#define TCP_WND                     (4 * TCP_MSS)
+#define TCP_SND_BUF                 (4 * TCP_MSS)
+#define MEMP_NUM_TCP_SEG            64
+#define MEMP_NUM_TCP_PCB            20
+#define MEMP_NUM_ARP_QUEUE          16
+#define ARP_TABLE_SIZE              16
+#define PBUF_POOL_SIZE              16
+#define LWIP_PERFIL_ENXUTO          1
+#elif defined(LWIP_PERFIL_VAZAO)
+// Servidor de arquivos: janela e fila de envio grandes para poucas conexões
+#define MEM_SIZE                    24000
+#define TCP_MSS                     1460
+#define TCP_WND                     (16 * TCP_MSS)
+#define TCP_SND_BUF                 (16 * TCP_MSS)
+#define MEMP_NUM_TCP_SEG            (2 * TCP_SND_QUEUELEN)
+#define MEMP_NUM_TCP_PCB            12
+#define MEMP_NUM_ARP_QUEUE          10
+#define PBUF_POOL_SIZE              32
+#define LWIP_PERFIL_ENXUTO          1
+#else
 #define MEM_SIZE                    4000
+#define TCP_MSS                     1460
+#define TCP_WND                     (8 * TCP_MSS)
+#define TCP_SND_BUF                 (8 * TCP_MSS)
 #define MEMP_NUM_TCP_SEG            32
 #define MEMP_NUM_ARP_QUEUE          10
 #define PBUF_POOL_SIZE              24
+#define LWIP_PERFIL_ENXUTO          0
+#endif
+#define TCP_SND_QUEUELEN            ((4 * (TCP_SND_BUF) + (TCP_MSS - 1)) / (TCP_MSS))
+#define TCP_LISTEN_BACKLOG          1
 #define LWIP_ARP                    1
 #define LWIP_ETHERNET               1
 #define LWIP_ICMP                   1
-#define LWIP_RAW                    1
-#define TCP_WND                     (8 * TCP_MSS)
-#define TCP_MSS                     1460
-#define TCP_SND_BUF                 (8 * TCP_MSS)
-#define TCP_SND_QUEUELEN            ((4 * (TCP_SND_BUF) + (TCP_MSS - 1)) / (TCP_MSS))
+// Os perfis deixam de fora o que o AP não usa: raw pcbs, cliente DNS e keepalive
+#define LWIP_RAW                    (!LWIP_PERFIL_ENXUTO)
 #define LWIP_NETIF_STATUS_CALLBACK  1
 #define LWIP_NETIF_LINK_CALLBACK    1
 #define LWIP_NETIF_HOSTNAME         1
 #define LWIP_NETCONN                0
-#define MEM_STATS                   0
+// Telemetria de pools (/lwip): só os contadores de heap, pools e enlace, sem LWIP_DEBUG
+#ifndef LWIP_TELEMETRIA
+#define LWIP_TELEMETRIA             0
+#endif
+#define MEM_STATS                   LWIP_TELEMETRIA
 #define SYS_STATS                   0
-#define MEMP_STATS                  0
-#define LINK_STATS                  0
+#define MEMP_STATS                  LWIP_TELEMETRIA
+#define LINK_STATS                  LWIP_TELEMETRIA
 // #define ETH_PAD_SIZE                2
 #define LWIP_CHKSUM_ALGORITHM       3
 #define LWIP_DHCP                   1
 #define LWIP_IPV4                   1
 #define LWIP_TCP                    1
 #define LWIP_UDP                    1
-#define LWIP_DNS                    1
-#define LWIP_TCP_KEEPALIVE          1
+#define LWIP_DNS                    (!LWIP_PERFIL_ENXUTO)
+#define LWIP_TCP_KEEPALIVE          (!LWIP_PERFIL_ENXUTO)
 #define LWIP_NETIF_TX_SINGLE_PBUF   1
 #define DHCP_DOES_ARP_CHECK         0
 #define LWIP_DHCP_DOES_ACD_CHECK    0
@@ -56,6 +109,9 @@
 #define LWIP_STATS                  1
 #define LWIP_STATS_DISPLAY          1
 #endif
+#if LWIP_TELEMETRIA && !defined(LWIP_STATS)
+#define LWIP_STATS                  1
+#endif
 
 #define ETHARP_DEBUG                LWIP_DBG_OFF
 #define NETIF_DEBUG                 LWIP_DBG_OFF
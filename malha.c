@@ -0,0 +1,113 @@
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "pico/unique_id.h"
+#include "lwip/pbuf.h"
+#include "lwip/udp.h"
+#include "malha.h"
+#include "malha_protocolo.h"
+#include "alarme.h"
+#include "core1_worker.h"
+#include "diario.h"
+
+static malha_t no;
+static struct udp_pcb *pcb;
+static async_context_t *ctx;
+static async_at_time_worker_t tick_worker;
+static malha_aplicar_fn aplicar_remoto;
+static bool aplicando_remoto;
+
+static uint32_t agora_ms(void) {
+    return to_ms_since_boot(get_absolute_time());
+}
+
+static void difundir(const malha_msg_t *m) {
+    struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, MALHA_MSG_TAM, PBUF_RAM);
+    if (!p) return;
+    malha_codificar(m, p->payload);
+    udp_sendto(pcb, p, IP_ADDR_BROADCAST, MALHA_PORTA);
+    pbuf_free(p);
+}
+
+// Envia tudo o que venceu e reagenda para o próximo reenvio ou batimento
+static void atender(void) {
+    uint32_t agora = agora_ms();
+    uint32_t proximo;
+    malha_msg_t m;
+    while (malha_tick(&no, agora, &m, &proximo)) difundir(&m);
+    // Um worker já na lista não é reagendado pelo add
+    async_context_remove_at_time_worker(ctx, &tick_worker);
+    async_context_add_at_time_worker_at(ctx, &tick_worker, make_timeout_time_ms(proximo - agora));
+}
+
+static void tick_fn(async_context_t *context, async_at_time_worker_t *worker) {
+    atender();
+}
+
+static void malha_recv(void *arg, struct udp_pcb *upcb, struct pbuf *p, const ip_addr_t *addr, u16_t port) {
+    uint8_t buf[MALHA_MSG_TAM];
+    malha_msg_t m, saida;
+    bool valido = pbuf_copy_partial(p, buf, sizeof(buf), 0) == sizeof(buf) && malha_decodificar(buf, sizeof(buf), &m);
+    pbuf_free(p);
+    if (!valido) return;
+
+    unsigned r = malha_receber(&no, &m, agora_ms(), &saida);
+    // Repassa antes de aplicar: o próximo salto não espera o display nem o SSE
+    if (r & MALHA_ENVIAR) difundir(&saida);
+    if (r & MALHA_APLICAR) {
+        core1_mostrar_origem(no.versao_origem);
+        bool antes = alarme_esta_ativo();
+        aplicando_remoto = true;
+        aplicar_remoto(no.estado);
+        aplicando_remoto = false;
+        if (alarme_esta_ativo() != antes) {
+            diario_registrar(antes ? DIARIO_ALARME_DESLIGADO : DIARIO_ALARME_LIGADO, DIARIO_FONTE_MALHA,
+                no.versao_origem, no.versao_relogio);
+        }
+    }
+}
+
+static void alarme_mudou(bool ativo) {
+    if (aplicando_remoto) return;
+    malha_msg_t m;
+    malha_local(&no, ativo, agora_ms(), &m);
+    core1_mostrar_origem(no.id);
+    difundir(&m);
+    atender();
+}
+
+static uint16_t id_da_placa(void) {
+    if (MALHA_NO_ID) return MALHA_NO_ID;
+    pico_unique_board_id_t uid;
+    pico_get_unique_board_id(&uid);
+    uint16_t id = (uint16_t)uid.id[6] << 8 | uid.id[7];
+    return id ? id : 1;
+}
+
+void malha_iniciar(async_context_t *context, malha_aplicar_fn aplicar) {
+    ctx = context;
+    aplicar_remoto = aplicar;
+    malha_init(&no, id_da_placa(), agora_ms());
+
+    pcb = udp_new();
+    if (!pcb) return;
+    ip_set_option(pcb, SOF_BROADCAST);
+    if (udp_bind(pcb, IP_ANY_TYPE, MALHA_PORTA) != ERR_OK) {
+        udp_remove(pcb);
+        pcb = NULL;
+        return;
+    }
+    udp_recv(pcb, malha_recv, NULL);
+    alarme_observar(alarme_mudou);
+    tick_worker.do_work = tick_fn;
+    atender();
+}
+
+uint16_t malha_id(void) {
+    return no.id;
+}
+
+void malha_imprimir(void) {
+    printf("malha: no %u, alarme %d (versao %lu/%u), %d vizinhos, %lu reenvios, %lu duplicados\n",
+        no.id, no.estado, (unsigned long)no.versao_relogio, no.versao_origem,
+        malha_num_vizinhos(&no, agora_ms()), (unsigned long)no.reenviados, (unsigned long)no.duplicados);
+}
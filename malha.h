@@ -0,0 +1,22 @@
+#ifndef MALHA_H
+#define MALHA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pico/async_context.h"
+
+// Alarme compartilhado entre placas da mesma rede por broadcast UDP (ver malha_protocolo.h).
+// Observa o alarme local e difunde cada mudança; mudanças vindas de outros nós chegam por
+// aplicar, chamada no contexto do lwIP.
+
+#ifndef MALHA_NO_ID
+#define MALHA_NO_ID 0 // 0 = derivado do ID único da flash
+#endif
+
+typedef void (*malha_aplicar_fn)(bool ativo);
+
+void malha_iniciar(async_context_t *context, malha_aplicar_fn aplicar);
+uint16_t malha_id(void);
+void malha_imprimir(void);
+
+#endif
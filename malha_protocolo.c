@@ -0,0 +1,191 @@
+#include <string.h>
+#include "malha_protocolo.h"
+
+static const uint8_t MAGICO[3] = {'B', 'D', 1}; // "BD" + versão do protocolo
+
+// Prazos em ms de 32 bits comparados pela diferença, que sobrevive à volta do contador
+static bool venceu(uint32_t agora_ms, uint32_t prazo_ms) {
+    return (int32_t)(agora_ms - prazo_ms) >= 0;
+}
+
+static bool versao_maior(uint32_t relogio_a, uint16_t origem_a, uint32_t relogio_b, uint16_t origem_b) {
+    return relogio_a > relogio_b || (relogio_a == relogio_b && origem_a > origem_b);
+}
+
+size_t malha_codificar(const malha_msg_t *m, uint8_t buf[MALHA_MSG_TAM]) {
+    memcpy(buf, MAGICO, sizeof(MAGICO));
+    buf[3] = m->tipo;
+    buf[4] = m->ttl;
+    buf[5] = m->estado;
+    buf[6] = m->remetente >> 8;
+    buf[7] = m->remetente;
+    buf[8] = m->origem >> 8;
+    buf[9] = m->origem;
+    buf[10] = m->relogio >> 24;
+    buf[11] = m->relogio >> 16;
+    buf[12] = m->relogio >> 8;
+    buf[13] = m->relogio;
+    buf[14] = buf[15] = 0;
+    return MALHA_MSG_TAM;
+}
+
+bool malha_decodificar(const uint8_t *buf, size_t len, malha_msg_t *m) {
+    if (len < MALHA_MSG_TAM || memcmp(buf, MAGICO, sizeof(MAGICO)) != 0) return false;
+    m->tipo = buf[3];
+    m->ttl = buf[4];
+    m->estado = buf[5] ? 1 : 0;
+    m->remetente = (uint16_t)buf[6] << 8 | buf[7];
+    m->origem = (uint16_t)buf[8] << 8 | buf[9];
+    m->relogio = (uint32_t)buf[10] << 24 | (uint32_t)buf[11] << 16 | (uint32_t)buf[12] << 8 | buf[13];
+    if (m->remetente == 0) return false;
+    if (m->tipo == MALHA_EVENTO) return m->origem != 0 && m->ttl > 0;
+    return m->tipo == MALHA_BATIMENTO;
+}
+
+void malha_init(malha_t *n, uint16_t id, uint32_t agora_ms) {
+    memset(n, 0, sizeof(*n));
+    n->id = id;
+    n->proximo_batimento_ms = agora_ms;
+}
+
+// Marca (origem, relógio) como visto; true se já estava. A origem menos ativa cede a vaga.
+static bool ja_visto(malha_t *n, uint16_t origem, uint32_t relogio) {
+    malha_vistos_t *v = NULL;
+    for (int i = 0; i < MALHA_MAX_NOS; i++) {
+        if (n->vistos[i].id == origem) {
+            v = &n->vistos[i];
+            break;
+        }
+        if (!v || n->vistos[i].maior < v->maior) v = &n->vistos[i];
+    }
+    if (v->id != origem) {
+        v->id = origem;
+        v->maior = relogio;
+        v->janela = 0;
+        return false;
+    }
+    if (relogio > v->maior) {
+        uint32_t desloc = relogio - v->maior;
+        if (desloc < 32) v->janela = v->janela << desloc | 1u << (desloc - 1);
+        else v->janela = desloc == 32 ? 1u << 31 : 0;
+        v->maior = relogio;
+        return false;
+    }
+    if (relogio == v->maior) return true;
+    uint32_t d = v->maior - 1 - relogio;
+    if (d >= 32) return true; // fora da janela: velho demais para valer
+    if (v->janela & (1u << d)) return true;
+    v->janela |= 1u << d;
+    return false;
+}
+
+static void vizinho_visto(malha_t *n, uint16_t id, uint32_t agora_ms) {
+    malha_vizinho_t *v = NULL;
+    for (int i = 0; i < MALHA_MAX_NOS; i++) {
+        if (n->vizinhos[i].id == id) {
+            v = &n->vizinhos[i];
+            break;
+        }
+        if (!v || (int32_t)(n->vizinhos[i].visto_ms - v->visto_ms) < 0) v = &n->vizinhos[i];
+    }
+    v->id = id;
+    v->visto_ms = agora_ms;
+}
+
+static void montar_batimento(const malha_t *n, malha_msg_t *saida) {
+    saida->tipo = MALHA_BATIMENTO;
+    saida->ttl = 1;
+    saida->estado = n->estado;
+    saida->remetente = n->id;
+    saida->origem = n->versao_origem;
+    saida->relogio = n->versao_relogio;
+}
+
+static void aplicar(malha_t *n, const malha_msg_t *m) {
+    n->versao_relogio = m->relogio;
+    n->versao_origem = m->origem;
+    n->estado = m->estado;
+}
+
+void malha_local(malha_t *n, bool estado, uint32_t agora_ms, malha_msg_t *saida) {
+    n->relogio++;
+    n->versao_relogio = n->relogio;
+    n->versao_origem = n->id;
+    n->estado = estado;
+    ja_visto(n, n->id, n->relogio);
+
+    malha_msg_t *m = &n->pendente;
+    m->tipo = MALHA_EVENTO;
+    m->ttl = MALHA_TTL;
+    m->estado = estado;
+    m->remetente = n->id;
+    m->origem = n->id;
+    m->relogio = n->relogio;
+    n->reenvios = MALHA_REENVIOS;
+    n->intervalo_ms = MALHA_REENVIO_MS;
+    n->proximo_reenvio_ms = agora_ms + n->intervalo_ms;
+    *saida = *m;
+}
+
+unsigned malha_receber(malha_t *n, const malha_msg_t *m, uint32_t agora_ms, malha_msg_t *saida) {
+    if (m->remetente == n->id) return 0; // o próprio broadcast voltando
+    vizinho_visto(n, m->remetente, agora_ms);
+    if (m->relogio > n->relogio) n->relogio = m->relogio;
+
+    // Qualquer datagrama com a versão pendente (ou mais nova) serve de eco e encerra os reenvios
+    if (n->reenvios && !versao_maior(n->pendente.relogio, n->pendente.origem, m->relogio, m->origem)) {
+        n->reenvios = 0;
+    }
+
+    bool novo = versao_maior(m->relogio, m->origem, n->versao_relogio, n->versao_origem);
+    if (m->tipo == MALHA_EVENTO) {
+        if (ja_visto(n, m->origem, m->relogio)) {
+            n->duplicados++;
+            return 0;
+        }
+        if (!novo) return 0;
+        aplicar(n, m);
+        if (m->ttl <= 1) return MALHA_APLICAR;
+        *saida = *m;
+        saida->ttl--;
+        saida->remetente = n->id;
+        return MALHA_APLICAR | MALHA_ENVIAR;
+    }
+
+    if (novo) {
+        aplicar(n, m);
+        return MALHA_APLICAR;
+    }
+    if (versao_maior(n->versao_relogio, n->versao_origem, m->relogio, m->origem)) {
+        montar_batimento(n, saida);
+        return MALHA_ENVIAR;
+    }
+    return 0;
+}
+
+bool malha_tick(malha_t *n, uint32_t agora_ms, malha_msg_t *saida, uint32_t *proximo_ms) {
+    bool enviar = false;
+    if (n->reenvios && venceu(agora_ms, n->proximo_reenvio_ms)) {
+        *saida = n->pendente;
+        n->reenvios--;
+        n->reenviados++;
+        n->intervalo_ms *= 2;
+        n->proximo_reenvio_ms = agora_ms + n->intervalo_ms;
+        enviar = true;
+    } else if (venceu(agora_ms, n->proximo_batimento_ms)) {
+        montar_batimento(n, saida);
+        n->proximo_batimento_ms = agora_ms + MALHA_BATIMENTO_MS;
+        enviar = true;
+    }
+    *proximo_ms = n->proximo_batimento_ms;
+    if (n->reenvios && (int32_t)(n->proximo_reenvio_ms - *proximo_ms) < 0) *proximo_ms = n->proximo_reenvio_ms;
+    return enviar;
+}
+
+int malha_num_vizinhos(const malha_t *n, uint32_t agora_ms) {
+    int total = 0;
+    for (int i = 0; i < MALHA_MAX_NOS; i++) {
+        if (n->vizinhos[i].id && !venceu(agora_ms, n->vizinhos[i].visto_ms + MALHA_VIZINHO_EXPIRA_MS)) total++;
+    }
+    return total;
+}
@@ -0,0 +1,98 @@
+#ifndef MALHA_PROTOCOLO_H
+#define MALHA_PROTOCOLO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Propagação do alarme entre placas: só aritmética, sem SDK nem rede, para rodar também no host.
+//
+// O estado do alarme é um registrador "último a escrever vence": cada mudança local ganha uma
+// versão (relógio de Lamport, nó de origem) e vale a maior versão conhecida. Um evento novo é
+// difundido na hora e retransmitido em intervalos dobrados até alguém ecoá-lo; quem recebe um
+// evento inédito o aplica e o repassa uma vez. Batimentos periódicos levam a versão atual e
+// fecham qualquer perda: quem ouve uma versão mais velha responde na hora com a sua.
+
+#define MALHA_PORTA 4210
+#define MALHA_MSG_TAM 16
+#define MALHA_TTL 2 // origem + um repasse
+
+#ifndef MALHA_MAX_NOS
+#define MALHA_MAX_NOS 8 // vizinhos e origens acompanhados
+#endif
+#ifndef MALHA_BATIMENTO_MS
+#define MALHA_BATIMENTO_MS 1000
+#endif
+#ifndef MALHA_REENVIO_MS
+#define MALHA_REENVIO_MS 10 // primeiro reenvio; dobra a cada tentativa
+#endif
+#ifndef MALHA_REENVIOS
+#define MALHA_REENVIOS 4 // 10 + 20 + 40 + 80 ms sem eco até desistir e esperar o batimento
+#endif
+#define MALHA_VIZINHO_EXPIRA_MS (3 * MALHA_BATIMENTO_MS)
+
+typedef enum {
+    MALHA_EVENTO = 1,
+    MALHA_BATIMENTO = 2,
+} malha_tipo_t;
+
+typedef struct {
+    uint8_t tipo;
+    uint8_t ttl;
+    uint8_t estado;     // 1 = alarme ativo
+    uint16_t remetente; // quem transmitiu este datagrama
+    uint16_t origem;    // quem mudou o estado
+    uint32_t relogio;   // Lamport da mudança; junto com a origem forma a versão
+} malha_msg_t;
+
+typedef struct {
+    uint16_t id;
+    uint32_t maior;  // maior relógio visto desta origem
+    uint32_t janela; // bit i: relógio maior - 1 - i já visto
+} malha_vistos_t;
+
+typedef struct {
+    uint16_t id;
+    uint32_t visto_ms;
+} malha_vizinho_t;
+
+typedef struct {
+    uint16_t id;
+    uint32_t relogio;
+    // Versão aplicada
+    uint32_t versao_relogio;
+    uint16_t versao_origem;
+    bool estado;
+    // Evento próprio aguardando eco
+    malha_msg_t pendente;
+    uint8_t reenvios;
+    uint32_t intervalo_ms;
+    uint32_t proximo_reenvio_ms;
+    uint32_t proximo_batimento_ms;
+    malha_vistos_t vistos[MALHA_MAX_NOS];
+    malha_vizinho_t vizinhos[MALHA_MAX_NOS];
+    uint32_t duplicados;
+    uint32_t reenviados;
+} malha_t;
+
+// Bits devolvidos por malha_receber
+#define MALHA_APLICAR 1u // estado e versao_origem mudaram
+#define MALHA_ENVIAR 2u  // *saida deve ser difundida
+
+size_t malha_codificar(const malha_msg_t *m, uint8_t buf[MALHA_MSG_TAM]);
+bool malha_decodificar(const uint8_t *buf, size_t len, malha_msg_t *m);
+
+// id != 0; o primeiro batimento sai na primeira chamada a malha_tick
+void malha_init(malha_t *n, uint16_t id, uint32_t agora_ms);
+
+// Mudança local do alarme: monta em *saida o evento a difundir já
+void malha_local(malha_t *n, bool estado, uint32_t agora_ms, malha_msg_t *saida);
+
+unsigned malha_receber(malha_t *n, const malha_msg_t *m, uint32_t agora_ms, malha_msg_t *saida);
+
+// Reenvio pendente ou batimento vencido em *saida (retorna true); *proximo_ms = próximo prazo
+bool malha_tick(malha_t *n, uint32_t agora_ms, malha_msg_t *saida, uint32_t *proximo_ms);
+
+int malha_num_vizinhos(const malha_t *n, uint32_t agora_ms);
+
+#endif
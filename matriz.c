@@ -0,0 +1,73 @@
+#include "hardware/pio.h"
+#include "hardware/dma.h"
+#include "hardware/pwm.h"
+#include "hardware/irq.h"
+#include "hardware/clocks.h"
+#include "bitdoglab.h"
+#include "matriz.h"
+#include "ws2812.pio.h"
+
+#define MATRIZ_FREQ_BITS 800000
+#define MATRIZ_PIO pio0
+
+static uint sm;
+static uint canal_dma;
+
+// Buffer duplo: o DMA lê um quadro enquanto o próximo é gerado no outro
+static uint32_t quadros[2][MATRIZ_NUM_LEDS];
+static uint8_t quadro_livre;
+static matriz_padrao_t padrao_atual;
+static uint32_t num_quadro;
+
+// Um quadro leva ~750 us no fio e o tick é de 50 ms, então o DMA anterior e o
+// reset de 280 us dos WS2812 já terminaram quando este roda
+static void matriz_enviar_proximo(void) {
+    if (dma_channel_is_busy(canal_dma)) return;
+    uint32_t *q = quadros[quadro_livre];
+    int animado = matriz_gerar_quadro(padrao_atual, num_quadro++, q);
+    dma_channel_transfer_from_buffer_now(canal_dma, q, MATRIZ_NUM_LEDS);
+    quadro_livre ^= 1;
+    if (!animado) pwm_set_enabled(MATRIZ_SLICE_TICK, false);
+}
+
+static void matriz_irq(void) {
+    if (!(pwm_get_irq_status_mask() & (1u << MATRIZ_SLICE_TICK))) return;
+    pwm_clear_irq(MATRIZ_SLICE_TICK);
+    matriz_enviar_proximo();
+}
+
+void matriz_iniciar(void) {
+    uint offset = pio_add_program(MATRIZ_PIO, &ws2812_program);
+    sm = pio_claim_unused_sm(MATRIZ_PIO, true);
+    ws2812_program_init(MATRIZ_PIO, sm, offset, MATRIZ_LED, MATRIZ_FREQ_BITS);
+
+    canal_dma = dma_claim_unused_channel(true);
+    dma_channel_config c = dma_channel_get_default_config(canal_dma);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pio_get_dreq(MATRIZ_PIO, sm, true));
+    dma_channel_configure(canal_dma, &c, &MATRIZ_PIO->txf[sm], NULL, MATRIZ_NUM_LEDS, false);
+
+    pwm_config t = pwm_get_default_config();
+    pwm_config_set_clkdiv(&t, 250.0f);
+    pwm_config_set_wrap(&t, clock_get_hz(clk_sys) / 250 / MATRIZ_QUADRO_HZ - 1);
+    pwm_init(MATRIZ_SLICE_TICK, &t, false);
+    pwm_clear_irq(MATRIZ_SLICE_TICK);
+    pwm_set_irq_enabled(MATRIZ_SLICE_TICK, true);
+    irq_add_shared_handler(PWM_IRQ_WRAP, matriz_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(PWM_IRQ_WRAP, true);
+
+    // Os WS2812 podem ligar com cores aleatórias
+    matriz_definir_padrao(MATRIZ_APAGADA);
+}
+
+// Chamada no core1 fora da interrupção; o primeiro quadro sai no próximo tick
+void matriz_definir_padrao(matriz_padrao_t padrao) {
+    pwm_set_enabled(MATRIZ_SLICE_TICK, false);
+    pwm_clear_irq(MATRIZ_SLICE_TICK);
+    padrao_atual = padrao;
+    num_quadro = 0;
+    pwm_set_counter(MATRIZ_SLICE_TICK, 0);
+    pwm_set_enabled(MATRIZ_SLICE_TICK, true);
+}
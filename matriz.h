@@ -0,0 +1,16 @@
+#ifndef MATRIZ_H
+#define MATRIZ_H
+
+#include "matriz_quadros.h"
+
+// Matriz WS2812 5x5 em PIO. Roda no core1: a interrupção de wrap de uma fatia PWM
+// dedicada gera o próximo quadro e o DMA o entrega ao PIO sem a CPU.
+
+#ifndef MATRIZ_SLICE_TICK
+#define MATRIZ_SLICE_TICK 2 // base de tempo; GPIO 4/5 da fatia não estão em função PWM
+#endif
+
+void matriz_iniciar(void);
+void matriz_definir_padrao(matriz_padrao_t padrao);
+
+#endif
@@ -0,0 +1,62 @@
+#include <string.h>
+#include "matriz_quadros.h"
+
+// Borda no sentido horário a partir do canto superior esquerdo
+static const uint8_t BORDA[][2] = {
+    {0, 0}, {1, 0}, {2, 0}, {3, 0}, {4, 0}, {4, 1}, {4, 2}, {4, 3},
+    {4, 4}, {3, 4}, {2, 4}, {1, 4}, {0, 4}, {0, 3}, {0, 2}, {0, 1},
+};
+#define NUM_BORDA (sizeof(BORDA) / sizeof(BORDA[0]))
+
+uint32_t ws2812_codificar(uint8_t r, uint8_t g, uint8_t b) {
+    return (uint32_t)g << 24 | (uint32_t)r << 16 | (uint32_t)b << 8;
+}
+
+// A cadeia começa no canto inferior direito e serpenteia linha a linha para cima
+int matriz_indice(int x, int y) {
+    int linha = MATRIZ_LADO - 1 - y;
+    int coluna = linha % 2 == 0 ? MATRIZ_LADO - 1 - x : x;
+    return linha * MATRIZ_LADO + coluna;
+}
+
+int matriz_gerar_quadro(matriz_padrao_t padrao, uint32_t n, uint32_t quadro[MATRIZ_NUM_LEDS]) {
+    memset(quadro, 0, MATRIZ_NUM_LEDS * sizeof(uint32_t));
+    switch (padrao) {
+        case MATRIZ_REPOUSO: {
+            // Triângulo de 2 s entre 1 e 1/8 do brilho máximo
+            uint32_t fase = n % (2 * MATRIZ_QUADRO_HZ);
+            uint32_t subida = fase < MATRIZ_QUADRO_HZ ? fase : 2 * MATRIZ_QUADRO_HZ - fase;
+            uint8_t g = 1 + subida * (MATRIZ_BRILHO_MAX / 8) / MATRIZ_QUADRO_HZ;
+            quadro[matriz_indice(2, 2)] = ws2812_codificar(0, g, 0);
+            return 1;
+        }
+        case MATRIZ_ESTROBO: {
+            uint32_t fase = n % MATRIZ_QUADRO_HZ;
+            if (fase == 0 || fase == 1 || fase == 4 || fase == 5) {
+                uint32_t vermelho = ws2812_codificar(MATRIZ_BRILHO_MAX, 0, 0);
+                for (int i = 0; i < MATRIZ_NUM_LEDS; i++) quadro[i] = vermelho;
+            }
+            return 1;
+        }
+        case MATRIZ_GIRO: {
+            // Cabeça no brilho máximo e dois pixels de rastro decrescente
+            for (int k = 0; k < 3; k++) {
+                const uint8_t *p = BORDA[(n + NUM_BORDA - k) % NUM_BORDA];
+                quadro[matriz_indice(p[0], p[1])] = ws2812_codificar(MATRIZ_BRILHO_MAX >> (2 * k), 0, 0);
+            }
+            quadro[matriz_indice(2, 2)] = ws2812_codificar(MATRIZ_BRILHO_MAX / 4, 0, 0);
+            return 1;
+        }
+        case MATRIZ_INICIANDO: {
+            // Estático: um quadro basta e o tick para durante o boot
+            uint32_t azul = ws2812_codificar(0, 0, MATRIZ_BRILHO_MAX / 4);
+            for (int k = 0; k < MATRIZ_LADO; k++) {
+                quadro[matriz_indice(k, 2)] = azul;
+                quadro[matriz_indice(2, k)] = azul;
+            }
+            return 0;
+        }
+        default:
+            return 0;
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef MATRIZ_QUADROS_H
+#define MATRIZ_QUADROS_H
+
+#include <stdint.h>
+
+// Geração dos quadros da matriz 5x5: só aritmética, sem SDK, para rodar também no host
+
+#define MATRIZ_LADO 5
+#define MATRIZ_NUM_LEDS (MATRIZ_LADO * MATRIZ_LADO)
+#define MATRIZ_QUADRO_HZ 20
+#ifndef MATRIZ_BRILHO_MAX
+#define MATRIZ_BRILHO_MAX 64 // os WS2812 ofuscam e puxam ~60 mA cada no branco máximo
+#endif
+
+typedef enum {
+    MATRIZ_APAGADA,
+    MATRIZ_REPOUSO,  // pixel central verde "respirando"
+    MATRIZ_ESTROBO,  // matriz inteira em flash duplo vermelho, 1 Hz
+    MATRIZ_GIRO,     // giroflex: rastro vermelho percorrendo a borda
+    MATRIZ_INICIANDO, // cruz azul fixa enquanto o Wi-Fi sobe
+    NUM_PADROES_MATRIZ
+} matriz_padrao_t;
+
+// Palavra de 24 bits alinhada à esquerda na ordem GRB, como o PIO desloca
+uint32_t ws2812_codificar(uint8_t r, uint8_t g, uint8_t b);
+
+// Posição na cadeia de LEDs para a coluna x e linha y (0,0 = canto superior esquerdo)
+int matriz_indice(int x, int y);
+
+// Preenche o quadro n do padrão; retorna 0 quando o padrão é estático a partir dele
+int matriz_gerar_quadro(matriz_padrao_t padrao, uint32_t n, uint32_t quadro[MATRIZ_NUM_LEDS]);
+
+#endif
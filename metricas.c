@@ -0,0 +1,100 @@
+#include "metricas.h"
+
+#if METRICAS_ATIVAS
+
+#include <stdio.h>
+#include "hardware/sync.h"
+#include "http_stream.h"
+
+static const char *const NOMES_CONTADORES[NUM_METRICAS_CONTADORES] = {
+    "alarme_ativacoes", "dhcp_discover", "dhcp_request", "dhcp_outros",
+    "dhcp_respostas", "dns_consultas", "dns_a", "dns_aaaa", "dns_outros", "dns_respostas", "display_bytes",
+};
+
+static const char *const NOMES_HIST[NUM_METRICAS_HIST] = {
+    "http_pagina_us", "http_api_state_us", "http_api_commands_us", "http_api_som_us",
+    "http_eventos_us", "http_ws_us", "http_metrics_us", "http_outra_us", "display_flush_us",
+    "http_estacoes_us", "http_diario_us", "http_api_temp_us", "http_rastros_us",
+};
+
+typedef struct {
+    uint32_t n;
+    uint32_t max_us;
+    uint64_t soma_us;
+    uint32_t baldes[METRICAS_BALDES];
+} metricas_hist_dados_t;
+
+// Uma cópia por núcleo: cada núcleo só escreve na sua, e dentro do núcleo as
+// interrupções ficam desabilitadas durante a escrita (o M0+ não tem RMW atômico).
+// A leitura soma as duas cópias e pode pegar um histograma no meio de uma atualização.
+typedef struct {
+    uint32_t contadores[NUM_METRICAS_CONTADORES];
+    metricas_hist_dados_t hist[NUM_METRICAS_HIST];
+} metricas_nucleo_t;
+
+static metricas_nucleo_t nucleos[2];
+
+void metricas_contar(metrica_contador_t c, uint32_t n) {
+    metricas_nucleo_t *m = &nucleos[get_core_num()];
+    uint32_t irq = save_and_disable_interrupts();
+    m->contadores[c] += n;
+    restore_interrupts(irq);
+}
+
+void metricas_registrar_us(metrica_hist_t h, uint64_t inicio_us) {
+    uint32_t us = (uint32_t)(time_us_64() - inicio_us);
+    uint32_t balde = us ? 32 - __builtin_clz(us) : 0;
+    if (balde >= METRICAS_BALDES) balde = METRICAS_BALDES - 1;
+
+    metricas_hist_dados_t *d = &nucleos[get_core_num()].hist[h];
+    uint32_t irq = save_and_disable_interrupts();
+    d->n++;
+    d->soma_us += us;
+    if (us > d->max_us) d->max_us = us;
+    d->baldes[balde]++;
+    restore_interrupts(irq);
+}
+
+uint32_t metricas_contador(metrica_contador_t c) {
+    return nucleos[0].contadores[c] + nucleos[1].contadores[c];
+}
+
+void metricas_hist_resumo(metrica_hist_t h, uint32_t *n, uint32_t *max_us) {
+    const metricas_hist_dados_t *a = &nucleos[0].hist[h], *b = &nucleos[1].hist[h];
+    *n = a->n + b->n;
+    *max_us = a->max_us > b->max_us ? a->max_us : b->max_us;
+}
+
+// Uma linha por métrica: "nome valor" para contadores e
+// "nome n soma max i:contagem..." (só baldes não vazios) para histogramas
+int metricas_formatar_linha(uint16_t indice, char *linha, int max) {
+    if (indice < NUM_METRICAS_CONTADORES) {
+        uint32_t v = nucleos[0].contadores[indice] + nucleos[1].contadores[indice];
+        return snprintf(linha, max, "%s %lu\n", NOMES_CONTADORES[indice], (unsigned long)v);
+    }
+    indice -= NUM_METRICAS_CONTADORES;
+    if (indice >= NUM_METRICAS_HIST) return 0;
+
+    const metricas_hist_dados_t *a = &nucleos[0].hist[indice], *b = &nucleos[1].hist[indice];
+    uint32_t max_us = a->max_us > b->max_us ? a->max_us : b->max_us;
+    int len = snprintf(linha, max, "%s %lu %llu %lu", NOMES_HIST[indice], (unsigned long)(a->n + b->n),
+                       (unsigned long long)(a->soma_us + b->soma_us), (unsigned long)max_us);
+    for (int i = 0; i < METRICAS_BALDES && len < max; i++) {
+        uint32_t c = a->baldes[i] + b->baldes[i];
+        if (c) len += snprintf(linha + len, max - len, " %d:%lu", i, (unsigned long)c);
+    }
+    if (len < max - 1) {
+        linha[len++] = '\n';
+        linha[len] = 0;
+    }
+    return len < max ? len : max - 1;
+}
+
+void metricas_imprimir(void) {
+    char linha[HTTP_LINHA_MAX];
+    for (uint16_t i = 0; metricas_formatar_linha(i, linha, sizeof(linha)) > 0; i++) {
+        fputs(linha, stdout);
+    }
+}
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef METRICAS_H
+#define METRICAS_H
+
+#include <stdint.h>
+#include "pico/stdlib.h"
+
+// Contadores e histogramas log2 de baixo custo. Com METRICAS_ATIVAS=0 as macros
+// viram nada e nem o módulo nem a rota /metrics entram no binário.
+
+#ifndef METRICAS_ATIVAS
+#define METRICAS_ATIVAS 1
+#endif
+
+#define METRICAS_BALDES 20 // balde i: duração em [2^(i-1), 2^i) us; o último acumula o resto
+
+typedef enum {
+    MC_ALARME_ATIVACOES,
+    MC_DHCP_DISCOVER,
+    MC_DHCP_REQUEST,
+    MC_DHCP_OUTROS,
+    MC_DHCP_RESPOSTAS,
+    MC_DNS_CONSULTAS,
+    MC_DNS_A,
+    MC_DNS_AAAA,
+    MC_DNS_OUTROS,
+    MC_DNS_RESPOSTAS,
+    MC_DISPLAY_BYTES,
+    NUM_METRICAS_CONTADORES
+} metrica_contador_t;
+
+typedef enum {
+    MH_HTTP_PAGINA,
+    MH_HTTP_API_STATE,
+    MH_HTTP_API_COMMANDS,
+    MH_HTTP_API_SOM,
+    MH_HTTP_EVENTOS,
+    MH_HTTP_WS,
+    MH_HTTP_METRICS,
+    MH_HTTP_OUTRA,
+    MH_DISPLAY_FLUSH,
+    // Rotas de diagnóstico por último: a resposta METRICAS da serial leva só os primeiros
+    // histogramas que cabem num quadro
+    MH_HTTP_ESTACOES,
+    MH_HTTP_DIARIO,
+    MH_HTTP_API_TEMP,
+    MH_HTTP_RASTROS,
+    NUM_METRICAS_HIST
+} metrica_hist_t;
+
+#if METRICAS_ATIVAS
+
+void metricas_contar(metrica_contador_t c, uint32_t n);
+void metricas_registrar_us(metrica_hist_t h, uint64_t inicio_us);
+
+// Uma linha por métrica (http_linha_fn); retorna 0 depois da última
+int metricas_formatar_linha(uint16_t indice, char *linha, int max);
+void metricas_imprimir(void);
+
+// Instantâneo somando os dois núcleos, para quem exporta em binário
+uint32_t metricas_contador(metrica_contador_t c);
+void metricas_hist_resumo(metrica_hist_t h, uint32_t *n, uint32_t *max_us);
+
+#define METRICA_CONTAR(c) metricas_contar((c), 1)
+#define METRICA_SOMAR(c, n) metricas_contar((c), (n))
+#define METRICA_INICIO(var) uint64_t var = time_us_64()
+#define METRICA_REGISTRAR(h, var) metricas_registrar_us((h), (var))
+
+#else
+
+#define METRICA_CONTAR(c) ((void)0)
+#define METRICA_SOMAR(c, n) ((void)0)
+#define METRICA_INICIO(var)
+#define METRICA_REGISTRAR(h, var) ((void)(h))
+
+#endif
+
+#endif
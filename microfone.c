@@ -0,0 +1,111 @@
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "bitdoglab.h"
+#include "microfone.h"
+
+#define ADC_CLOCK_HZ 48000000
+#define ADC_TEMPERATURA 4
+
+// Round-robin entre MICROFONE_ADC e o sensor: índices pares são do microfone, ímpares do sensor
+static uint16_t blocos[2][2 * SOM_BLOCO];
+static uint16_t amostras_som[SOM_BLOCO];
+static uint canal[2];
+static volatile uint32_t blocos_prontos; // incrementado pela IRQ; o bit 0 diz qual bloco fechou por último
+static uint32_t blocos_analisados;
+
+static async_context_t *ctx;
+static async_when_pending_worker_t worker;
+static void (*disparar_alarme)(void);
+static microfone_temperatura_fn temperatura_fn;
+static som_detector_t detector;
+static microfone_stats_t stats;
+
+// A IRQ só rearma o endereço do canal que terminou e acorda o worker
+static void microfone_irq(void) {
+    for (int i = 0; i < 2; i++) {
+        if (!dma_channel_get_irq1_status(canal[i])) continue;
+        dma_channel_acknowledge_irq1(canal[i]);
+        dma_channel_set_write_addr(canal[i], blocos[i], false);
+        blocos_prontos++;
+        async_context_set_work_pending(ctx, &worker);
+    }
+}
+
+static void microfone_worker_fn(async_context_t *context, async_when_pending_worker_t *w) {
+    uint32_t prontos = blocos_prontos;
+    if (prontos == blocos_analisados) return;
+    // Com atraso maior que um bloco, o mais antigo já foi sobrescrito pelo DMA
+    if (prontos - blocos_analisados > 1) stats.perdidos += prontos - blocos_analisados - 1;
+    blocos_analisados = prontos;
+
+    // Os canais alternam a partir do bloco 0, então o bloco fechado é (prontos - 1) % 2
+    const uint16_t *bloco = blocos[(prontos - 1) & 1];
+    uint32_t soma_temperatura = 0;
+    for (int i = 0; i < SOM_BLOCO; i++) {
+        amostras_som[i] = bloco[2 * i];
+        soma_temperatura += bloco[2 * i + 1];
+    }
+    if (temperatura_fn) temperatura_fn(soma_temperatura, SOM_BLOCO);
+
+    som_bloco_t b = som_analisar_bloco(amostras_som, SOM_BLOCO);
+    stats.ultimo = b;
+    stats.blocos++;
+    if (b.rms > stats.rms_max) stats.rms_max = b.rms;
+    if (som_detector_atualizar(&detector, b.rms)) {
+        stats.disparos++;
+        if (disparar_alarme) disparar_alarme();
+    }
+}
+
+void microfone_configurar(uint16_t limiar_rms, uint16_t sustentado_ms) {
+    uint32_t blocos_necessarios = (uint32_t)sustentado_ms * SOM_TAXA_HZ / SOM_BLOCO / 1000;
+    som_detector_init(&detector, limiar_rms, blocos_necessarios);
+    stats.limiar_rms = limiar_rms;
+    stats.sustentado_ms = sustentado_ms;
+}
+
+void microfone_iniciar(async_context_t *context, void (*disparar)(void)) {
+    ctx = context;
+    disparar_alarme = disparar;
+    microfone_configurar(SOM_LIMIAR_RMS, SOM_SUSTENTADO_MS);
+    worker.do_work = microfone_worker_fn;
+    async_context_add_when_pending_worker(ctx, &worker);
+
+    adc_gpio_init(MICROFONE);
+    adc_init();
+    adc_set_temp_sensor_enabled(true);
+    adc_select_input(MICROFONE_ADC);
+    adc_set_round_robin(1u << MICROFONE_ADC | 1u << ADC_TEMPERATURA);
+    adc_fifo_setup(true, true, 1, false, false);
+    adc_set_clkdiv(ADC_CLOCK_HZ / (2 * SOM_TAXA_HZ) - 1); // duas entradas, SOM_TAXA_HZ cada
+
+    // Dois canais encadeados em anel: enquanto um enche seu bloco, o outro espera a análise
+    canal[0] = dma_claim_unused_channel(true);
+    canal[1] = dma_claim_unused_channel(true);
+    for (int i = 0; i < 2; i++) {
+        dma_channel_config c = dma_channel_get_default_config(canal[i]);
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+        channel_config_set_read_increment(&c, false);
+        channel_config_set_write_increment(&c, true);
+        channel_config_set_dreq(&c, DREQ_ADC);
+        channel_config_set_chain_to(&c, canal[1 - i]);
+        dma_channel_configure(canal[i], &c, blocos[i], &adc_hw->fifo, 2 * SOM_BLOCO, false);
+        dma_channel_set_irq1_enabled(canal[i], true);
+    }
+    irq_add_shared_handler(DMA_IRQ_1, microfone_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_1, true);
+
+    dma_channel_start(canal[0]);
+    adc_run(true);
+}
+
+void microfone_stats(microfone_stats_t *s, bool zerar_max) {
+    *s = stats;
+    if (zerar_max) stats.rms_max = 0;
+}
+
+void microfone_observar_temperatura(microfone_temperatura_fn fn) {
+    temperatura_fn = fn;
+}
@@ -0,0 +1,49 @@
+#ifndef MICROFONE_H
+#define MICROFONE_H
+
+#include <stdint.h>
+#include "pico/async_context.h"
+#include "som.h"
+
+// Amostragem contínua do microfone: ADC em modo livre, DMA em dois blocos encadeados
+// e análise de cada bloco completo num worker do async_context. O ADC intercala o sensor
+// interno de temperatura, e as leituras dele saem no mesmo bloco.
+
+#ifndef SOM_TAXA_HZ
+#define SOM_TAXA_HZ 8000
+#endif
+#define SOM_BLOCO 256 // 32 ms a 8 kHz
+#ifndef SOM_LIMIAR_RMS
+#define SOM_LIMIAR_RMS 400 // contagens do ADC; grito ou sirene próxima ao microfone
+#endif
+#ifndef SOM_SUSTENTADO_MS
+#define SOM_SUSTENTADO_MS 1500
+#endif
+// Faixas aceitas em ?som_limiar= e ?som_ms=
+#define SOM_LIMIAR_MAX_RMS 2048                                 // o RMS AC de 12 bits não passa de meia escala
+#define SOM_SUSTENTADO_MIN_MS (SOM_BLOCO * 1000 / SOM_TAXA_HZ) // um bloco
+#define SOM_SUSTENTADO_MAX_MS 60000
+
+typedef struct {
+    som_bloco_t ultimo;
+    uint16_t rms_max;   // maior RMS desde a última leitura por HTTP
+    uint16_t limiar_rms;
+    uint16_t sustentado_ms;
+    uint32_t blocos;
+    uint32_t perdidos;  // blocos sobrescritos antes da análise
+    uint32_t disparos;
+} microfone_stats_t;
+
+// disparar é chamado no contexto do async_context quando o nível sustentado é atingido
+void microfone_iniciar(async_context_t *context, void (*disparar)(void));
+void microfone_configurar(uint16_t limiar_rms, uint16_t sustentado_ms);
+
+// Copia as estatísticas; zerar_max reinicia o RMS máximo observado
+void microfone_stats(microfone_stats_t *s, bool zerar_max);
+
+// O ADC alterna entre o microfone e o sensor de temperatura (entrada 4); a cada bloco, fn
+// recebe a soma das n leituras do sensor, no contexto do async_context
+typedef void (*microfone_temperatura_fn)(uint32_t soma, uint32_t n);
+void microfone_observar_temperatura(microfone_temperatura_fn fn);
+
+#endif
@@ -1,4 +1,8 @@
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
 #include <string.h>
+#include <strings.h>
 #include <stdio.h>
 #include "pico/stdlib.h"
 #include "pico/cyw43_arch.h"
@@ -6,144 +10,449 @@
 #include "lwip/tcp.h"
 #include "dhcpserver.h"
 #include "dnsserver.h"
-#include "hardware/i2c.h"
-#include "ssd1306.h"
+#include "bitdoglab.h"
+#include "core1_worker.h"
+#include "alarme.h"
+#include "microfone.h"
+#include "temperatura.h"
+#include "botoes.h"
+#include "metricas.h"
+#include "boot_fases.h"
+#include "malha.h"
+#include "estacoes.h"
+#include "diario.h"
+#include "rastro.h"
+#include "serial_controle.h"
+#include "lwip_telemetria.h"
+#include "sse.h"
+#include "ws_server.h"
+#include "json_writer.h"
+#include "http_stream.h"
 #include "pico/time.h"
 
 #define TCP_PORT 80
 #define POLL_TIME_S 5
 #define HTTP_GET "GET"
 #define HTTP_RESPONSE_HEADERS "HTTP/1.1 200 OK\nContent-Length: %d\nContent-Type: text/html\nConnection: close\n\n"
+#define HTTP_RESPONSE_HEADERS_STREAM "HTTP/1.1 200 OK\nContent-Type: %s\nConnection: close\n\n"
 #define HTTP_RESPONSE_REDIRECT "HTTP/1.1 302 Found\nLocation: http://%s/bitdoglabtest\n\n"
-
-#define LED_RED 13
-#define LED_GREEN 11
-#define LED_BLUE 12
-#define BUZZER 10
-
-const uint I2C_SDA = 14;
-const uint I2C_SCL = 15;
-uint8_t ssd[ssd1306_buffer_length];
-struct render_area frame_area;
-
-// Flags e timer do alarme
-volatile bool alarme_ativo = false;
-volatile bool estado_alarme = false;
-repeating_timer_t alarme_timer;
+#define HTTP_RESPONSE_JSON "HTTP/1.1 %s\nContent-Type: application/json\nContent-Length: %d\nConnection: close\n\n"
+#define API_MAX_CORPO 256
+#define API_MAX_REQUISICAO 1024 // cabeçalhos + corpo retidos enquanto um POST chega em partes
+#define HTTP_TAMANHO_DESCONHECIDO -1
+
+// Controle de admissão: limites podem ser sobrescritos via target_compile_definitions
+#ifndef HTTP_MAX_CONEXOES
+#define HTTP_MAX_CONEXOES 4         // conexões simultâneas atendidas
+#endif
+#ifndef HTTP_TAXA_MAX_REQ
+#define HTTP_TAXA_MAX_REQ 8         // requisições por IP dentro da janela
+#endif
+#ifndef HTTP_TAXA_JANELA_MS
+#define HTTP_TAXA_JANELA_MS 2000
+#endif
+#ifndef HTTP_TAXA_MAX_CLIENTES
+#define HTTP_TAXA_MAX_CLIENTES 8    // IPs acompanhados simultaneamente
+#endif
+
+// Resposta pronta em flash: enviada sem cópia e sem alocar estado de conexão
+static const char HTTP_RESPONSE_503[] =
+    "HTTP/1.1 503 Service Unavailable\nRetry-After: 2\nContent-Length: 0\nConnection: close\n\n";
+// /ws sem os cabeçalhos de upgrade (RFC 6455 §4.2.1) ou com outra versão do protocolo
+static const char HTTP_RESPONSE_WS_400[] =
+    "HTTP/1.1 400 Bad Request\nContent-Length: 0\nConnection: close\n\n";
+static const char HTTP_RESPONSE_WS_426[] =
+    "HTTP/1.1 426 Upgrade Required\nSec-WebSocket-Version: 13\nContent-Length: 0\nConnection: close\n\n";
+
+#define LACO_ESPERA_MAX_MS 1000 // teto de sono do laço principal sem trabalho pendente
+
+// Instrumentação do laço principal
+static uint32_t laco_iteracoes;
+
+typedef struct {
+    uint32_t ip;
+    uint32_t inicio_janela_ms;
+    uint16_t requisicoes;
+} HTTP_TAXA_CLIENTE_T;
 
 typedef struct TCP_SERVER_T_ {
     struct tcp_pcb *server_pcb;
     bool complete;
     ip_addr_t gw;
+    int conexoes_ativas;
+    uint32_t rejeitadas_conexao;
+    uint32_t rejeitadas_taxa;
+    HTTP_TAXA_CLIENTE_T taxa[HTTP_TAXA_MAX_CLIENTES];
 } TCP_SERVER_T;
 
 typedef struct TCP_CONNECT_STATE_T_ {
     struct tcp_pcb *pcb;
-    int sent_len;
     char headers[128];
-    char result[1024];
     int header_len;
-    int result_len;
+    uint32_t confirmado_no_poll;
+    http_stream_t corpo;
+    http_linhas_t linhas; // relatórios em texto (/metrics, /lwip)
+    diario_cursor_t diario;
+    const char *tipo_corpo; // Content-Type das respostas de tamanho desconhecido
+    struct pbuf *requisicao; // POST da API ainda sem o corpo inteiro; os próximos segmentos são encadeados
     ip_addr_t *gw;
+    TCP_SERVER_T *server;
 } TCP_CONNECT_STATE_T;
 
-void ssd1306_draw_string_scaled(uint8_t *buffer, int x, int y, const char *text, int scale) {
-    while (*text) {
-        for (int dx = 0; dx < scale; dx++) {
-            for (int dy = 0; dy < scale; dy++) {
-                ssd1306_draw_char(buffer, x + dx, y + dy, *text);
-            }
-        }
-        x += 6 * scale;
-        text++;
-    }
+// Desenho e I2C ficam no core1; aqui só se escolhe a tela
+void solicitar_display() {
+    RASTRO_INICIO(RP_DISPLAY);
+    core1_mostrar_tela(alarme_esta_ativo() ? TELA_EVACUAR : TELA_REPOUSO);
+    RASTRO_FIM(RP_DISPLAY);
 }
 
-void atualizar_display() {
-    
-    memset(ssd, 0, ssd1306_buffer_length);
-    ssd1306_draw_string_scaled(ssd, 0, 0, "IIIIIIIIIIIIIIIIIIIIIIIIIII", 1);
-    ssd1306_draw_string_scaled(ssd, 20, 20, "SISTEMA", 2);
-    ssd1306_draw_string_scaled(ssd, 50, 35, "EM", 2);
-    ssd1306_draw_string_scaled(ssd, 20, 50, "REPOUSO", 2);
-    
+// O padrão de piscar/tocar roda como worker do async_context (ver alarme.c)
+void ativar_alarme() {
+    alarme_ativar();
+}
 
-    render_on_display(ssd, &frame_area);
+static void formatar_cor(char hex[7]) {
+    rgb_cor_t cor = core1_cor();
+    snprintf(hex, 7, "%02x%02x%02x", cor.r, cor.g, cor.b);
 }
 
-bool alarme_callback(repeating_timer_t *rt) {
-    if (!alarme_ativo) {
-        gpio_put(LED_RED, 0);
-        gpio_put(BUZZER, 0);
-        return false;
+int gerar_estado_json(char *buf, size_t max_len) {
+    char cor[7];
+    formatar_cor(cor);
+    return snprintf(buf, max_len, "{\"alarme\":%d,\"padrao\":\"%s\",\"tom\":\"%s\",\"cor\":\"%s\",\"red\":%d,\"green\":%d,\"blue\":%d,\"buzzer\":%d}",
+        alarme_esta_ativo(), alarme_nome_padrao(alarme_padrao()), sirene_nome_tom(alarme_tom()), cor, core1_saida(LED_RED), core1_saida(LED_GREEN), core1_saida(LED_BLUE), core1_saida(BUZZER));
+}
+
+// Empurra o estado atual para os assinantes de /eventos (duplicatas são descartadas)
+void notificar_estado() {
+    char dados[144];
+    gerar_estado_json(dados, sizeof(dados));
+    sse_publicar("estado", dados);
+}
+
+// Mudança vinda de outra placa: a origem já foi para o display e não volta para a malha
+static void aplicar_alarme_da_malha(bool ativo) {
+    if (ativo) ativar_alarme();
+    else alarme_desativar();
+    solicitar_display();
+    notificar_estado();
+}
+
+// Atuadores controláveis por GET, WebSocket e /api/commands
+typedef enum {
+    ATUADOR_RED,
+    ATUADOR_GREEN,
+    ATUADOR_BLUE,
+    ATUADOR_BUZZER,
+    ATUADOR_ALARME,
+    NUM_ATUADORES
+} atuador_t;
+
+static const char *const NOMES_ATUADORES[NUM_ATUADORES] = {"red", "green", "blue", "buzzer", "alarme"};
+
+// Aplica um lote de comandos (-1 = sem alteração) com uma única atualização de display e de eventos;
+// a fonte vai para o diário junto com a mudança do alarme
+void aplicar_comandos(const int8_t valores[NUM_ATUADORES], diario_fonte_t fonte) {
+    bool antes = alarme_esta_ativo();
+    if (valores[ATUADOR_RED] >= 0) core1_definir_saida(LED_RED, valores[ATUADOR_RED]);
+    if (valores[ATUADOR_GREEN] >= 0) core1_definir_saida(LED_GREEN, valores[ATUADOR_GREEN]);
+    if (valores[ATUADOR_BLUE] >= 0) core1_definir_saida(LED_BLUE, valores[ATUADOR_BLUE]);
+    if (valores[ATUADOR_BUZZER] >= 0) core1_definir_saida(BUZZER, valores[ATUADOR_BUZZER]);
+
+    if (valores[ATUADOR_ALARME] == 1) {
+        ativar_alarme();
+    } else if (valores[ATUADOR_ALARME] == 0) {
+        alarme_desativar();
+    }
+    if (alarme_esta_ativo() != antes) {
+        diario_registrar(antes ? DIARIO_ALARME_DESLIGADO : DIARIO_ALARME_LIGADO, fonte, 0, 0);
     }
 
-    estado_alarme = !estado_alarme;
-    gpio_put(LED_RED, estado_alarme);
-    gpio_put(BUZZER, estado_alarme);
+    solicitar_display();
+    notificar_estado();
+}
 
-    memset(ssd, 0, ssd1306_buffer_length);
-    ssd1306_draw_string_scaled(ssd, 20, 30, "EVACUAR", 2);
-    render_on_display(ssd, &frame_area);
+// Inteiro decimal logo após chave, até '&', ' ' ou o fim, dentro de [min, max].
+// Lixo, sinal, estouro ou valor fora da faixa contam como ausente.
+static bool param_inteiro(const char *params, const char *chave, long min, long max, long *valor) {
+    const char *v = strstr(params, chave);
+    if (!v) return false;
+    v += strlen(chave);
+    if (!isdigit((unsigned char)*v)) return false;
+    char *fim;
+    errno = 0;
+    long n = strtol(v, &fim, 10);
+    if (errno == ERANGE || (*fim && *fim != '&' && *fim != ' ')) return false;
+    if (n < min || n > max) return false;
+    *valor = n;
+    return true;
+}
 
+// padrao=sirene|pulso|sos, periodo=<ms por unidade> e tom=<nome>, aplicados antes de ativar o alarme.
+// Um periodo inválido ou fora de [ALARME_UNIDADE_MIN_MS, ALARME_UNIDADE_MAX_MS] descarta os três.
+// Os parse_* retornam se encontraram o que aplicar.
+static bool parse_padrao(const char *params) {
+    long unidade = 0;
+    if (strstr(params, "periodo=") &&
+        !param_inteiro(params, "periodo=", ALARME_UNIDADE_MIN_MS, ALARME_UNIDADE_MAX_MS, &unidade)) {
+        return false;
+    }
+    const char *t = strstr(params, "tom=");
+    if (t) {
+        t += 4;
+        alarme_definir_tom(sirene_tom_por_nome(t, strcspn(t, "& ")));
+    }
+    const char *v = strstr(params, "padrao=");
+    if (!v) return t != NULL;
+    v += 7;
+    int len = strcspn(v, "& ");
+    alarme_padrao_t padrao = alarme_padrao_por_nome(v, len);
+    if (padrao == NUM_PADROES_ALARME) return t != NULL;
+    alarme_definir_padrao(padrao, unidade);
     return true;
 }
 
-void ativar_alarme() {
-    if (!alarme_ativo) {
-        alarme_ativo = true;
-        add_repeating_timer_ms(500, alarme_callback, NULL, &alarme_timer);
+// cor=RRGGBB (aceita '#' ou %23 antes), com fade=<ms> ou pulsar=<ms> opcionais. O fade vai
+// até LED_RGB_MAX_MS e o pulsar até o dobro (a rampa cobre meio ciclo); cor que não seja
+// exatamente seis dígitos hexadecimais ou duração inválida recusam o comando.
+static bool parse_cor(const char *params) {
+    const char *v = strstr(params, "cor=");
+    if (!v) return false;
+    v += 4;
+    if (*v == '#') v++;
+    else if (strncmp(v, "%23", 3) == 0) v += 3;
+    for (int i = 0; i < 6; i++) {
+        if (!isxdigit((unsigned char)v[i])) return false;
     }
+    if (v[6] && v[6] != '&' && v[6] != ' ') return false;
+    uint32_t rgb = strtoul(v, NULL, 16);
+
+    rgb_cor_t cor = {rgb >> 16, rgb >> 8, rgb};
+    rgb_efeito_t efeito = RGB_FIXO;
+    long duracao = 0;
+    if (strstr(params, "fade=")) {
+        efeito = RGB_FADE;
+        if (!param_inteiro(params, "fade=", 0, LED_RGB_MAX_MS, &duracao)) return false;
+    } else if (strstr(params, "pulsar=")) {
+        efeito = RGB_PULSAR;
+        if (!param_inteiro(params, "pulsar=", 0, 2 * LED_RGB_MAX_MS, &duracao)) return false;
+    }
+    core1_definir_cor(cor, efeito, duracao);
+    return true;
 }
 
-void init_leds() {
-    gpio_init(LED_RED);   gpio_set_dir(LED_RED, GPIO_OUT);   gpio_put(LED_RED, 0);
-    gpio_init(LED_GREEN); gpio_set_dir(LED_GREEN, GPIO_OUT); gpio_put(LED_GREEN, 0);
-    gpio_init(LED_BLUE);  gpio_set_dir(LED_BLUE, GPIO_OUT);  gpio_put(LED_BLUE, 0);
-    gpio_init(BUZZER);    gpio_set_dir(BUZZER, GPIO_OUT);    gpio_put(BUZZER, 0);
+// som_limiar=<rms> e som_ms=<ms> ajustam o disparo automático pelo microfone; um valor
+// inválido descarta os dois
+static bool parse_som(const char *params) {
+    bool tem_limiar = strstr(params, "som_limiar=") != NULL;
+    bool tem_ms = strstr(params, "som_ms=") != NULL;
+    if (!tem_limiar && !tem_ms) return false;
+    microfone_stats_t s;
+    microfone_stats(&s, false);
+    long limiar = s.limiar_rms, ms = s.sustentado_ms;
+    if (tem_limiar && !param_inteiro(params, "som_limiar=", 1, SOM_LIMIAR_MAX_RMS, &limiar)) return false;
+    if (tem_ms && !param_inteiro(params, "som_ms=", SOM_SUSTENTADO_MIN_MS, SOM_SUSTENTADO_MAX_MS, &ms)) return false;
+    microfone_configurar(limiar, ms);
+    return true;
 }
 
-void parse_params(const char *params) {
-    int r, g, b;
-    if (sscanf(params, "red=%d&green=%d&blue=%d", &r, &g, &b) == 3) {
-        gpio_put(LED_RED, r);
-        gpio_put(LED_GREEN, g);
-        gpio_put(LED_BLUE, b);
+// temp_limiar=<°C> ajusta o disparo por superaquecimento; graus inteiros, levados para
+// [TEMP_LIMIAR_MIN_MC, TEMP_LIMIAR_MAX_MC]
+static bool parse_temperatura(const char *params) {
+    long graus;
+    if (!param_inteiro(params, "temp_limiar=", 0, LONG_MAX, &graus)) return false;
+    if (graus < TEMP_LIMIAR_MIN_MC / 1000) graus = TEMP_LIMIAR_MIN_MC / 1000;
+    if (graus > TEMP_LIMIAR_MAX_MC / 1000) graus = TEMP_LIMIAR_MAX_MC / 1000;
+    temperatura_configurar(graus * 1000);
+    return true;
+}
+
+// Disparo pelo microfone: mesmo caminho de um comando alarme=1 vindo da rede
+static void disparar_por_som(void) {
+    int8_t valores[NUM_ATUADORES];
+    memset(valores, -1, sizeof(valores));
+    valores[ATUADOR_ALARME] = 1;
+    aplicar_comandos(valores, DIARIO_FONTE_SOM);
+}
+
+// Média da temperatura acima do limiar: idem
+static void disparar_por_temperatura(void) {
+    int8_t valores[NUM_ATUADORES];
+    memset(valores, -1, sizeof(valores));
+    valores[ATUADOR_ALARME] = 1;
+    aplicar_comandos(valores, DIARIO_FONTE_TEMPERATURA);
+}
+
+// Botões locais: A duplo ou longo aciona, B longo silencia, B clique troca o padrão
+static void tratar_botao(uint pino, botao_gesto_t gesto) {
+    int8_t valores[NUM_ATUADORES];
+    memset(valores, -1, sizeof(valores));
+    if (pino == BOTAO_A && (gesto == GESTO_DUPLO || gesto == GESTO_LONGO)) {
+        valores[ATUADOR_ALARME] = 1;
+    } else if (pino == BOTAO_B && gesto == GESTO_LONGO) {
+        valores[ATUADOR_ALARME] = 0;
+    } else if (pino == BOTAO_B && gesto == GESTO_CLIQUE) {
+        alarme_definir_padrao((alarme_padrao() + 1) % NUM_PADROES_ALARME, 0);
     } else {
-        if (strstr(params, "red=1")) gpio_put(LED_RED, 1);
-        if (strstr(params, "red=0")) gpio_put(LED_RED, 0);
-        if (strstr(params, "green=1")) gpio_put(LED_GREEN, 1);
-        if (strstr(params, "green=0")) gpio_put(LED_GREEN, 0);
-        if (strstr(params, "blue=1")) gpio_put(LED_BLUE, 1);
-        if (strstr(params, "blue=0")) gpio_put(LED_BLUE, 0);
+        return;
     }
+    aplicar_comandos(valores, DIARIO_FONTE_BOTAO);
+}
 
-    if (strstr(params, "buzzer=1")) gpio_put(BUZZER, 1);
-    if (strstr(params, "buzzer=0")) gpio_put(BUZZER, 0);
+// Retorna se algum parâmetro foi reconhecido
+static bool aplicar_params(const char *params, diario_fonte_t fonte) {
+    RASTRO_INICIO(RP_PARSE_PARAMS);
+    int8_t valores[NUM_ATUADORES];
+    bool reconhecido = parse_padrao(params);
+    reconhecido |= parse_cor(params);
+    reconhecido |= parse_som(params);
+    reconhecido |= parse_temperatura(params);
+    for (int i = 0; i < NUM_ATUADORES; i++) {
+        char chave[12];
+        int len = snprintf(chave, sizeof(chave), "%s=", NOMES_ATUADORES[i]);
+        const char *v = strstr(params, chave);
+        valores[i] = !v ? -1 : v[len] == '1' ? 1 : v[len] == '0' ? 0 : -1;
+        if (valores[i] >= 0) reconhecido = true;
+    }
+    aplicar_comandos(valores, fonte);
+    RASTRO_FIM(RP_PARSE_PARAMS);
+    return reconhecido;
+}
 
-    if (strstr(params, "alarme=1")) {
-        ativar_alarme();
-    } else if (strstr(params, "alarme=0")) {
-        alarme_ativo = false;
-        gpio_put(LED_RED, 0);
-        gpio_put(BUZZER, 0);
-        atualizar_display();
+void parse_params(const char *params) {
+    aplicar_params(params, DIARIO_FONTE_HTTP);
+}
+
+static bool comando_ws(const char *comando) {
+    return aplicar_params(comando, DIARIO_FONTE_WS);
+}
+
+// Lote binário da serial: os atuadores de serial_quadro.h seguem a ordem de NOMES_ATUADORES
+static void comandos_serial(const int8_t valores[SERIAL_NUM_ATUADORES]) {
+    aplicar_comandos(valores, DIARIO_FONTE_SERIAL);
+}
+
+static const char *pular_espacos(const char *c) {
+    while (*c == ' ' || *c == '\t' || *c == '\r' || *c == '\n') c++;
+    return c;
+}
+
+// Lê um objeto plano {"red":1,"buzzer":0,...}; retorna NULL ou a mensagem de erro
+static const char *api_ler_comandos(const char *c, int8_t valores[NUM_ATUADORES]) {
+    c = pular_espacos(c);
+    if (*c++ != '{') return "esperado objeto";
+    c = pular_espacos(c);
+    if (*c == '}') return "lote vazio";
+    while (true) {
+        if (*c++ != '"') return "esperado nome";
+        const char *nome = c;
+        while (*c && *c != '"') c++;
+        if (*c != '"') return "nome incompleto";
+        size_t nome_len = c++ - nome;
+        int atuador = -1;
+        for (int i = 0; i < NUM_ATUADORES; i++) {
+            if (strlen(NOMES_ATUADORES[i]) == nome_len && strncmp(nome, NOMES_ATUADORES[i], nome_len) == 0) atuador = i;
+        }
+        if (atuador < 0) return "atuador desconhecido";
+        c = pular_espacos(c);
+        if (*c++ != ':') return "esperado ':'";
+        c = pular_espacos(c);
+        if (*c == '0' || *c == '1') {
+            valores[atuador] = *c++ - '0';
+        } else if (strncmp(c, "true", 4) == 0) {
+            valores[atuador] = 1;
+            c += 4;
+        } else if (strncmp(c, "false", 5) == 0) {
+            valores[atuador] = 0;
+            c += 5;
+        } else {
+            return "valor deve ser 0 ou 1";
+        }
+        c = pular_espacos(c);
+        if (*c == '}') return NULL;
+        if (*c++ != ',') return "esperado ','";
+        c = pular_espacos(c);
     }
+}
 
-    atualizar_display();
+static void api_escrever_estado(json_writer_t *w, const void *ctx) {
+    json_abrir_objeto(w);
+    json_campo_int(w, "alarme", alarme_esta_ativo());
+    json_campo_str(w, "padrao", alarme_nome_padrao(alarme_padrao()));
+    json_campo_str(w, "tom", sirene_nome_tom(alarme_tom()));
+    char cor[7];
+    formatar_cor(cor);
+    json_campo_str(w, "cor", cor);
+    json_campo_int(w, "red", core1_saida(LED_RED));
+    json_campo_int(w, "green", core1_saida(LED_GREEN));
+    json_campo_int(w, "blue", core1_saida(LED_BLUE));
+    json_campo_int(w, "buzzer", core1_saida(BUZZER));
+    json_fechar_objeto(w);
 }
 
-int generate_html(char *result, size_t max_len) {
-    bool r = gpio_get(LED_RED);
-   return snprintf(result, max_len,
+// Níveis ao vivo do microfone; rms_max é o maior desde a leitura anterior
+static void api_escrever_som(json_writer_t *w, const void *ctx) {
+    const microfone_stats_t *s = (const microfone_stats_t*)ctx;
+    json_abrir_objeto(w);
+    json_campo_int(w, "rms", s->ultimo.rms);
+    json_campo_int(w, "pico", s->ultimo.pico);
+    json_campo_int(w, "dc", s->ultimo.dc);
+    json_campo_int(w, "rms_max", s->rms_max);
+    json_campo_int(w, "limiar", s->limiar_rms);
+    json_campo_int(w, "sustentado_ms", s->sustentado_ms);
+    json_campo_int(w, "blocos", s->blocos);
+    json_campo_int(w, "perdidos", s->perdidos);
+    json_campo_int(w, "disparos", s->disparos);
+    json_fechar_objeto(w);
+}
+
+static void api_escrever_temperatura(json_writer_t *w, const void *ctx) {
+    const temperatura_leitura_t *l = (const temperatura_leitura_t*)ctx;
+    json_abrir_objeto(w);
+    json_campo_int(w, "mc", l->filtro.mc);
+    json_campo_int(w, "ultimo_mc", l->filtro.ultimo_mc);
+    json_campo_int(w, "min_mc", l->filtro.min_mc);
+    json_campo_int(w, "max_mc", l->filtro.max_mc);
+    json_campo_int(w, "limiar_mc", l->filtro.limiar_mc);
+    json_campo_int(w, "histerese_mc", l->filtro.histerese_mc);
+    json_campo_int(w, "acima", l->filtro.acima);
+    json_campo_int(w, "blocos", l->filtro.blocos);
+    json_campo_int(w, "disparos", l->filtro.disparos);
+    json_campo_int(w, "idade_ms", l->idade_ms == UINT32_MAX ? -1 : (int)l->idade_ms);
+    json_fechar_objeto(w);
+}
+
+static void api_escrever_erro(json_writer_t *w, const void *ctx) {
+    json_abrir_objeto(w);
+    json_campo_str(w, "erro", (const char*)ctx);
+    json_fechar_objeto(w);
+}
+
+// Duas passagens: a primeira só mede o corpo para o Content-Length, a segunda escreve no pcb
+static void api_responder(struct tcp_pcb *pcb, const char *status,
+                          void (*corpo)(json_writer_t *w, const void *ctx), const void *ctx) {
+    json_writer_t w;
+    json_init(&w, NULL);
+    corpo(&w, ctx);
+
+    char cabecalho[112];
+    int len = snprintf(cabecalho, sizeof(cabecalho), HTTP_RESPONSE_JSON, status, w.len);
+    json_init(&w, pcb);
+    json_bruto(&w, cabecalho, len);
+    corpo(&w, ctx);
+    if (json_concluir(&w) >= 0) tcp_output(pcb);
+}
+
+// Página constante em flash: enviada em fatias sem cópia pelo http_stream
+static const char PAGINA_HTML[] =
     "<html>"
     "<head>"
     "<meta name='viewport' content='width=device-width, initial-scale=1'>"
     "<style>"
     "body { background-color:rgb(60, 141, 168); font-family: Arial, sans-serif; margin: 0; padding: 0; display: flex; flex-direction: column; align-items: center; justify-content: center; min-height: 100vh; }"
     "h2 { color: #333; margin-top: 30px; text-align: center; font-size: 1.8em; }"
-    ".status { margin: 20px; padding: 20px; background: white; border-radius: 10px; box-shadow: 0 0 10px rgba(0,0,0,0.1); width: 90%%; max-width: 400px; }"
-    ".btn { display: block; width: 90%%; padding: 15px; margin: 10px 0; font-size: 1.1em; font-weight: bold; border: none; border-radius: 8px; cursor: pointer; transition: 0.3s; }"
+    ".status { margin: 20px; padding: 20px; background: white; border-radius: 10px; box-shadow: 0 0 10px rgba(0,0,0,0.1); width: 90%; max-width: 400px; }"
+    ".btn { display: block; width: 90%; padding: 15px; margin: 10px 0; font-size: 1.1em; font-weight: bold; border: none; border-radius: 8px; cursor: pointer; transition: 0.3s; }"
     ".btn-on { background-color:rgb(216, 34, 14); color: white; }"
     ".btn-off { background-color:rgb(17, 134, 66); color: white; }"
     ".btn:hover { opacity: 0.85; }"
@@ -154,51 +463,432 @@ int generate_html(char *result, size_t max_len) {
     "<div class='status'>"
     "<a class='btn btn-on' href='?alarme=1'>Ativar Alarme</a>"
     "<a class='btn btn-off' href='?alarme=0'>Desligar Alarme</a>"
+    "<a href='?padrao=sirene'>Sirene</a> | <a href='?padrao=pulso'>Pulso</a> | <a href='?padrao=sos'>SOS</a>"
+    "<form><input type='color' name='cor'><input type='hidden' name='fade' value='500'><button>Cor</button></form>"
     "</div>"
     "</body>"
-    "</html>"
-);
-}
+    "</html>";
 
-int handle_request(const char *request, const char *params, char *result, size_t max_len) {
+// Configura a origem do corpo; retorna o tamanho, HTTP_TAMANHO_DESCONHECIDO (geradores) ou 0 se a rota não existe
+int handle_request(const char *request, const char *params, TCP_CONNECT_STATE_T *con_state) {
     if (strncmp(request, "/bitdoglabtest", 8) == 0) {
         if (params) parse_params(params);
-        return generate_html(result, max_len);
+        http_stream_flash(&con_state->corpo, PAGINA_HTML, sizeof(PAGINA_HTML) - 1);
+        return sizeof(PAGINA_HTML) - 1;
+    }
+#if METRICAS_ATIVAS
+    if (strcmp(request, "/metrics") == 0) {
+        http_stream_linhas(&con_state->corpo, &con_state->linhas, metricas_formatar_linha);
+        return HTTP_TAMANHO_DESCONHECIDO;
     }
+#endif
+    if (strcmp(request, "/diario") == 0) {
+        diario_cursor_iniciar(&con_state->diario);
+        http_stream_gerador(&con_state->corpo, diario_gerar, &con_state->diario);
+        con_state->tipo_corpo = "application/octet-stream";
+        return HTTP_TAMANHO_DESCONHECIDO;
+    }
+    if (strcmp(request, "/estacoes") == 0) {
+        http_stream_linhas(&con_state->corpo, &con_state->linhas, estacoes_formatar_linha);
+        return HTTP_TAMANHO_DESCONHECIDO;
+    }
+#if RASTRO_ATIVO
+    if (strcmp(request, "/rastros") == 0) {
+        http_stream_linhas(&con_state->corpo, &con_state->linhas, rastro_formatar_linha);
+        return HTTP_TAMANHO_DESCONHECIDO;
+    }
+#endif
+#if LWIP_TELEMETRIA
+    if (strcmp(request, "/lwip") == 0) {
+        http_stream_linhas(&con_state->corpo, &con_state->linhas, lwip_telemetria_formatar_linha);
+        return HTTP_TAMANHO_DESCONHECIDO;
+    }
+#endif
     return 0;
 }
 
-err_t tcp_server_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err) {
+static const struct {
+    const char *url;
+    metrica_hist_t hist;
+} ROTAS_METRICAS[] = {
+    {"/bitdoglabtest", MH_HTTP_PAGINA}, {"/api/state", MH_HTTP_API_STATE},
+    {"/api/commands", MH_HTTP_API_COMMANDS}, {"/api/som", MH_HTTP_API_SOM},
+    {"/eventos", MH_HTTP_EVENTOS}, {"/ws", MH_HTTP_WS}, {"/metrics", MH_HTTP_METRICS},
+    {"/estacoes", MH_HTTP_ESTACOES}, {"/diario", MH_HTTP_DIARIO}, {"/api/temp", MH_HTTP_API_TEMP},
+    {"/rastros", MH_HTTP_RASTROS},
+};
+
+static metrica_hist_t rota_metrica(const char *url) {
+    for (size_t i = 0; i < count_of(ROTAS_METRICAS); i++) {
+        if (strcmp(url, ROTAS_METRICAS[i].url) == 0) return ROTAS_METRICAS[i].hist;
+    }
+    return MH_HTTP_OUTRA;
+}
+
+// Devolve a vaga de conexão e a memória do estado
+static void tcp_server_free_state(TCP_CONNECT_STATE_T *con_state) {
+    if (con_state->requisicao) pbuf_free(con_state->requisicao);
+    con_state->server->conexoes_ativas--;
+    free(con_state);
+}
+
+// Libera o estado da conexão e fecha o pcb (aborta se o fechamento falhar).
+// Nada na fila de envio aponta para con_state: cabeçalhos e gerador são copiados, o resto vem da flash.
+static err_t tcp_server_close_client(TCP_CONNECT_STATE_T *con_state, struct tcp_pcb *pcb, err_t close_err) {
+    tcp_arg(pcb, NULL);
+    tcp_recv(pcb, NULL);
+    tcp_sent(pcb, NULL);
+    tcp_poll(pcb, NULL, 0);
+    tcp_err(pcb, NULL);
+    if (tcp_close(pcb) != ERR_OK) {
+        tcp_abort(pcb);
+        close_err = ERR_ABRT;
+    }
+    if (con_state) tcp_server_free_state(con_state);
+    return close_err;
+}
+
+// Cada confirmação libera espaço na janela: reabastece o envio e fecha quando tudo foi entregue
+static err_t tcp_server_sent(void *arg, struct tcp_pcb *pcb, u16_t len) {
     TCP_CONNECT_STATE_T *con_state = (TCP_CONNECT_STATE_T*)arg;
-    if (!p) return tcp_close(pcb);
-    pbuf_copy_partial(p, con_state->headers, sizeof(con_state->headers) - 1, 0);
+    if (http_stream_confirmar(&con_state->corpo, len)) {
+        return tcp_server_close_client(con_state, pcb, ERR_OK);
+    }
+    if (http_stream_bombear(&con_state->corpo) != ERR_OK) {
+        return tcp_server_close_client(con_state, pcb, ERR_OK);
+    }
+    return ERR_OK;
+}
+
+// Posição logo após o nome de um cabeçalho, comparado sem diferenciar maiúsculas (RFC 7230 §3.2);
+// só as linhas antes da linha em branco são consideradas
+static u16_t http_cabecalho_pos(struct pbuf *p, const char *nome) {
+    u16_t nome_len = strlen(nome);
+    u16_t linha = pbuf_memfind(p, "\n", 1, 0);
+    while (linha != 0xFFFF) {
+        linha++;
+        u8_t c = pbuf_get_at(p, linha);
+        if (c == '\r' || c == '\n' || linha + nome_len > p->tot_len) break;
+        u16_t i = 0;
+        while (i < nome_len && tolower(pbuf_get_at(p, linha + i)) == tolower((u8_t)nome[i])) i++;
+        if (i == nome_len) return linha + nome_len;
+        linha = pbuf_memfind(p, "\n", 1, linha);
+    }
+    return 0xFFFF;
+}
+
+// Copia o valor de um cabeçalho direto da pbuf (o buffer da requisição só guarda a primeira linha)
+static int http_cabecalho(struct pbuf *p, const char *nome, char *valor, int max_len) {
+    u16_t pos = http_cabecalho_pos(p, nome);
+    if (pos == 0xFFFF) return 0;
+    while (pbuf_get_at(p, pos) == ' ') pos++;
+    int n = 0;
+    while (n < max_len - 1 && pos < p->tot_len) {
+        u8_t c = pbuf_get_at(p, pos++);
+        if (c == '\r' || c == '\n') break;
+        valor[n++] = c;
+    }
+    while (n > 0 && valor[n - 1] == ' ') n--;
+    valor[n] = 0;
+    return n;
+}
+
+// Valida o pedido de upgrade; retorna a resposta de erro pronta ou NULL
+static const char *ws_handshake_invalido(struct pbuf *p, char *chave, int *chave_len) {
+    char valor[24];
+    *chave_len = http_cabecalho(p, "Sec-WebSocket-Key:", chave, WS_CHAVE_MAX);
+    if (*chave_len == 0 || !http_cabecalho(p, "Upgrade:", valor, sizeof(valor)) || strcasecmp(valor, "websocket") != 0) {
+        return HTTP_RESPONSE_WS_400;
+    }
+    if (!http_cabecalho(p, "Sec-WebSocket-Version:", valor, sizeof(valor)) || strcmp(valor, "13") != 0) {
+        return HTTP_RESPONSE_WS_426;
+    }
+    return NULL;
+}
+
+static void api_tratar(struct tcp_pcb *pcb, const char *method, const char *url, struct pbuf *p) {
+    if (strcmp(url, "/api/state") == 0 && strcmp(method, "GET") == 0) {
+        api_responder(pcb, "200 OK", api_escrever_estado, NULL);
+        return;
+    }
+    if (strcmp(url, "/api/som") == 0 && strcmp(method, "GET") == 0) {
+        microfone_stats_t s;
+        microfone_stats(&s, true);
+        api_responder(pcb, "200 OK", api_escrever_som, &s);
+        return;
+    }
+    if (strcmp(url, "/api/temp") == 0 && strcmp(method, "GET") == 0) {
+        // Valor já filtrado pelo worker do microfone; o ADC não é tocado aqui
+        temperatura_leitura_t l;
+        temperatura_leitura(&l);
+        api_responder(pcb, "200 OK", api_escrever_temperatura, &l);
+        return;
+    }
+    if (strcmp(url, "/api/commands") != 0) {
+        api_responder(pcb, "404 Not Found", api_escrever_erro, "rota desconhecida");
+        return;
+    }
+    if (strcmp(method, "POST") != 0) {
+        api_responder(pcb, "405 Method Not Allowed", api_escrever_erro, "use POST");
+        return;
+    }
+
+    // api_incompleta já esperou o corpo declarado chegar
+    char corpo[API_MAX_CORPO];
+    char tamanho[8];
+    u16_t inicio = pbuf_memfind(p, "\r\n\r\n", 4, 0);
+    int declarado = http_cabecalho(p, "Content-Length:", tamanho, sizeof(tamanho)) ? atoi(tamanho) : -1;
+    if (inicio == 0xFFFF || declarado < 0 || declarado >= (int)sizeof(corpo) || inicio + 4 + declarado > p->tot_len) {
+        api_responder(pcb, "400 Bad Request", api_escrever_erro, "corpo ausente ou grande demais");
+        return;
+    }
+    corpo[pbuf_copy_partial(p, corpo, declarado, inicio + 4)] = 0;
+
+    int8_t valores[NUM_ATUADORES];
+    memset(valores, -1, sizeof(valores));
+    const char *erro = api_ler_comandos(corpo, valores);
+    if (erro) {
+        api_responder(pcb, "400 Bad Request", api_escrever_erro, erro);
+        return;
+    }
+    diario_registrar(DIARIO_HTTP_COMANDO, DIARIO_FONTE_API, 0, ip4_addr_get_u32(ip_2_ip4(&pcb->remote_ip)));
+    aplicar_comandos(valores, DIARIO_FONTE_API);
+    api_responder(pcb, "200 OK", api_escrever_estado, NULL);
+}
+
+// POST cujo corpo ainda não chegou inteiro: os cabeçalhos podem vir num segmento e o corpo
+// em outro. Passado API_MAX_REQUISICAO ou com Content-Length grande demais, api_tratar recusa.
+static bool api_incompleta(const char *method, struct pbuf *p) {
+    if (strcmp(method, "POST") != 0 || p->tot_len >= API_MAX_REQUISICAO) return false;
+    u16_t inicio = pbuf_memfind(p, "\r\n\r\n", 4, 0);
+    if (inicio == 0xFFFF) return true;
+    char tamanho[8];
+    int declarado = http_cabecalho(p, "Content-Length:", tamanho, sizeof(tamanho)) ? atoi(tamanho) : -1;
+    return declarado > 0 && declarado < API_MAX_CORPO && inicio + 4 + declarado > p->tot_len;
+}
+
+// *rota só é definida quando p traz o início de uma requisição nova
+static err_t tcp_server_atender(void *arg, struct tcp_pcb *pcb, struct pbuf *p, metrica_hist_t *rota) {
+    TCP_CONNECT_STATE_T *con_state = (TCP_CONNECT_STATE_T*)arg;
+    if (!p) return tcp_server_close_client(con_state, pcb, ERR_OK);
+    if (con_state->header_len > 0) {
+        // Resposta já em andamento: descarta o restante da requisição
+        tcp_recved(pcb, p->tot_len);
+        pbuf_free(p);
+        return ERR_OK;
+    }
+    u16_t recebidos = p->tot_len;
+    if (con_state->requisicao) {
+        // Continuação de um POST: a requisição é analisada de novo com o segmento novo no fim
+        pbuf_cat(con_state->requisicao, p);
+        p = con_state->requisicao;
+        con_state->requisicao = NULL;
+    }
+    RASTRO_INICIO(RP_COPIA_PBUF);
+    u16_t copied = pbuf_copy_partial(p, con_state->headers, sizeof(con_state->headers) - 1, 0);
+    con_state->headers[copied] = 0;
+    RASTRO_FIM(RP_COPIA_PBUF);
+    tcp_recved(pcb, recebidos);
+    RASTRO_INICIO(RP_PARSE);
     char *request_line = strtok(con_state->headers, "\r\n");
-    char *method = strtok(request_line, " ");
-    char *url = strtok(NULL, " ");
+    char *method = request_line ? strtok(request_line, " ") : NULL;
+    char *url = method ? strtok(NULL, " ") : NULL;
+    RASTRO_FIM(RP_PARSE);
+    if (!url) {
+        pbuf_free(p);
+        return tcp_server_close_client(con_state, pcb, ERR_OK);
+    }
     char *params = strchr(url, '?');
     if (params) { *params = 0; params++; }
-    con_state->result_len = handle_request(url, params, con_state->result, sizeof(con_state->result));
-    if (con_state->result_len > 0)
-        con_state->header_len = snprintf(con_state->headers, sizeof(con_state->headers), HTTP_RESPONSE_HEADERS, con_state->result_len);
-    else {
-        con_state->header_len = snprintf(con_state->headers, sizeof(con_state->headers), HTTP_RESPONSE_REDIRECT, ipaddr_ntoa(con_state->gw));
-        con_state->result_len = 0;
+    *rota = rota_metrica(url);
+    RASTRO_ROTA(url);
+    if (strcmp(url, "/ws") == 0) {
+        char chave[WS_CHAVE_MAX];
+        int chave_len;
+        const char *erro = ws_handshake_invalido(p, chave, &chave_len);
+        pbuf_free(p);
+        if (erro) {
+            tcp_write(pcb, erro, strlen(erro), 0);
+            return tcp_server_close_client(con_state, pcb, ERR_OK);
+        }
+        err_t ws_err = ws_servidor_aceitar(pcb, chave, chave_len);
+        if (ws_err != ERR_MEM) {
+            tcp_server_free_state(con_state);
+            return ws_err;
+        }
+        tcp_write(pcb, HTTP_RESPONSE_503, sizeof(HTTP_RESPONSE_503) - 1, 0);
+        return tcp_server_close_client(con_state, pcb, ERR_OK);
+    }
+    if (strncmp(url, "/api/", 5) == 0) {
+        if (api_incompleta(method, p)) {
+            // Ainda não é uma requisição atendida: nada vai para o histograma
+            con_state->requisicao = p;
+            *rota = NUM_METRICAS_HIST;
+            return ERR_OK;
+        }
+        // Respostas da API vão direto para a fila de envio; nada depende de con_state
+        RASTRO_INICIO(RP_API);
+        api_tratar(pcb, method, url, p);
+        RASTRO_FIM(RP_API);
+        pbuf_free(p);
+        return tcp_server_close_client(con_state, pcb, ERR_OK);
     }
-    con_state->sent_len = 0;
-    tcp_write(pcb, con_state->headers, con_state->header_len, 0);
-    if (con_state->result_len > 0) tcp_write(pcb, con_state->result, con_state->result_len, 0);
-    tcp_recved(pcb, p->tot_len);
     pbuf_free(p);
-    return tcp_close(pcb);
+    if (strcmp(url, "/eventos") == 0) {
+        // O pcb passa para o módulo SSE; a vaga e o buffer de 1 KB são liberados. O estado
+        // é republicado antes para o novo assinante não receber um evento defasado
+        notificar_estado();
+        err_t sse_err = sse_assinar(pcb);
+        if (sse_err != ERR_MEM) {
+            tcp_server_free_state(con_state);
+            return sse_err;
+        }
+        tcp_write(pcb, HTTP_RESPONSE_503, sizeof(HTTP_RESPONSE_503) - 1, 0);
+        return tcp_server_close_client(con_state, pcb, ERR_OK);
+    }
+    if (params) diario_registrar(DIARIO_HTTP_COMANDO, DIARIO_FONTE_HTTP, 0, ip4_addr_get_u32(ip_2_ip4(&pcb->remote_ip)));
+    http_stream_init(&con_state->corpo, pcb);
+    con_state->tipo_corpo = "text/plain";
+    RASTRO_INICIO(RP_GERAR);
+    int body_len = handle_request(url, params, con_state);
+    if (body_len > 0)
+        con_state->header_len = snprintf(con_state->headers, sizeof(con_state->headers), HTTP_RESPONSE_HEADERS, body_len);
+    else if (body_len == HTTP_TAMANHO_DESCONHECIDO)
+        con_state->header_len = snprintf(con_state->headers, sizeof(con_state->headers), HTTP_RESPONSE_HEADERS_STREAM, con_state->tipo_corpo);
+    else
+        con_state->header_len = snprintf(con_state->headers, sizeof(con_state->headers), HTTP_RESPONSE_REDIRECT, ipaddr_ntoa(con_state->gw));
+    RASTRO_FIM(RP_GERAR);
+    tcp_sent(pcb, tcp_server_sent);
+    // Geradores e linhas de relatório são produzidos dentro do bombear, junto com o tcp_write
+    RASTRO_INICIO(RP_TCP_WRITE);
+    err_t envio = http_stream_escrever(&con_state->corpo, con_state->headers, con_state->header_len);
+    if (envio == ERR_OK) envio = http_stream_bombear(&con_state->corpo);
+    RASTRO_FIM(RP_TCP_WRITE);
+    if (envio != ERR_OK) {
+        return tcp_server_close_client(con_state, pcb, ERR_OK);
+    }
+    return ERR_OK;
+}
+
+// Mede o tratamento de cada requisição por rota; segmentos seguintes e o fechamento não contam
+err_t tcp_server_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err) {
+    METRICA_INICIO(inicio);
+    RASTRO_REQUISICAO_INICIO();
+    RASTRO_INICIO(RP_REQUISICAO);
+    metrica_hist_t rota = NUM_METRICAS_HIST;
+    err_t ret = tcp_server_atender(arg, pcb, p, &rota);
+    RASTRO_FIM(RP_REQUISICAO);
+    RASTRO_REQUISICAO_FIM(rota != NUM_METRICAS_HIST);
+    if (rota != NUM_METRICAS_HIST) {
+        METRICA_REGISTRAR(rota, inicio);
+        boot_marcar(BOOT_PRIMEIRA_RESPOSTA);
+    }
+    return ret;
+}
+
+// Encerra conexões ociosas para que clientes lentos não prendam vagas; envios longos
+// continuam enquanto o cliente confirmar algo entre duas chamadas
+static err_t tcp_server_poll(void *arg, struct tcp_pcb *pcb) {
+    TCP_CONNECT_STATE_T *con_state = (TCP_CONNECT_STATE_T*)arg;
+    if (con_state->header_len > 0 && con_state->corpo.confirmado != con_state->confirmado_no_poll) {
+        con_state->confirmado_no_poll = con_state->corpo.confirmado;
+        return ERR_OK;
+    }
+    return tcp_server_close_client(con_state, pcb, ERR_OK);
+}
+
+// O pcb já foi liberado pelo lwIP; resta devolver a vaga e a memória
+static void tcp_server_err(void *arg, err_t err) {
+    TCP_CONNECT_STATE_T *con_state = (TCP_CONNECT_STATE_T*)arg;
+    if (con_state) tcp_server_free_state(con_state);
+}
+
+// Janela fixa por IP; uma entrada livre ou a mais antiga é reaproveitada para IPs novos
+static bool taxa_permitida(TCP_SERVER_T *state, const ip_addr_t *remote) {
+    uint32_t ip = ip4_addr_get_u32(ip_2_ip4(remote));
+    uint32_t agora = to_ms_since_boot(get_absolute_time());
+    HTTP_TAXA_CLIENTE_T *cliente = &state->taxa[0];
+    for (int i = 0; i < HTTP_TAXA_MAX_CLIENTES; i++) {
+        if (state->taxa[i].ip == ip) {
+            cliente = &state->taxa[i];
+            break;
+        }
+        // Sem o teste de livre, logo após a partida o relógio ainda vale 0 como o das
+        // entradas vazias e um IP novo tomaria a vaga de um ativo
+        if (cliente->ip != 0 && (state->taxa[i].ip == 0 || state->taxa[i].inicio_janela_ms < cliente->inicio_janela_ms)) {
+            cliente = &state->taxa[i];
+        }
+    }
+    if (cliente->ip != ip || agora - cliente->inicio_janela_ms >= HTTP_TAXA_JANELA_MS) {
+        cliente->ip = ip;
+        cliente->inicio_janela_ms = agora;
+        cliente->requisicoes = 0;
+    }
+    return ++cliente->requisicoes <= HTTP_TAXA_MAX_REQ;
+}
+
+// Conexão que recebeu o 503: só o envio foi fechado. Com tcp_close o lwIP responderia com
+// RST à requisição que ainda chega, e o cliente poderia perder a resposta antes de lê-la.
+static err_t tcp_rejeitada_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err) {
+    if (p) {
+        tcp_recved(pcb, p->tot_len);
+        pbuf_free(p);
+        return ERR_OK;
+    }
+    tcp_recv(pcb, NULL);
+    tcp_poll(pcb, NULL, 0);
+    if (tcp_close(pcb) != ERR_OK) {
+        tcp_abort(pcb);
+        return ERR_ABRT;
+    }
+    return ERR_OK;
+}
+
+// Cliente que não fecha a sua metade a tempo perde a conexão
+static err_t tcp_rejeitada_poll(void *arg, struct tcp_pcb *pcb) {
+    tcp_abort(pcb);
+    return ERR_ABRT;
 }
 
 static err_t tcp_server_accept(void *arg, struct tcp_pcb *client_pcb, err_t err) {
     TCP_SERVER_T *state = (TCP_SERVER_T*)arg;
+    if (err != ERR_OK || client_pcb == NULL) return ERR_VAL;
+
+    // Sem vaga: RST imediato, nada é alocado
+    if (state->conexoes_ativas >= HTTP_MAX_CONEXOES) {
+        state->rejeitadas_conexao++;
+        tcp_abort(client_pcb);
+        return ERR_ABRT;
+    }
+
+    // Cliente acima da taxa: 503 pronto, sem estado de conexão
+    if (!taxa_permitida(state, &client_pcb->remote_ip)) {
+        state->rejeitadas_taxa++;
+        tcp_arg(client_pcb, NULL);
+        tcp_recv(client_pcb, tcp_rejeitada_recv);
+        tcp_poll(client_pcb, tcp_rejeitada_poll, POLL_TIME_S * 2);
+        if (tcp_write(client_pcb, HTTP_RESPONSE_503, sizeof(HTTP_RESPONSE_503) - 1, 0) != ERR_OK ||
+            tcp_shutdown(client_pcb, 0, 1) != ERR_OK) {
+            tcp_abort(client_pcb);
+            return ERR_ABRT;
+        }
+        return ERR_OK;
+    }
+
     TCP_CONNECT_STATE_T *con_state = calloc(1, sizeof(TCP_CONNECT_STATE_T));
+    if (!con_state) {
+        state->rejeitadas_conexao++;
+        tcp_abort(client_pcb);
+        return ERR_ABRT;
+    }
+    state->conexoes_ativas++;
     con_state->pcb = client_pcb;
     con_state->gw = &state->gw;
+    con_state->server = state;
     tcp_arg(client_pcb, con_state);
     tcp_recv(client_pcb, tcp_server_recv);
+    tcp_poll(client_pcb, tcp_server_poll, POLL_TIME_S * 2);
+    tcp_err(client_pcb, tcp_server_err);
     return ERR_OK;
 }
 
@@ -206,50 +896,90 @@ static bool tcp_server_open(TCP_SERVER_T *state, const char *ap_name) {
     struct tcp_pcb *pcb = tcp_new_ip_type(IPADDR_TYPE_ANY);
     if (!pcb) return false;
     if (tcp_bind(pcb, IP_ANY_TYPE, TCP_PORT)) return false;
-    state->server_pcb = tcp_listen_with_backlog(pcb, 1);
+    state->server_pcb = tcp_listen_with_backlog(pcb, HTTP_MAX_CONEXOES);
+    if (!state->server_pcb) {
+        tcp_close(pcb);
+        return false;
+    }
     tcp_arg(state->server_pcb, state);
     tcp_accept(state->server_pcb, tcp_server_accept);
     printf("Acesse: http://%s/bitdoglabtest\n", ap_name);
     return true;
 }
 
-void key_pressed_func(void *param) {
+void imprimir_stats_laco() {
+    printf("laco: %lu iteracoes\n", (unsigned long)laco_iteracoes);
+    core1_imprimir_stats();
+    botoes_imprimir_stats();
+    serial_controle_imprimir();
+}
+
+// Teclas do console; os quadros binários da serial são separados antes (ver serial_controle.h)
+void key_pressed_func(int key, void *param) {
     TCP_SERVER_T *state = (TCP_SERVER_T*)param;
-    int key = getchar_timeout_us(0);
     if (key == 'd' || key == 'D') {
         cyw43_arch_lwip_begin();
         cyw43_arch_disable_ap_mode();
         cyw43_arch_lwip_end();
         state->complete = true;
+    } else if (key == 's' || key == 'S') {
+        imprimir_stats_laco();
+    } else if (key == 'b' || key == 'B') {
+        boot_imprimir();
+    } else if (key == 'n' || key == 'N') {
+        malha_imprimir();
+    } else if (key == 'e' || key == 'E') {
+        estacoes_imprimir();
+#if METRICAS_ATIVAS
+    } else if (key == 'm' || key == 'M') {
+        metricas_imprimir();
+#endif
+#if RASTRO_ATIVO
+    } else if (key == 't' || key == 'T') {
+        rastro_imprimir();
+#endif
+#if LWIP_TELEMETRIA
+    } else if (key == 'l' || key == 'L') {
+        lwip_telemetria_imprimir();
+#endif
+    }
+}
+
+// Dorme até haver trabalho do cyw43/lwIP, um worker pendente ou o próximo timer do async_context.
+// No alvo poll é aqui que a rede é atendida; no background o mesmo laço apenas dorme.
+static void laco_principal(TCP_SERVER_T *state) {
+    while (!state->complete) {
+#if PICO_CYW43_ARCH_POLL
+        cyw43_arch_poll();
+#endif
+        cyw43_arch_wait_for_work_until(make_timeout_time_ms(LACO_ESPERA_MAX_MS));
+        laco_iteracoes++;
     }
 }
 
 int main() {
     stdio_init_all();
+    boot_marcar(BOOT_STDIO);
+    diario_registrar(DIARIO_PARTIDA, 0, 0, 0);
     TCP_SERVER_T *state = calloc(1, sizeof(TCP_SERVER_T));
-    cyw43_arch_init();
-    stdio_set_chars_available_callback(key_pressed_func, state);
-
-    i2c_init(i2c1, ssd1306_i2c_clock * 1000);
-    gpio_set_function(I2C_SDA, GPIO_FUNC_I2C);
-    gpio_set_function(I2C_SCL, GPIO_FUNC_I2C);
-    gpio_pull_up(I2C_SDA);
-    gpio_pull_up(I2C_SCL);
-    ssd1306_init();
 
-    frame_area.start_column = 0;
-    frame_area.end_column = ssd1306_width - 1;
-    frame_area.start_page = 0;
-    frame_area.end_page = ssd1306_n_pages - 1;
-    calculate_render_area_buffer_length(&frame_area);
+    // Display, LEDs e buzzer são inicializados e atendidos pelo core1, em paralelo com a
+    // carga do firmware do cyw43; a matriz e a tela "INICIANDO" avisam que a placa está viva
+    core1_worker_iniciar();
+    boot_marcar(BOOT_CORE1_LANCADO);
+    cyw43_arch_init();
+    boot_marcar(BOOT_CYW43);
+    serial_controle_iniciar(cyw43_arch_async_context(), key_pressed_func, state, comandos_serial);
 
-    memset(ssd, 0, ssd1306_buffer_length);
-    atualizar_display();
-    init_leds();
+    alarme_iniciar(cyw43_arch_async_context());
+    microfone_iniciar(cyw43_arch_async_context(), disparar_por_som);
+    temperatura_iniciar(disparar_por_temperatura);
+    botoes_iniciar(cyw43_arch_async_context(), tratar_botao);
 
     const char *ap_name = "BitDogLab Wasley";
     const char *password = "12345678";
     cyw43_arch_enable_ap_mode(ap_name, password, CYW43_AUTH_WPA2_AES_PSK);
+    boot_marcar(BOOT_AP);
 
     ip4_addr_t mask;
     IP4_ADDR(&state->gw, 192, 168, 4, 1);
@@ -257,16 +987,25 @@ int main() {
 
     dhcp_server_t dhcp_server;
     dhcp_server_init(&dhcp_server, &state->gw, &mask);
+    estacoes_iniciar(cyw43_arch_async_context(), &dhcp_server);
 
     dns_server_t dns_server;
     dns_server_init(&dns_server, &state->gw);
+    boot_marcar(BOOT_DHCP_DNS);
 
+    ws_servidor_init(comando_ws);
+    // Estado inicial já publicado: quem assina /eventos antes da primeira mudança o recebe
+    notificar_estado();
     if (!tcp_server_open(state, "192.168.4.1")) return 1;
+    boot_marcar(BOOT_HTTP_ESCUTANDO);
+    malha_iniciar(cyw43_arch_async_context(), aplicar_alarme_da_malha);
+
+    // Rede no ar: sai da indicação de partida, a menos que o alarme já a tenha trocado
+    solicitar_display();
+    if (!alarme_esta_ativo()) core1_mostrar_matriz(MATRIZ_REPOUSO);
 
     state->complete = false;
-    while (!state->complete) {
-        sleep_ms(1000);
-    }
+    laco_principal(state);
 
     cyw43_arch_deinit();
     return 0;
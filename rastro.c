@@ -0,0 +1,163 @@
+#include "rastro.h"
+
+#if RASTRO_ATIVO
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "http_stream.h"
+
+#if defined(__ARM_ARCH_6M__)
+#include "hardware/clocks.h"
+#include "hardware/structs/systick.h"
+#else
+#include <time.h>
+#endif
+
+#define RASTRO_ROTA_MAX 24
+
+static const char *const NOMES_PONTOS[NUM_RASTRO_PONTOS] = {
+    "requisicao", "copia_pbuf", "parse", "api", "parse_params", "display", "gerar", "tcp_write",
+};
+
+typedef struct {
+    uint32_t ciclos; // desde rastro_iniciar
+    uint8_t ponto;
+    uint8_t fim;
+} rastro_evento_t;
+
+typedef struct {
+    uint32_t seq;
+    uint32_t inicio_us;
+    char rota[RASTRO_ROTA_MAX];
+    uint8_t n;
+    bool truncado;
+    rastro_evento_t eventos[RASTRO_EVENTOS];
+} rastro_t;
+
+// Uma vaga a mais que o exportado: a requisição em curso grava direto na próxima vaga sem
+// tocar nenhum dos RASTRO_GUARDADOS rastros visíveis
+static rastro_t rastros[RASTRO_GUARDADOS + 1];
+static uint32_t concluidos; // rastros mantidos desde a partida
+static uint32_t requisicoes; // atendidas; segmentos que não abriram requisição não contam
+static rastro_t *atual;
+bool rastro_gravando;
+
+#if defined(__ARM_ARCH_6M__)
+// O M0+ não tem o contador de ciclos do DWT; o SysTick de 24 bits no clock do processador
+// conta ciclos exatos e volta a cada 2^24 (134 ms a 125 MHz). Acumulando a diferença entre
+// leituras vizinhas, basta que duas marcas da mesma requisição estejam a menos de uma volta.
+static uint32_t systick_anterior;
+static uint32_t ciclos_acumulados;
+
+static void relogio_zerar(void) {
+    if (!(systick_hw->csr & M0PLUS_SYST_CSR_ENABLE_BITS)) {
+        systick_hw->rvr = M0PLUS_SYST_RVR_BITS;
+        systick_hw->cvr = 0;
+        systick_hw->csr = M0PLUS_SYST_CSR_CLKSOURCE_BITS | M0PLUS_SYST_CSR_ENABLE_BITS;
+    }
+    systick_anterior = systick_hw->cvr;
+    ciclos_acumulados = 0;
+}
+
+static uint32_t relogio_ciclos(void) {
+    uint32_t agora = systick_hw->cvr; // decrescente
+    ciclos_acumulados += (systick_anterior - agora) & M0PLUS_SYST_RVR_BITS;
+    systick_anterior = agora;
+    return ciclos_acumulados;
+}
+
+static uint32_t relogio_hz(void) {
+    return clock_get_hz(clk_sys);
+}
+#else
+// No host o "ciclo" é o nanossegundo do CLOCK_MONOTONIC
+static uint64_t relogio_base_ns;
+
+static uint64_t monotonico_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static void relogio_zerar(void) {
+    relogio_base_ns = monotonico_ns();
+}
+
+static uint32_t relogio_ciclos(void) {
+    return (uint32_t)(monotonico_ns() - relogio_base_ns);
+}
+
+static uint32_t relogio_hz(void) {
+    return 1000000000u;
+}
+#endif
+
+void rastro_iniciar(void) {
+    rastro_gravando = false;
+    if (requisicoes % RASTRO_AMOSTRAGEM) return;
+    atual = &rastros[concluidos % count_of(rastros)];
+    atual->inicio_us = time_us_32();
+    atual->rota[0] = 0;
+    atual->n = 0;
+    atual->truncado = false;
+    relogio_zerar();
+    rastro_gravando = true;
+}
+
+void rastro_rota(const char *url) {
+    strncpy(atual->rota, url, sizeof(atual->rota) - 1);
+    atual->rota[sizeof(atual->rota) - 1] = 0;
+}
+
+void rastro_marcar(rastro_ponto_t p, bool fim) {
+    uint32_t ciclos = relogio_ciclos();
+    if (atual->n == RASTRO_EVENTOS) {
+        atual->truncado = true;
+        return;
+    }
+    rastro_evento_t *e = &atual->eventos[atual->n++];
+    e->ciclos = ciclos;
+    e->ponto = p;
+    e->fim = fim;
+}
+
+// Só requisições atendidas avançam a amostragem: depois de um segmento descartado a vez
+// fica com o próximo, até uma requisição ser atendida
+void rastro_concluir(bool manter) {
+    if (manter) requisicoes++;
+    if (!rastro_gravando) return;
+    rastro_gravando = false;
+    if (!manter) return;
+    atual->seq = concluidos++;
+}
+
+// Linhas percorridas do rastro mais velho ao mais novo. Um rastro concluído no meio de uma
+// exportação desloca a janela: a listagem pode pular ou repetir um rastro, nunca misturá-los.
+int rastro_formatar_linha(uint16_t indice, char *linha, int max) {
+    uint32_t primeiro = concluidos > RASTRO_GUARDADOS ? concluidos - RASTRO_GUARDADOS : 0;
+    for (uint32_t s = primeiro; s < concluidos; s++) {
+        const rastro_t *r = &rastros[s % count_of(rastros)];
+        if (indice == 0) {
+            return snprintf(linha, max, "rastro %lu %s us=%lu hz=%lu n=%u%s\n", (unsigned long)r->seq,
+                r->rota[0] ? r->rota : "-", (unsigned long)r->inicio_us, (unsigned long)relogio_hz(), r->n,
+                r->truncado ? " truncado" : "");
+        }
+        if (indice <= r->n) {
+            const rastro_evento_t *e = &r->eventos[indice - 1];
+            return snprintf(linha, max, "%c %s %lu\n", e->fim ? 'E' : 'B', NOMES_PONTOS[e->ponto],
+                (unsigned long)e->ciclos);
+        }
+        indice -= r->n + 1;
+    }
+    return 0;
+}
+
+void rastro_imprimir(void) {
+    char linha[HTTP_LINHA_MAX];
+    for (uint16_t i = 0; rastro_formatar_linha(i, linha, sizeof(linha)) > 0; i++) {
+        fputs(linha, stdout);
+    }
+}
+
+#endif
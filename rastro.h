@@ -0,0 +1,73 @@
+#ifndef RASTRO_H
+#define RASTRO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Rastro por requisição: marcas de início/fim com carimbo em ciclos num buffer da própria
+// requisição, amostrado 1 em RASTRO_AMOSTRAGEM para limitar o custo. Os últimos rastros
+// completos saem em texto em /rastros (ou na tecla 't') e host/rastro_chrome os converte para
+// o formato de trace do Chrome/Perfetto ou para pilhas "folded" de flamegraph.
+//
+// Tudo roda no contexto do lwIP do core0: uma requisição por vez, sem trava. Com
+// RASTRO_ATIVO=0 as macros viram nada e nem o módulo nem a rota entram no binário.
+
+#ifndef RASTRO_ATIVO
+#define RASTRO_ATIVO 1
+#endif
+#ifndef RASTRO_AMOSTRAGEM
+#define RASTRO_AMOSTRAGEM 8 // 1 em N requisições é rastreada; a primeira sempre
+#endif
+#ifndef RASTRO_EVENTOS
+#define RASTRO_EVENTOS 32 // marcas por requisição; as excedentes são descartadas
+#endif
+#ifndef RASTRO_GUARDADOS
+#define RASTRO_GUARDADOS 8 // rastros completos mantidos para exportação
+#endif
+
+typedef enum {
+    RP_REQUISICAO,
+    RP_COPIA_PBUF,
+    RP_PARSE,
+    RP_API,
+    RP_PARSE_PARAMS,
+    RP_DISPLAY,
+    RP_GERAR,
+    RP_TCP_WRITE,
+    NUM_RASTRO_PONTOS
+} rastro_ponto_t;
+
+#if RASTRO_ATIVO
+
+extern bool rastro_gravando;
+
+// Decide, pela contagem de requisições atendidas, se este segmento será rastreado e zera o
+// relógio de ciclos
+void rastro_iniciar(void);
+void rastro_rota(const char *url);
+void rastro_marcar(rastro_ponto_t p, bool fim);
+// manter = false descarta (segmento que não abriu requisição) sem contar para a amostragem
+void rastro_concluir(bool manter);
+
+// Cabeçalho "rastro seq rota us=... hz=... n=..." seguido de "B|E ponto ciclos" por marca
+// (http_linha_fn); retorna 0 depois da última
+int rastro_formatar_linha(uint16_t indice, char *linha, int max);
+void rastro_imprimir(void);
+
+#define RASTRO_REQUISICAO_INICIO() rastro_iniciar()
+#define RASTRO_REQUISICAO_FIM(manter) rastro_concluir(manter)
+#define RASTRO_ROTA(url) do { if (rastro_gravando) rastro_rota(url); } while (0)
+#define RASTRO_INICIO(p) do { if (rastro_gravando) rastro_marcar((p), false); } while (0)
+#define RASTRO_FIM(p) do { if (rastro_gravando) rastro_marcar((p), true); } while (0)
+
+#else
+
+#define RASTRO_REQUISICAO_INICIO() ((void)0)
+#define RASTRO_REQUISICAO_FIM(manter) ((void)0)
+#define RASTRO_ROTA(url) ((void)0)
+#define RASTRO_INICIO(p) ((void)0)
+#define RASTRO_FIM(p) ((void)0)
+
+#endif
+
+#endif
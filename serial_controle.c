@@ -0,0 +1,162 @@
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "bitdoglab.h"
+#include "serial_controle.h"
+#include "spsc_ring.h"
+#include "alarme.h"
+#include "core1_worker.h"
+#include "metricas.h"
+
+typedef struct {
+    uint8_t len;
+    uint8_t dados[SERIAL_QUADRO_MAX];
+} serial_pedido_t;
+
+static serial_decodificador_t dec;
+static serial_pedido_t fila_dados[SERIAL_FILA_TAM];
+static spsc_ring_t fila;
+static async_context_t *ctx;
+static async_when_pending_worker_t worker;
+static serial_tecla_fn tecla_fn;
+static void *tecla_param;
+static serial_comandos_fn comandos_fn;
+static volatile uint32_t descartados;
+static uint32_t respondidos;
+
+// Produtor único: o callback do stdio (IRQ do USB na placa). Lê tudo o que já chegou.
+static void serial_chars(void *param) {
+    int c;
+    while ((c = getchar_timeout_us(0)) >= 0) {
+        serial_evento_t e = serial_decodificar(&dec, c);
+        if (e == SERIAL_TECLA) {
+            tecla_fn(c, tecla_param);
+        } else if (e == SERIAL_QUADRO) {
+            serial_pedido_t pedido;
+            pedido.len = dec.len;
+            memcpy(pedido.dados, dec.quadro, dec.len);
+            if (!spsc_ring_push(&fila, &pedido)) descartados++;
+            async_context_set_work_pending(ctx, &worker);
+        }
+    }
+}
+
+static void escrever_u32(uint8_t *p, uint32_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+    p[2] = v >> 16;
+    p[3] = v >> 24;
+}
+
+static int escrever_estado(uint8_t *p) {
+    rgb_cor_t cor = core1_cor();
+    p[SERIAL_ESTADO_ALARME] = alarme_esta_ativo();
+    p[SERIAL_ESTADO_PADRAO] = alarme_padrao();
+    p[SERIAL_ESTADO_TOM] = alarme_tom();
+    p[SERIAL_ESTADO_R] = cor.r;
+    p[SERIAL_ESTADO_G] = cor.g;
+    p[SERIAL_ESTADO_B] = cor.b;
+    p[SERIAL_ESTADO_SAIDAS] = core1_saida(LED_RED) | core1_saida(LED_GREEN) << 1 |
+        core1_saida(LED_BLUE) << 2 | core1_saida(BUZZER) << 3;
+    return SERIAL_ESTADO_TAM;
+}
+
+static int escrever_metricas(uint8_t *p) {
+#if METRICAS_ATIVAS
+    int n = 0;
+    p[n++] = NUM_METRICAS_CONTADORES;
+    n++; // histogramas: só os que couberem no quadro
+    for (int i = 0; i < NUM_METRICAS_CONTADORES; i++, n += 4) escrever_u32(p + n, metricas_contador(i));
+    int h = 0;
+    for (; h < NUM_METRICAS_HIST && n + 8 <= SERIAL_DADOS_MAX; h++, n += 8) {
+        uint32_t total, max_us;
+        metricas_hist_resumo(h, &total, &max_us);
+        escrever_u32(p + n, total);
+        escrever_u32(p + n + 4, max_us);
+    }
+    p[1] = (uint8_t)h;
+    return n;
+#else
+    return -1;
+#endif
+}
+
+// Executa um pedido; dados recebe a carga da resposta. Retorna o status.
+static serial_status_t executar(const uint8_t *pedido, int len, uint8_t *dados, int *dados_len) {
+    const uint8_t *arg = pedido + 2;
+    int arg_len = len - 2;
+    *dados_len = 0;
+    switch (pedido[0]) {
+        case SERIAL_CMD_ECO:
+            if (arg_len > SERIAL_DADOS_MAX) return SERIAL_TAMANHO_INVALIDO;
+            memcpy(dados, arg, arg_len);
+            *dados_len = arg_len;
+            return SERIAL_OK;
+        case SERIAL_CMD_COMANDOS: {
+            if (arg_len % 2) return SERIAL_TAMANHO_INVALIDO;
+            int8_t valores[SERIAL_NUM_ATUADORES];
+            memset(valores, -1, sizeof(valores));
+            for (int i = 0; i < arg_len; i += 2) {
+                if (arg[i] >= SERIAL_NUM_ATUADORES || arg[i + 1] > 1) return SERIAL_TAMANHO_INVALIDO;
+                valores[arg[i]] = arg[i + 1];
+            }
+            comandos_fn(valores);
+            *dados_len = escrever_estado(dados);
+            return SERIAL_OK;
+        }
+        case SERIAL_CMD_ESTADO:
+            *dados_len = escrever_estado(dados);
+            return SERIAL_OK;
+        case SERIAL_CMD_METRICAS: {
+            int n = escrever_metricas(dados);
+            if (n < 0) return SERIAL_NAO_SUPORTADO;
+            *dados_len = n;
+            return SERIAL_OK;
+        }
+        case SERIAL_CMD_TELA:
+            if (arg_len < 1 || arg_len > 2 || arg[0] > TELA_INICIANDO ||
+                (arg_len == 2 && arg[1] >= NUM_PADROES_MATRIZ)) {
+                return SERIAL_TAMANHO_INVALIDO;
+            }
+            if (!core1_mostrar_tela(arg[0])) return SERIAL_OCUPADO;
+            if (arg_len == 2 && !core1_mostrar_matriz(arg[1])) return SERIAL_OCUPADO;
+            return SERIAL_OK;
+        default:
+            return SERIAL_DESCONHECIDO;
+    }
+}
+
+// Consumidor: responde na ordem de chegada, com putchar_raw para escapar da conversão de '\n'
+static void serial_worker(async_context_t *context, async_when_pending_worker_t *w) {
+    serial_pedido_t pedido;
+    while (spsc_ring_pop(&fila, &pedido)) {
+        uint8_t resposta[SERIAL_QUADRO_MAX - 2];
+        uint8_t saida[SERIAL_CODIFICADO_MAX(SERIAL_QUADRO_MAX - 2)];
+        int dados_len;
+        resposta[0] = pedido.dados[0] | SERIAL_RESPOSTA;
+        resposta[1] = pedido.dados[1];
+        resposta[2] = executar(pedido.dados, pedido.len, resposta + 3, &dados_len);
+        size_t n = serial_codificar(resposta, 3 + dados_len, saida, sizeof(saida));
+        for (size_t i = 0; i < n; i++) putchar_raw(saida[i]);
+        stdio_flush();
+        respondidos++;
+    }
+}
+
+void serial_controle_iniciar(async_context_t *context, serial_tecla_fn tecla, void *param, serial_comandos_fn comandos) {
+    ctx = context;
+    tecla_fn = tecla;
+    tecla_param = param;
+    comandos_fn = comandos;
+    serial_decodificador_init(&dec);
+    spsc_ring_init(&fila, fila_dados, SERIAL_FILA_TAM, sizeof(serial_pedido_t));
+    worker.do_work = serial_worker;
+    async_context_add_when_pending_worker(ctx, &worker);
+    stdio_set_chars_available_callback(serial_chars, NULL);
+}
+
+void serial_controle_imprimir(void) {
+    printf("serial: %lu quadros, %lu respondidos, %lu erros de crc, %lu malformados, %lu descartados (fila cheia)\n",
+        (unsigned long)dec.quadros, (unsigned long)respondidos, (unsigned long)dec.erros_crc,
+        (unsigned long)dec.erros_formato, (unsigned long)descartados);
+}
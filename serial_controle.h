@@ -0,0 +1,26 @@
+#ifndef SERIAL_CONTROLE_H
+#define SERIAL_CONTROLE_H
+
+#include <stdint.h>
+#include "pico/async_context.h"
+#include "serial_quadro.h"
+
+// Protocolo binário da serial (ver serial_quadro.h) atendido junto com as teclas do console.
+// O callback de caracteres disponíveis só decodifica, sem alocar; cada quadro completo segue
+// por uma fila sem trava para um worker do async_context, que executa e responde.
+
+#ifndef SERIAL_FILA_TAM
+#define SERIAL_FILA_TAM 4 // quadros aguardando o worker, potência de 2
+#endif
+
+// Byte fora de quadro, no contexto do callback de stdio
+typedef void (*serial_tecla_fn)(int tecla, void *param);
+
+// Lote de SERIAL_CMD_COMANDOS (-1 = sem alteração), no contexto do async_context
+typedef void (*serial_comandos_fn)(const int8_t valores[SERIAL_NUM_ATUADORES]);
+
+// Substitui o callback de caracteres do stdio
+void serial_controle_iniciar(async_context_t *context, serial_tecla_fn tecla, void *param, serial_comandos_fn comandos);
+void serial_controle_imprimir(void);
+
+#endif
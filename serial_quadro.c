@@ -0,0 +1,101 @@
+#include <string.h>
+#include "serial_quadro.h"
+
+uint16_t serial_crc16(const uint8_t *dados, size_t len) {
+    uint16_t crc = 0xffff;
+    while (len--) {
+        crc ^= (uint16_t)*dados++ << 8;
+        for (int i = 0; i < 8; i++) crc = crc & 0x8000 ? crc << 1 ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+void serial_decodificador_init(serial_decodificador_t *d) {
+    memset(d, 0, sizeof(*d));
+}
+
+static void recomecar(serial_decodificador_t *d) {
+    d->em_quadro = true;
+    d->estourou = false;
+    d->zero_pendente = false;
+    d->restante = 0;
+    d->len = 0;
+}
+
+static void guardar(serial_decodificador_t *d, uint8_t b) {
+    if (d->len < SERIAL_QUADRO_MAX) d->quadro[d->len++] = b;
+    else d->estourou = true;
+}
+
+static serial_evento_t concluir(serial_decodificador_t *d) {
+    // 0x00 logo após outro 0x00 só abre o quadro seguinte (e ressincroniza após lixo)
+    if (d->len == 0 && d->restante == 0 && !d->estourou) {
+        recomecar(d);
+        return SERIAL_NADA;
+    }
+    bool valido = !d->estourou && !d->restante && d->len >= 4;
+    if (!valido) {
+        d->erros_formato++;
+    } else {
+        d->len -= 2;
+        valido = serial_crc16(d->quadro, d->len) == (d->quadro[d->len] | d->quadro[d->len + 1] << 8);
+        if (!valido) d->erros_crc++;
+    }
+    if (valido) {
+        d->em_quadro = false;
+        d->descartando = false;
+        d->quadros++;
+        return SERIAL_QUADRO;
+    }
+    // Um 0x00 corrompido parte o quadro em dois: o resto até o próximo 0x00 também é
+    // descartado em vez de virar teclas do console
+    bool segunda = d->descartando;
+    recomecar(d);
+    d->em_quadro = !segunda;
+    d->descartando = !segunda;
+    return SERIAL_ERRO;
+}
+
+serial_evento_t serial_decodificar(serial_decodificador_t *d, uint8_t byte) {
+    if (!d->em_quadro) {
+        if (byte != 0) return SERIAL_TECLA;
+        recomecar(d);
+        return SERIAL_NADA;
+    }
+    if (byte == 0) return concluir(d);
+    if (d->restante) {
+        guardar(d, byte);
+        d->restante--;
+    } else {
+        // Código COBS: o zero do bloco anterior só existe porque o quadro continuou
+        if (d->zero_pendente) guardar(d, 0);
+        d->codigo = byte;
+        d->restante = byte - 1;
+    }
+    if (!d->restante) d->zero_pendente = d->codigo != 0xff;
+    return SERIAL_NADA;
+}
+
+size_t serial_codificar(const uint8_t *quadro, size_t len, uint8_t *saida, size_t max) {
+    if (max < SERIAL_CODIFICADO_MAX(len)) return 0;
+    uint16_t crc = serial_crc16(quadro, len);
+    size_t n = 0;
+    saida[n++] = 0;
+    size_t pos_codigo = n++;
+    uint8_t codigo = 1;
+    for (size_t i = 0; i < len + 2; i++) {
+        uint8_t b = i < len ? quadro[i] : i == len ? crc & 0xff : crc >> 8;
+        if (b) {
+            saida[n++] = b;
+            codigo++;
+        }
+        if (!b || codigo == 0xff) {
+            saida[pos_codigo] = codigo;
+            pos_codigo = n++;
+            codigo = 1;
+        }
+    }
+    saida[pos_codigo] = codigo;
+    saida[n++] = 0;
+    return n;
+}
@@ -0,0 +1,91 @@
+#ifndef SERIAL_QUADRO_H
+#define SERIAL_QUADRO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Protocolo binário de controle pela serial (USB CDC), para bancadas de teste automatizadas.
+// Só aritmética, sem SDK: o mesmo arquivo roda no firmware e no cliente do host.
+//
+// Cada quadro é [comando][seq][dados...][CRC-16/CCITT-FALSE little-endian], codificado em COBS
+// e cercado por 0x00 dos dois lados. Fora de um quadro, os bytes continuam sendo teclas do
+// console; como texto nunca tem 0x00, as linhas do printf convivem com as respostas.
+// A resposta repete seq e leva [comando | 0x80][seq][status][dados...].
+
+#ifndef SERIAL_QUADRO_MAX
+#define SERIAL_QUADRO_MAX 128 // quadro decodificado, com o CRC
+#endif
+#define SERIAL_DADOS_MAX (SERIAL_QUADRO_MAX - 5) // descontados comando, seq, status e CRC
+#define SERIAL_CODIFICADO_MAX(n) ((n) + 2 + ((n) + 2) / 254 + 3) // n bytes + CRC em COBS com os dois 0x00
+#define SERIAL_RESPOSTA 0x80
+
+typedef enum {
+    SERIAL_CMD_ECO = 1,      // devolve os dados
+    SERIAL_CMD_COMANDOS,     // pares [serial_atuador_t][0|1] aplicados num único lote; responde o estado
+    SERIAL_CMD_ESTADO,       // serial_estado_t
+    SERIAL_CMD_METRICAS,     // [contadores][histogramas enviados], contadores u32 e depois (n, max_us) u32 dos primeiros histogramas que cabem
+    SERIAL_CMD_TELA,         // [tela_t] ou [tela_t][matriz_padrao_t]
+} serial_comando_t;
+
+typedef enum {
+    SERIAL_OK,
+    SERIAL_DESCONHECIDO,
+    SERIAL_TAMANHO_INVALIDO,
+    SERIAL_OCUPADO,          // fila do core1 cheia; pode repetir
+    SERIAL_NAO_SUPORTADO,    // recurso desligado na compilação
+} serial_status_t;
+
+// Mesma ordem dos atuadores de /api/commands
+typedef enum {
+    SERIAL_RED,
+    SERIAL_GREEN,
+    SERIAL_BLUE,
+    SERIAL_BUZZER,
+    SERIAL_ALARME,
+    SERIAL_NUM_ATUADORES
+} serial_atuador_t;
+
+// Dados da resposta a SERIAL_CMD_ESTADO e SERIAL_CMD_COMANDOS
+typedef enum {
+    SERIAL_ESTADO_ALARME,
+    SERIAL_ESTADO_PADRAO,
+    SERIAL_ESTADO_TOM,
+    SERIAL_ESTADO_R,
+    SERIAL_ESTADO_G,
+    SERIAL_ESTADO_B,
+    SERIAL_ESTADO_SAIDAS, // bit i = atuador i (red, green, blue, buzzer) ligado
+    SERIAL_ESTADO_TAM
+} serial_estado_t;
+
+typedef enum {
+    SERIAL_NADA,
+    SERIAL_TECLA,  // byte fora de quadro: segue para o console
+    SERIAL_QUADRO, // d->quadro tem d->len bytes válidos, já sem o CRC
+    SERIAL_ERRO,   // quadro descartado (CRC, COBS malformado ou grande demais)
+} serial_evento_t;
+
+// Decodificador incremental: COBS desfeito byte a byte, direto no buffer final
+typedef struct {
+    bool em_quadro;
+    bool estourou;
+    bool descartando;   // último quadro inválido: o trecho seguinte também é descartado
+    bool zero_pendente; // fim de bloco COBS curto: vale um 0x00 se o quadro continuar
+    uint8_t restante;   // bytes de dados até o próximo código COBS
+    uint8_t codigo;
+    uint16_t len;
+    uint8_t quadro[SERIAL_QUADRO_MAX];
+    uint32_t quadros;
+    uint32_t erros_crc;
+    uint32_t erros_formato;
+} serial_decodificador_t;
+
+uint16_t serial_crc16(const uint8_t *dados, size_t len);
+
+void serial_decodificador_init(serial_decodificador_t *d);
+serial_evento_t serial_decodificar(serial_decodificador_t *d, uint8_t byte);
+
+// Acrescenta o CRC, codifica em COBS e cerca com 0x00; retorna o tamanho ou 0 se não couber
+size_t serial_codificar(const uint8_t *quadro, size_t len, uint8_t *saida, size_t max);
+
+#endif
@@ -0,0 +1,75 @@
+#include "pico/stdlib.h"
+#include "hardware/pwm.h"
+#include "hardware/clocks.h"
+#include "hardware/irq.h"
+#include "bitdoglab.h"
+#include "sirene.h"
+#include "led_rgb.h"
+
+static uint slice_buzzer;
+static uint canal_buzzer;
+static sirene_seq_t seq;
+static uint16_t freq_atual;
+
+// TOP e nível são registradores com buffer duplo: a troca só vale no próximo wrap, sem glitch
+static void sirene_aplicar_passo(void) {
+    uint16_t freq = sirene_seq_avancar(&seq);
+    if (freq == freq_atual) return;
+    freq_atual = freq;
+    sirene_pwm_t p = sirene_calcular_pwm(freq);
+    if (p.top) {
+        pwm_set_wrap(slice_buzzer, p.top);
+        led_rgb_atualizar_top(slice_buzzer, p.top);
+    }
+    pwm_set_chan_level(slice_buzzer, canal_buzzer, p.nivel);
+}
+
+// Compartilhada com outras fatias: só trata o wrap da fatia de tick
+static void sirene_irq(void) {
+    if (!(pwm_get_irq_status_mask() & (1u << SIRENE_SLICE_TICK))) return;
+    pwm_clear_irq(SIRENE_SLICE_TICK);
+    sirene_aplicar_passo();
+}
+
+void sirene_iniciar(void) {
+    float divisor = (float)clock_get_hz(clk_sys) / SIRENE_CONTAGEM_HZ;
+
+    gpio_set_function(BUZZER, GPIO_FUNC_PWM);
+    slice_buzzer = pwm_gpio_to_slice_num(BUZZER);
+    canal_buzzer = pwm_gpio_to_channel(BUZZER);
+    pwm_config c = pwm_get_default_config();
+    pwm_config_set_clkdiv(&c, divisor);
+    pwm_config_set_wrap(&c, SIRENE_TOP_REPOUSO);
+    pwm_init(slice_buzzer, &c, true);
+    pwm_set_chan_level(slice_buzzer, canal_buzzer, 0);
+    led_rgb_atualizar_top(slice_buzzer, SIRENE_TOP_REPOUSO);
+
+    pwm_config t = pwm_get_default_config();
+    pwm_config_set_clkdiv(&t, divisor);
+    pwm_config_set_wrap(&t, SIRENE_CONTAGEM_HZ / SIRENE_TICK_HZ - 1);
+    pwm_init(SIRENE_SLICE_TICK, &t, false);
+    pwm_clear_irq(SIRENE_SLICE_TICK);
+    pwm_set_irq_enabled(SIRENE_SLICE_TICK, true);
+    irq_add_shared_handler(PWM_IRQ_WRAP, sirene_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(PWM_IRQ_WRAP, true);
+}
+
+// Chamadas no core1 fora da interrupção: a fatia de tick fica parada durante a troca
+void sirene_tocar(tom_t tom) {
+    pwm_set_enabled(SIRENE_SLICE_TICK, false);
+    pwm_clear_irq(SIRENE_SLICE_TICK);
+    sirene_seq_init(&seq, tom);
+    freq_atual = UINT16_MAX;
+    sirene_aplicar_passo();
+    pwm_set_counter(SIRENE_SLICE_TICK, 0);
+    pwm_set_enabled(SIRENE_SLICE_TICK, true);
+}
+
+void sirene_parar(void) {
+    pwm_set_enabled(SIRENE_SLICE_TICK, false);
+    pwm_clear_irq(SIRENE_SLICE_TICK);
+    pwm_set_chan_level(slice_buzzer, canal_buzzer, 0);
+    pwm_set_wrap(slice_buzzer, SIRENE_TOP_REPOUSO);
+    led_rgb_atualizar_top(slice_buzzer, SIRENE_TOP_REPOUSO);
+    freq_atual = 0;
+}
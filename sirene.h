@@ -0,0 +1,20 @@
+#ifndef SIRENE_H
+#define SIRENE_H
+
+#include "sirene_seq.h"
+
+// Motor de tons do buzzer em PWM. Roda inteiramente no core1: a fatia do buzzer gera
+// a onda quadrada e a interrupção de wrap de uma segunda fatia avança a varredura.
+
+#ifndef SIRENE_SLICE_TICK
+#define SIRENE_SLICE_TICK 0 // fatia sem pinos usados na placa, serve só de base de tempo
+#endif
+
+// TOP com o buzzer mudo: mantém um PWM de 1 kHz para o LED verde, que divide a fatia
+#define SIRENE_TOP_REPOUSO 999
+
+void sirene_iniciar(void);
+void sirene_tocar(tom_t tom);
+void sirene_parar(void);
+
+#endif
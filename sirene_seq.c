@@ -0,0 +1,65 @@
+#include <string.h>
+#include "sirene_seq.h"
+
+#define MS(x) ((x) * SIRENE_TICK_HZ / 1000)
+
+static const sirene_segmento_t SEG_CONTINUO[] = {{2700, 2700, MS(1000)}};
+static const sirene_segmento_t SEG_TEMPORAL3[] = {
+    {2700, 2700, MS(500)}, {0, 0, MS(500)},
+    {2700, 2700, MS(500)}, {0, 0, MS(500)},
+    {2700, 2700, MS(500)}, {0, 0, MS(1500)},
+};
+static const sirene_segmento_t SEG_VARREDURA[] = {{500, 1200, MS(1000)}, {0, 0, MS(500)}};
+static const sirene_segmento_t SEG_YELP[] = {{800, 1600, MS(150)}, {1600, 800, MS(150)}};
+static const sirene_segmento_t SEG_BITONAL[] = {{554, 554, MS(100)}, {440, 440, MS(400)}};
+
+static const struct {
+    const char *nome;
+    const sirene_segmento_t *segmentos;
+    uint8_t num_segmentos;
+} TONS[NUM_TONS] = {
+    [TOM_CONTINUO] = {"continuo", SEG_CONTINUO, sizeof(SEG_CONTINUO) / sizeof(SEG_CONTINUO[0])},
+    [TOM_TEMPORAL3] = {"temporal3", SEG_TEMPORAL3, sizeof(SEG_TEMPORAL3) / sizeof(SEG_TEMPORAL3[0])},
+    [TOM_VARREDURA] = {"varredura", SEG_VARREDURA, sizeof(SEG_VARREDURA) / sizeof(SEG_VARREDURA[0])},
+    [TOM_YELP] = {"yelp", SEG_YELP, sizeof(SEG_YELP) / sizeof(SEG_YELP[0])},
+    [TOM_BITONAL] = {"bitonal", SEG_BITONAL, sizeof(SEG_BITONAL) / sizeof(SEG_BITONAL[0])},
+};
+
+void sirene_seq_init(sirene_seq_t *s, tom_t tom) {
+    if (tom >= NUM_TONS) tom = TOM_CONTINUO;
+    s->segmentos = TONS[tom].segmentos;
+    s->num_segmentos = TONS[tom].num_segmentos;
+    s->indice = 0;
+    s->tick = 0;
+}
+
+uint16_t sirene_seq_avancar(sirene_seq_t *s) {
+    const sirene_segmento_t *seg = &s->segmentos[s->indice];
+    int32_t delta = (int32_t)seg->freq_fim_hz - seg->freq_ini_hz;
+    uint16_t freq = seg->freq_ini_hz + delta * s->tick / seg->duracao_ticks;
+    if (++s->tick >= seg->duracao_ticks) {
+        s->tick = 0;
+        if (++s->indice >= s->num_segmentos) s->indice = 0;
+    }
+    return freq;
+}
+
+sirene_pwm_t sirene_calcular_pwm(uint16_t freq_hz) {
+    sirene_pwm_t p = {0, 0};
+    if (freq_hz == 0) return p;
+    if (freq_hz < SIRENE_FREQ_MIN_HZ) freq_hz = SIRENE_FREQ_MIN_HZ;
+    p.top = SIRENE_CONTAGEM_HZ / freq_hz - 1;
+    p.nivel = (p.top + 1) / 2;
+    return p;
+}
+
+const char *sirene_nome_tom(tom_t tom) {
+    return tom < NUM_TONS ? TONS[tom].nome : "";
+}
+
+tom_t sirene_tom_por_nome(const char *nome, int len) {
+    for (int i = 0; i < NUM_TONS; i++) {
+        if ((int)strlen(TONS[i].nome) == len && strncmp(TONS[i].nome, nome, len) == 0) return i;
+    }
+    return NUM_TONS;
+}
@@ -0,0 +1,50 @@
+#ifndef SIRENE_SEQ_H
+#define SIRENE_SEQ_H
+
+#include <stdint.h>
+
+// Sequenciador de tons da sirene: só aritmética, sem SDK, para rodar também no host
+
+#define SIRENE_CONTAGEM_HZ 1000000 // contador do PWM do buzzer após o divisor
+#define SIRENE_TICK_HZ 100         // passos de varredura por segundo
+#define SIRENE_FREQ_MIN_HZ 16      // abaixo disso o TOP não cabe em 16 bits
+
+typedef enum {
+    TOM_CONTINUO,  // 2,7 kHz fixo (buzzer=1 e alarme acompanhando o padrão de luz)
+    TOM_TEMPORAL3, // ISO 8201: três bipes de 0,5 s e pausa de 1,5 s
+    TOM_VARREDURA, // "whoop": subida de 500 a 1200 Hz em 1 s e pausa
+    TOM_YELP,      // sobe e desce entre 800 e 1600 Hz a cada 0,3 s
+    TOM_BITONAL,   // NF S 32-001: 554 Hz por 0,1 s e 440 Hz por 0,4 s
+    NUM_TONS
+} tom_t;
+
+// Rampa linear de freq_ini_hz a freq_fim_hz; frequência 0 = silêncio
+typedef struct {
+    uint16_t freq_ini_hz;
+    uint16_t freq_fim_hz;
+    uint16_t duracao_ticks;
+} sirene_segmento_t;
+
+typedef struct {
+    const sirene_segmento_t *segmentos;
+    uint8_t num_segmentos;
+    uint8_t indice;
+    uint16_t tick;
+} sirene_seq_t;
+
+typedef struct {
+    uint16_t top;   // 0 = manter o TOP anterior (silêncio)
+    uint16_t nivel; // ciclo de trabalho de 50% ou 0
+} sirene_pwm_t;
+
+void sirene_seq_init(sirene_seq_t *s, tom_t tom);
+
+// Frequência do tick atual; avança e volta ao início da tabela no fim
+uint16_t sirene_seq_avancar(sirene_seq_t *s);
+
+sirene_pwm_t sirene_calcular_pwm(uint16_t freq_hz);
+
+const char *sirene_nome_tom(tom_t tom);
+tom_t sirene_tom_por_nome(const char *nome, int len); // NUM_TONS se não existir
+
+#endif
@@ -0,0 +1,61 @@
+#include "som.h"
+
+static uint32_t raiz_inteira(uint64_t v) {
+    uint64_t r = 0;
+    uint64_t bit = 1ull << 62;
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= r + bit) {
+            v -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)r;
+}
+
+// Uma passada: soma e soma dos quadrados dão média e variância sem guardar nada
+som_bloco_t som_analisar_bloco(const uint16_t *amostras, uint32_t n) {
+    som_bloco_t b = {0, 0, 0};
+    if (n == 0) return b;
+    uint32_t soma = 0;
+    uint64_t soma_quadrados = 0;
+    uint16_t minimo = UINT16_MAX, maximo = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        uint16_t a = amostras[i] & 0x0fff;
+        soma += a;
+        soma_quadrados += (uint32_t)a * a;
+        if (a < minimo) minimo = a;
+        if (a > maximo) maximo = a;
+    }
+    uint32_t media = soma / n;
+    // n·Σx² − (Σx)² evita perder a parte fracionária da média antes da divisão
+    uint64_t variancia_n2 = n * soma_quadrados - (uint64_t)soma * soma;
+    b.rms = raiz_inteira(variancia_n2) / n;
+    b.dc = media;
+    b.pico = maximo - media > media - minimo ? maximo - media : media - minimo;
+    return b;
+}
+
+void som_detector_init(som_detector_t *d, uint16_t limiar_rms, uint16_t blocos_necessarios) {
+    d->limiar_rms = limiar_rms;
+    d->blocos_necessarios = blocos_necessarios ? blocos_necessarios : 1;
+    d->contagem = 0;
+    d->disparado = false;
+}
+
+bool som_detector_atualizar(som_detector_t *d, uint16_t rms) {
+    if (rms >= d->limiar_rms) {
+        if (d->contagem < d->blocos_necessarios) d->contagem++;
+    } else {
+        d->contagem = d->contagem > 2 ? d->contagem - 2 : 0;
+        if (d->contagem == 0) d->disparado = false;
+    }
+    if (d->contagem >= d->blocos_necessarios && !d->disparado) {
+        d->disparado = true;
+        return true;
+    }
+    return false;
+}
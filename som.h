@@ -0,0 +1,32 @@
+#ifndef SOM_H
+#define SOM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Análise de nível sonoro em ponto fixo: só aritmética inteira, sem SDK, para rodar também no host
+
+typedef struct {
+    uint16_t rms;  // em contagens do ADC de 12 bits, sem o nível DC
+    uint16_t pico; // maior desvio absoluto em relação à média do bloco
+    uint16_t dc;   // média do bloco (polarização do microfone)
+} som_bloco_t;
+
+// RMS e pico do componente AC de um bloco de amostras de 12 bits (n até 65535)
+som_bloco_t som_analisar_bloco(const uint16_t *amostras, uint32_t n);
+
+// Dispara quando o RMS fica acima do limiar por blocos_necessarios blocos seguidos.
+// Blocos abaixo do limiar descontam dois, então ruído intermitente não acumula.
+typedef struct {
+    uint16_t limiar_rms;
+    uint16_t blocos_necessarios;
+    uint16_t contagem;
+    bool disparado; // rearmado quando o nível volta a zero
+} som_detector_t;
+
+void som_detector_init(som_detector_t *d, uint16_t limiar_rms, uint16_t blocos_necessarios);
+
+// Retorna true apenas no bloco em que o nível sustentado é atingido
+bool som_detector_atualizar(som_detector_t *d, uint16_t rms);
+
+#endif
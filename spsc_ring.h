@@ -0,0 +1,52 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// Fila circular sem trava para exatamente um produtor e um consumidor.
+// Só depende de C11 (stdatomic), então roda igual entre os dois núcleos do RP2040
+// ou entre duas threads no Linux. A capacidade precisa ser potência de 2.
+typedef struct {
+    _Atomic uint32_t cabeca;  // escrita apenas pelo produtor
+    _Atomic uint32_t cauda;   // escrita apenas pelo consumidor
+    uint32_t mascara;
+    uint32_t tam_elemento;
+    uint8_t *dados;
+} spsc_ring_t;
+
+static inline void spsc_ring_init(spsc_ring_t *r, void *dados, uint32_t capacidade, uint32_t tam_elemento) {
+    atomic_init(&r->cabeca, 0);
+    atomic_init(&r->cauda, 0);
+    r->mascara = capacidade - 1;
+    r->tam_elemento = tam_elemento;
+    r->dados = (uint8_t*)dados;
+}
+
+static inline bool spsc_ring_push(spsc_ring_t *r, const void *elemento) {
+    uint32_t cabeca = atomic_load_explicit(&r->cabeca, memory_order_relaxed);
+    uint32_t cauda = atomic_load_explicit(&r->cauda, memory_order_acquire);
+    if (cabeca - cauda > r->mascara) return false;
+    memcpy(r->dados + (cabeca & r->mascara) * r->tam_elemento, elemento, r->tam_elemento);
+    // release: o conteúdo fica visível antes da nova cabeça
+    atomic_store_explicit(&r->cabeca, cabeca + 1, memory_order_release);
+    return true;
+}
+
+static inline bool spsc_ring_pop(spsc_ring_t *r, void *elemento) {
+    uint32_t cauda = atomic_load_explicit(&r->cauda, memory_order_relaxed);
+    uint32_t cabeca = atomic_load_explicit(&r->cabeca, memory_order_acquire);
+    if (cabeca == cauda) return false;
+    memcpy(elemento, r->dados + (cauda & r->mascara) * r->tam_elemento, r->tam_elemento);
+    // release: o slot só é devolvido ao produtor depois de copiado
+    atomic_store_explicit(&r->cauda, cauda + 1, memory_order_release);
+    return true;
+}
+
+static inline uint32_t spsc_ring_ocupacao(spsc_ring_t *r) {
+    return atomic_load_explicit(&r->cabeca, memory_order_acquire) - atomic_load_explicit(&r->cauda, memory_order_acquire);
+}
+
+#endif
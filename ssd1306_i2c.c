@@ -19,23 +19,33 @@ void ssd1306_send_command(uint8_t command) {
     i2c_write_blocking(i2c1, ssd1306_i2c_address, buffer, 2, false);
 }
 
-// Envia uma lista de comandos ao hardware
+// Envia uma lista de comandos ao hardware numa única transação: com Co=0 o byte de
+// controle 0x00 vale para todos os bytes seguintes
 void ssd1306_send_command_list(uint8_t *ssd, int number) {
-    for (int i = 0; i < number; i++) {
-        ssd1306_send_command(ssd[i]);
+    uint8_t buffer[1 + 32];
+    buffer[0] = 0x00;
+    while (number > 0) {
+        int n = number < 32 ? number : 32;
+        memcpy(buffer + 1, ssd, n);
+        i2c_write_blocking(i2c1, ssd1306_i2c_address, buffer, n + 1, false);
+        ssd += n;
+        number -= n;
     }
 }
 
-// Copia buffer de referência num novo buffer, a fim de adicionar o byte de controle desde o início
-void ssd1306_send_buffer(uint8_t ssd[], int buffer_length) {
+// Copia buffer de referência num novo buffer, a fim de adicionar o byte de controle desde o início.
+// Retorna o resultado do i2c_write_blocking (negativo se o display não respondeu)
+int ssd1306_send_buffer(uint8_t ssd[], int buffer_length) {
     uint8_t *temp_buffer = malloc(buffer_length + 1);
+    if (!temp_buffer) return PICO_ERROR_GENERIC;
 
     temp_buffer[0] = 0x40;
     memcpy(temp_buffer + 1, ssd, buffer_length);
 
-    i2c_write_blocking(i2c1, ssd1306_i2c_address, temp_buffer, buffer_length + 1, false);
+    int ret = i2c_write_blocking(i2c1, ssd1306_i2c_address, temp_buffer, buffer_length + 1, false);
 
     free(temp_buffer);
+    return ret;
 }
 
 // Cria a lista de comandos (com base nos endereços definidos em ssd1306_i2c.h) para a inicialização do display
@@ -74,15 +84,15 @@ void ssd1306_scroll(bool set) {
     ssd1306_send_command_list(commands, count_of(commands));
 }
 
-// Atualiza uma parte do display com uma área de renderização
-void render_on_display(uint8_t *ssd, struct render_area *area) {
+// Atualiza uma parte do display com uma área de renderização; retorna o resultado do envio dos pixels
+int render_on_display(uint8_t *ssd, struct render_area *area) {
     uint8_t commands[] = {
         ssd1306_set_column_address, area->start_column, area->end_column,
         ssd1306_set_page_address, area->start_page, area->end_page
     };
 
     ssd1306_send_command_list(commands, count_of(commands));
-    ssd1306_send_buffer(ssd, area->buffer_length);
+    return ssd1306_send_buffer(ssd, area->buffer_length);
 }
 
 // Determina o pixel a ser aceso (no display) de acordo com a coordenada fornecida
@@ -174,6 +184,19 @@ void ssd1306_draw_string(uint8_t *ssd, int16_t x, int16_t y, char *string) {
     }
 }
 
+// Desenha uma string ampliada repetindo cada caractere deslocado em x e y
+void ssd1306_draw_string_scaled(uint8_t *ssd, int x, int y, const char *text, int scale) {
+    while (*text) {
+        for (int dx = 0; dx < scale; dx++) {
+            for (int dy = 0; dy < scale; dy++) {
+                ssd1306_draw_char(ssd, x + dx, y + dy, *text);
+            }
+        }
+        x += 6 * scale;
+        text++;
+    }
+}
+
 // Comando de configuração com base na estrutura ssd1306_t
 void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
   ssd->port_buffer[1] = command;
@@ -0,0 +1,123 @@
+#include <stdio.h>
+#include <string.h>
+#include "sse.h"
+
+#define SSE_POLL_INTERVALO 10 // em ticks de 500 ms do lwIP
+
+static const char SSE_HEADERS[] =
+    "HTTP/1.1 200 OK\nContent-Type: text/event-stream\nCache-Control: no-cache\nConnection: keep-alive\n\n";
+static const char SSE_KEEPALIVE[] = ":\n\n";
+
+typedef struct {
+    struct tcp_pcb *pcb;
+    uint32_t seq; // última mensagem entregue a este assinante
+} sse_assinante_t;
+
+static sse_assinante_t assinantes[SSE_MAX_ASSINANTES];
+
+// Única cópia serializada do último evento; cada assinante só guarda a sequência
+static char mensagem[SSE_TAM_MENSAGEM];
+static int mensagem_len;
+static uint32_t mensagem_seq;
+
+static err_t sse_remover(sse_assinante_t *a) {
+    struct tcp_pcb *pcb = a->pcb;
+    err_t err = ERR_OK;
+    a->pcb = NULL;
+    tcp_arg(pcb, NULL);
+    tcp_recv(pcb, NULL);
+    tcp_sent(pcb, NULL);
+    tcp_poll(pcb, NULL, 0);
+    tcp_err(pcb, NULL);
+    if (tcp_close(pcb) != ERR_OK) {
+        tcp_abort(pcb);
+        err = ERR_ABRT;
+    }
+    return err;
+}
+
+// Assinante lento não acumula fila: quando houver espaço recebe apenas o estado mais recente
+static void sse_enviar_pendente(sse_assinante_t *a) {
+    if (a->seq == mensagem_seq || mensagem_len == 0) return;
+    if (tcp_sndbuf(a->pcb) < mensagem_len) return;
+    if (tcp_write(a->pcb, mensagem, mensagem_len, TCP_WRITE_FLAG_COPY) == ERR_OK) {
+        a->seq = mensagem_seq;
+        tcp_output(a->pcb);
+    }
+}
+
+static err_t sse_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err) {
+    sse_assinante_t *a = (sse_assinante_t*)arg;
+    if (!p) return sse_remover(a);
+    tcp_recved(pcb, p->tot_len);
+    pbuf_free(p);
+    return ERR_OK;
+}
+
+static err_t sse_sent(void *arg, struct tcp_pcb *pcb, u16_t len) {
+    sse_enviar_pendente((sse_assinante_t*)arg);
+    return ERR_OK;
+}
+
+// Comentário periódico mantém o navegador conectado e revela clientes que sumiram
+static err_t sse_poll(void *arg, struct tcp_pcb *pcb) {
+    sse_assinante_t *a = (sse_assinante_t*)arg;
+    if (a->seq != mensagem_seq) {
+        sse_enviar_pendente(a);
+    } else if (tcp_write(pcb, SSE_KEEPALIVE, sizeof(SSE_KEEPALIVE) - 1, 0) == ERR_OK) {
+        tcp_output(pcb);
+    }
+    return ERR_OK;
+}
+
+static void sse_err(void *arg, err_t err) {
+    sse_assinante_t *a = (sse_assinante_t*)arg;
+    if (a) a->pcb = NULL;
+}
+
+err_t sse_assinar(struct tcp_pcb *pcb) {
+    sse_assinante_t *a = NULL;
+    for (int i = 0; i < SSE_MAX_ASSINANTES; i++) {
+        if (!assinantes[i].pcb) {
+            a = &assinantes[i];
+            break;
+        }
+    }
+    if (!a) return ERR_MEM;
+
+    a->pcb = pcb;
+    a->seq = mensagem_seq - 1; // força o envio do estado atual
+    tcp_arg(pcb, a);
+    tcp_recv(pcb, sse_recv);
+    tcp_sent(pcb, sse_sent);
+    tcp_poll(pcb, sse_poll, SSE_POLL_INTERVALO);
+    tcp_err(pcb, sse_err);
+    if (tcp_write(pcb, SSE_HEADERS, sizeof(SSE_HEADERS) - 1, 0) != ERR_OK) {
+        return sse_remover(a);
+    }
+    sse_enviar_pendente(a);
+    tcp_output(pcb);
+    return ERR_OK;
+}
+
+void sse_publicar(const char *evento, const char *dados) {
+    char nova[SSE_TAM_MENSAGEM];
+    int len = snprintf(nova, sizeof(nova), "event: %s\ndata: %s\n\n", evento, dados);
+    if (len <= 0 || len >= (int)sizeof(nova)) return;
+    if (len == mensagem_len && memcmp(nova, mensagem, len) == 0) return;
+
+    memcpy(mensagem, nova, len);
+    mensagem_len = len;
+    mensagem_seq++;
+    for (int i = 0; i < SSE_MAX_ASSINANTES; i++) {
+        if (assinantes[i].pcb) sse_enviar_pendente(&assinantes[i]);
+    }
+}
+
+int sse_num_assinantes(void) {
+    int n = 0;
+    for (int i = 0; i < SSE_MAX_ASSINANTES; i++) {
+        if (assinantes[i].pcb) n++;
+    }
+    return n;
+}
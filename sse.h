@@ -0,0 +1,23 @@
+#ifndef SSE_H
+#define SSE_H
+
+#include "lwip/tcp.h"
+
+#ifndef SSE_MAX_ASSINANTES
+#define SSE_MAX_ASSINANTES 8 // conexões text/event-stream mantidas abertas
+#endif
+
+#define SSE_TAM_MENSAGEM 160
+
+// Assume o pcb de uma requisição já lida e responde com o cabeçalho text/event-stream.
+// ERR_MEM: sem vaga, o pcb continua com quem chamou. Qualquer outro valor: o pcb
+// passou a ser deste módulo e o valor deve ser devolvido pelo callback de recv.
+err_t sse_assinar(struct tcp_pcb *pcb);
+
+// Serializa o evento uma única vez e o distribui a todos os assinantes.
+// Deve ser chamada no contexto do lwIP (ou entre cyw43_arch_lwip_begin/end).
+void sse_publicar(const char *evento, const char *dados);
+
+int sse_num_assinantes(void);
+
+#endif
@@ -0,0 +1,30 @@
+#include "pico/stdlib.h"
+#include "temperatura.h"
+#include "microfone.h"
+
+static temperatura_filtro_t filtro;
+static uint32_t atualizado_ms;
+static void (*disparar_alarme)(void);
+
+// Chamado pelo worker do microfone, no contexto do async_context
+static void temperatura_bloco(uint32_t soma, uint32_t n) {
+    atualizado_ms = to_ms_since_boot(get_absolute_time());
+    if (temperatura_filtro_atualizar(&filtro, temperatura_mc_de_contagens(soma, n)) && disparar_alarme) {
+        disparar_alarme();
+    }
+}
+
+void temperatura_iniciar(void (*disparar)(void)) {
+    disparar_alarme = disparar;
+    temperatura_filtro_init(&filtro, TEMP_LIMIAR_MC, TEMP_HISTERESE_MC);
+    microfone_observar_temperatura(temperatura_bloco);
+}
+
+void temperatura_configurar(int32_t limiar_mc) {
+    temperatura_filtro_limiar(&filtro, limiar_mc, filtro.histerese_mc);
+}
+
+void temperatura_leitura(temperatura_leitura_t *l) {
+    l->filtro = filtro;
+    l->idade_ms = filtro.blocos ? to_ms_since_boot(get_absolute_time()) - atualizado_ms : UINT32_MAX;
+}
@@ -0,0 +1,21 @@
+#ifndef TEMPERATURA_H
+#define TEMPERATURA_H
+
+#include <stdint.h>
+#include "temperatura_filtro.h"
+
+// Sensor interno de temperatura lido em segundo plano: o ADC alterna entre o microfone e o
+// sensor (ver microfone.c), e cada bloco de 32 ms traz SOM_BLOCO leituras do sensor, somadas
+// antes de entrar no filtro. Quem consulta só copia o último valor filtrado.
+
+typedef struct {
+    temperatura_filtro_t filtro;
+    uint32_t idade_ms; // desde o último bloco; UINT32_MAX se nenhum chegou ainda
+} temperatura_leitura_t;
+
+// disparar é chamado no contexto do async_context quando a média cruza o limiar
+void temperatura_iniciar(void (*disparar)(void));
+void temperatura_configurar(int32_t limiar_mc);
+void temperatura_leitura(temperatura_leitura_t *l);
+
+#endif
@@ -0,0 +1,41 @@
+#include "temperatura_filtro.h"
+
+void temperatura_filtro_init(temperatura_filtro_t *f, int32_t limiar_mc, int32_t histerese_mc) {
+    *f = (temperatura_filtro_t){0};
+    temperatura_filtro_limiar(f, limiar_mc, histerese_mc);
+}
+
+void temperatura_filtro_limiar(temperatura_filtro_t *f, int32_t limiar_mc, int32_t histerese_mc) {
+    f->limiar_mc = limiar_mc;
+    f->histerese_mc = histerese_mc;
+    // Um limiar novo abaixo da média atual dispara no próximo bloco
+    f->acima = f->acima && f->mc >= limiar_mc - histerese_mc;
+}
+
+int32_t temperatura_mc_de_contagens(uint32_t soma, uint32_t n) {
+    if (!n) return 0;
+    int64_t uv = (int64_t)soma * 3300000 / ((int64_t)4096 * n);
+    return 27000 - (int32_t)((uv - 706000) * 1000 / 1721);
+}
+
+bool temperatura_filtro_atualizar(temperatura_filtro_t *f, int32_t mc) {
+    f->ultimo_mc = mc;
+    if (!f->blocos++) {
+        // O primeiro bloco já é a melhor estimativa: sem isso a média partiria de 0 °C
+        f->acumulador = mc * (1 << TEMP_EMA_SHIFT);
+        f->min_mc = f->max_mc = mc;
+    } else {
+        f->acumulador += mc - f->acumulador / (1 << TEMP_EMA_SHIFT);
+    }
+    f->mc = f->acumulador / (1 << TEMP_EMA_SHIFT);
+    if (f->mc < f->min_mc) f->min_mc = f->mc;
+    if (f->mc > f->max_mc) f->max_mc = f->mc;
+
+    if (!f->acima && f->mc >= f->limiar_mc) {
+        f->acima = true;
+        f->disparos++;
+        return true;
+    }
+    if (f->acima && f->mc < f->limiar_mc - f->histerese_mc) f->acima = false;
+    return false;
+}
@@ -0,0 +1,46 @@
+#ifndef TEMPERATURA_FILTRO_H
+#define TEMPERATURA_FILTRO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Sensor interno de temperatura do RP2040 em ponto fixo: só aritmética inteira, sem SDK, para
+// rodar também no host. Cada bloco sobreamostrado vira m°C, passa por uma média móvel
+// exponencial e é comparado a um limiar com histerese.
+
+#ifndef TEMP_EMA_SHIFT
+#define TEMP_EMA_SHIFT 5 // alfa = 1/32 por bloco; a 31 blocos/s a constante de tempo é ~1 s
+#endif
+#ifndef TEMP_LIMIAR_MC
+#define TEMP_LIMIAR_MC 70000 // gabinete elétrico quente demais
+#endif
+#define TEMP_LIMIAR_MIN_MC 20000  // limiar configurável: abaixo disso a placa dispararia parada
+#define TEMP_LIMIAR_MAX_MC 110000 // e acima o RP2040 já passou da faixa de operação (85 °C)
+#ifndef TEMP_HISTERESE_MC
+#define TEMP_HISTERESE_MC 3000 // rearma só depois de esfriar isto abaixo do limiar
+#endif
+
+typedef struct {
+    int32_t acumulador; // EMA multiplicada por 2^TEMP_EMA_SHIFT, sem perder os bits baixos
+    int32_t mc;         // EMA em m°C
+    int32_t ultimo_mc;  // último bloco, sem filtro
+    int32_t min_mc;     // extremos da média desde a partida
+    int32_t max_mc;
+    int32_t limiar_mc;
+    int32_t histerese_mc;
+    uint32_t blocos;
+    uint32_t disparos;
+    bool acima;
+} temperatura_filtro_t;
+
+void temperatura_filtro_init(temperatura_filtro_t *f, int32_t limiar_mc, int32_t histerese_mc);
+void temperatura_filtro_limiar(temperatura_filtro_t *f, int32_t limiar_mc, int32_t histerese_mc);
+
+// Média de n leituras de 12 bits (soma) convertida para m°C pela fórmula do datasheet:
+// T = 27 - (V - 0,706) / 0,001721, com Vref de 3,3 V
+int32_t temperatura_mc_de_contagens(uint32_t soma, uint32_t n);
+
+// Retorna true apenas no bloco em que a média cruza o limiar para cima
+bool temperatura_filtro_atualizar(temperatura_filtro_t *f, int32_t mc);
+
+#endif
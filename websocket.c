@@ -0,0 +1,149 @@
+#include <string.h>
+#include "websocket.h"
+
+#define ROTL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+static const char WS_GUID[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+static const char BASE64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static void sha1_bloco(uint32_t h[5], const uint8_t bloco[64]) {
+    uint32_t w[16];
+    for (int i = 0; i < 16; i++) {
+        w[i] = (uint32_t)bloco[4 * i] << 24 | (uint32_t)bloco[4 * i + 1] << 16 |
+               (uint32_t)bloco[4 * i + 2] << 8 | bloco[4 * i + 3];
+    }
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; i++) {
+        // Janela circular de 16 palavras no lugar do vetor de 80
+        if (i >= 16) {
+            uint32_t t = w[(i + 13) & 15] ^ w[(i + 8) & 15] ^ w[(i + 2) & 15] ^ w[i & 15];
+            w[i & 15] = ROTL(t, 1);
+        }
+        uint32_t f, k;
+        if (i < 20) {
+            f = (b & c) | (~b & d);
+            k = 0x5A827999;
+        } else if (i < 40) {
+            f = b ^ c ^ d;
+            k = 0x6ED9EBA1;
+        } else if (i < 60) {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8F1BBCDC;
+        } else {
+            f = b ^ c ^ d;
+            k = 0xCA62C1D6;
+        }
+        uint32_t t = ROTL(a, 5) + f + e + k + w[i & 15];
+        e = d;
+        d = c;
+        c = ROTL(b, 30);
+        b = a;
+        a = t;
+    }
+    h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+}
+
+void ws_sha1(const uint8_t *dados, size_t len, uint8_t digest[20]) {
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    uint8_t bloco[64];
+    size_t resto = len;
+    while (resto >= 64) {
+        sha1_bloco(h, dados);
+        dados += 64;
+        resto -= 64;
+    }
+
+    // Padding: 0x80, zeros e o tamanho em bits (big-endian) no final do último bloco
+    memset(bloco, 0, sizeof(bloco));
+    memcpy(bloco, dados, resto);
+    bloco[resto] = 0x80;
+    if (resto >= 56) {
+        sha1_bloco(h, bloco);
+        memset(bloco, 0, sizeof(bloco));
+    }
+    uint64_t bits = (uint64_t)len * 8;
+    for (int i = 0; i < 8; i++) {
+        bloco[63 - i] = bits >> (8 * i);
+    }
+    sha1_bloco(h, bloco);
+
+    for (int i = 0; i < 5; i++) {
+        digest[4 * i] = h[i] >> 24;
+        digest[4 * i + 1] = h[i] >> 16;
+        digest[4 * i + 2] = h[i] >> 8;
+        digest[4 * i + 3] = h[i];
+    }
+}
+
+void ws_calcular_aceite(const char *chave, size_t chave_len, char aceite[WS_ACEITE_LEN + 1]) {
+    // A chave do cliente tem 24 caracteres; o limite protege o buffer local
+    uint8_t entrada[64 + sizeof(WS_GUID)];
+    if (chave_len > 64) chave_len = 64;
+    memcpy(entrada, chave, chave_len);
+    memcpy(entrada + chave_len, WS_GUID, sizeof(WS_GUID) - 1);
+
+    uint8_t digest[21];
+    ws_sha1(entrada, chave_len + sizeof(WS_GUID) - 1, digest);
+    digest[20] = 0;
+
+    // 20 bytes = 6 grupos completos + 2 bytes finais com um '='
+    char *o = aceite;
+    for (int i = 0; i < 21; i += 3) {
+        uint32_t v = (uint32_t)digest[i] << 16 | (uint32_t)digest[i + 1] << 8 | (i + 2 < 21 ? digest[i + 2] : 0);
+        *o++ = BASE64[(v >> 18) & 0x3f];
+        *o++ = BASE64[(v >> 12) & 0x3f];
+        *o++ = BASE64[(v >> 6) & 0x3f];
+        *o++ = BASE64[v & 0x3f];
+    }
+    aceite[WS_ACEITE_LEN - 1] = '=';
+    aceite[WS_ACEITE_LEN] = 0;
+}
+
+void ws_parser_init(ws_parser_t *p) {
+    p->cab_len = 0;
+    p->payload_len = 0;
+    p->recebido = 0;
+}
+
+ws_resultado_t ws_parser_consumir(ws_parser_t *p, const uint8_t *dados, size_t len, size_t *consumido) {
+    size_t i = 0;
+    while (i < len) {
+        uint8_t b = dados[i++];
+        if (p->cab_len < sizeof(p->cab)) {
+            p->cab[p->cab_len++] = b;
+            if (p->cab_len == 2) {
+                // Exige FIN, RSV zerados, máscara do cliente e payload curto (sem fragmentação)
+                bool fin = p->cab[0] & 0x80;
+                bool rsv = p->cab[0] & 0x70;
+                bool mascarado = p->cab[1] & 0x80;
+                uint8_t tam = p->cab[1] & 0x7f;
+                if (!fin || rsv || !mascarado || tam > WS_MAX_PAYLOAD) {
+                    *consumido = i;
+                    return WS_PARSE_ERRO;
+                }
+                p->opcode = p->cab[0] & 0x0f;
+                p->payload_len = tam;
+                p->recebido = 0;
+            }
+            if (p->cab_len < sizeof(p->cab) || p->payload_len > 0) continue;
+        } else {
+            p->payload[p->recebido] = b ^ p->cab[2 + (p->recebido & 3)];
+            p->recebido++;
+            if (p->recebido < p->payload_len) continue;
+        }
+        p->payload[p->payload_len] = 0;
+        p->cab_len = 0;
+        *consumido = i;
+        return WS_PARSE_QUADRO;
+    }
+    *consumido = i;
+    return WS_PARSE_INCOMPLETO;
+}
+
+size_t ws_montar_quadro(uint8_t *out, size_t max, uint8_t opcode, const void *payload, size_t len) {
+    if (len > WS_MAX_PAYLOAD || max < len + 2) return 0;
+    out[0] = 0x80 | opcode;
+    out[1] = len;
+    if (len) memcpy(out + 2, payload, len);
+    return len + 2;
+}
@@ -0,0 +1,49 @@
+#ifndef WEBSOCKET_H
+#define WEBSOCKET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Codec RFC 6455 sem alocação e sem dependência do lwIP
+
+#define WS_ACEITE_LEN 28      // base64 de um SHA-1
+#define WS_MAX_PAYLOAD 125    // só quadros curtos: comandos e controle
+#define WS_MAX_QUADRO (2 + WS_MAX_PAYLOAD)
+
+#define WS_OP_TEXTO 0x1
+#define WS_OP_BINARIO 0x2
+#define WS_OP_FECHAR 0x8
+#define WS_OP_PING 0x9
+#define WS_OP_PONG 0xA
+
+typedef enum {
+    WS_PARSE_INCOMPLETO,
+    WS_PARSE_QUADRO,
+    WS_PARSE_ERRO,
+} ws_resultado_t;
+
+typedef struct {
+    uint8_t cab[6];       // 2 bytes de cabeçalho + máscara de 4 bytes
+    uint8_t cab_len;
+    uint8_t opcode;
+    uint8_t payload_len;
+    uint8_t recebido;
+    uint8_t payload[WS_MAX_PAYLOAD + 1]; // desmascarado e terminado em zero
+} ws_parser_t;
+
+void ws_sha1(const uint8_t *dados, size_t len, uint8_t digest[20]);
+
+// Calcula Sec-WebSocket-Accept a partir de Sec-WebSocket-Key
+void ws_calcular_aceite(const char *chave, size_t chave_len, char aceite[WS_ACEITE_LEN + 1]);
+
+void ws_parser_init(ws_parser_t *p);
+
+// Consome bytes até completar um quadro. Em WS_PARSE_QUADRO, opcode/payload ficam
+// válidos até a próxima chamada e *consumido indica onde continuar.
+ws_resultado_t ws_parser_consumir(ws_parser_t *p, const uint8_t *dados, size_t len, size_t *consumido);
+
+// Monta um quadro do servidor (sem máscara); retorna o tamanho ou 0 se não couber
+size_t ws_montar_quadro(uint8_t *out, size_t max, uint8_t opcode, const void *payload, size_t len);
+
+#endif
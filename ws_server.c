@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "ws_server.h"
+#include "websocket.h"
+
+#define WS_POLL_INTERVALO 20 // 10 s em ticks de 500 ms do lwIP
+
+static const char WS_RESPOSTA_UPGRADE[] =
+    "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Accept: %s\r\n\r\n";
+
+// Quadros binários: pares (atuador, valor), ex. {'r', 1, 'z', 0}
+static const struct {
+    uint8_t codigo;
+    const char *nome;
+} WS_ATUADORES[] = {
+    {'r', "red"}, {'g', "green"}, {'b', "blue"}, {'z', "buzzer"}, {'a', "alarme"},
+};
+
+typedef struct {
+    struct tcp_pcb *pcb;
+    ws_parser_t parser;
+} ws_cliente_t;
+
+static ws_cliente_t clientes[WS_MAX_CLIENTES];
+static ws_comando_fn tratar;
+
+static err_t ws_fechar(ws_cliente_t *c) {
+    struct tcp_pcb *pcb = c->pcb;
+    err_t err = ERR_OK;
+    c->pcb = NULL;
+    tcp_arg(pcb, NULL);
+    tcp_recv(pcb, NULL);
+    tcp_poll(pcb, NULL, 0);
+    tcp_err(pcb, NULL);
+    if (tcp_close(pcb) != ERR_OK) {
+        tcp_abort(pcb);
+        err = ERR_ABRT;
+    }
+    return err;
+}
+
+static void ws_enviar(ws_cliente_t *c, uint8_t opcode, const void *payload, size_t len) {
+    uint8_t quadro[WS_MAX_QUADRO];
+    size_t n = ws_montar_quadro(quadro, sizeof(quadro), opcode, payload, len);
+    if (n && tcp_write(c->pcb, quadro, n, TCP_WRITE_FLAG_COPY) == ERR_OK) {
+        tcp_output(c->pcb);
+    }
+}
+
+// Quadro malformado ou opcode desconhecido: close 1002 (RFC 6455 §7.4.1) e fim da conexão
+static err_t ws_erro_protocolo(ws_cliente_t *c) {
+    static const uint8_t erro_protocolo[] = {0x03, 0xEA}; // 1002
+    ws_enviar(c, WS_OP_FECHAR, erro_protocolo, sizeof(erro_protocolo));
+    return ws_fechar(c);
+}
+
+// Converte pares binários para a sintaxe dos parâmetros GET
+static bool ws_traduzir_binario(const uint8_t *dados, size_t len, char *comando, size_t max) {
+    size_t pos = 0;
+    comando[0] = 0;
+    if (len == 0 || len % 2) return false;
+    for (size_t i = 0; i < len; i += 2) {
+        const char *nome = NULL;
+        for (size_t j = 0; j < count_of(WS_ATUADORES); j++) {
+            if (WS_ATUADORES[j].codigo == dados[i]) nome = WS_ATUADORES[j].nome;
+        }
+        if (!nome) return false;
+        int n = snprintf(comando + pos, max - pos, "%s%s=%d", pos ? "&" : "", nome, dados[i + 1] ? 1 : 0);
+        if (n < 0 || (size_t)n >= max - pos) return false;
+        pos += n;
+    }
+    return true;
+}
+
+static err_t ws_tratar_quadro(ws_cliente_t *c) {
+    ws_parser_t *p = &c->parser;
+    switch (p->opcode) {
+        case WS_OP_TEXTO:
+            if (tratar((const char*)p->payload)) ws_enviar(c, WS_OP_TEXTO, "ok", 2);
+            else ws_enviar(c, WS_OP_TEXTO, "erro", 4);
+            break;
+        case WS_OP_BINARIO: {
+            char comando[96];
+            bool ok = ws_traduzir_binario(p->payload, p->payload_len, comando, sizeof(comando)) && tratar(comando);
+            uint8_t status = ok ? 0 : 1;
+            ws_enviar(c, WS_OP_BINARIO, &status, 1);
+            break;
+        }
+        case WS_OP_PING:
+            ws_enviar(c, WS_OP_PONG, p->payload, p->payload_len);
+            break;
+        case WS_OP_FECHAR:
+            ws_enviar(c, WS_OP_FECHAR, p->payload, p->payload_len >= 2 ? 2 : 0);
+            return ws_fechar(c);
+        case WS_OP_PONG:
+            break;
+        default:
+            return ws_erro_protocolo(c);
+    }
+    return ERR_OK;
+}
+
+static err_t ws_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err) {
+    ws_cliente_t *c = (ws_cliente_t*)arg;
+    if (!p) return ws_fechar(c);
+    tcp_recved(pcb, p->tot_len);
+
+    // Percorre a cadeia de pbufs sem copiar; o parser guarda o estado entre segmentos
+    err_t ret = ERR_OK;
+    for (struct pbuf *q = p; q && ret == ERR_OK && c->pcb; q = q->next) {
+        const uint8_t *dados = q->payload;
+        size_t resto = q->len;
+        while (resto > 0 && c->pcb) {
+            size_t consumido;
+            ws_resultado_t r = ws_parser_consumir(&c->parser, dados, resto, &consumido);
+            dados += consumido;
+            resto -= consumido;
+            if (r == WS_PARSE_QUADRO) {
+                ret = ws_tratar_quadro(c);
+            } else if (r == WS_PARSE_ERRO) {
+                ret = ws_erro_protocolo(c);
+            }
+        }
+    }
+    pbuf_free(p);
+    return ret;
+}
+
+// Ping periódico detecta painéis que sumiram sem fechar a conexão
+static err_t ws_poll(void *arg, struct tcp_pcb *pcb) {
+    ws_enviar((ws_cliente_t*)arg, WS_OP_PING, NULL, 0);
+    return ERR_OK;
+}
+
+static void ws_err(void *arg, err_t err) {
+    ws_cliente_t *c = (ws_cliente_t*)arg;
+    if (c) c->pcb = NULL;
+}
+
+void ws_servidor_init(ws_comando_fn tratar_comando) {
+    tratar = tratar_comando;
+}
+
+err_t ws_servidor_aceitar(struct tcp_pcb *pcb, const char *chave, size_t chave_len) {
+    ws_cliente_t *c = NULL;
+    for (int i = 0; i < WS_MAX_CLIENTES; i++) {
+        if (!clientes[i].pcb) {
+            c = &clientes[i];
+            break;
+        }
+    }
+    if (!c || !tratar) return ERR_MEM;
+
+    char aceite[WS_ACEITE_LEN + 1];
+    char resposta[sizeof(WS_RESPOSTA_UPGRADE) + WS_ACEITE_LEN];
+    ws_calcular_aceite(chave, chave_len, aceite);
+    int len = snprintf(resposta, sizeof(resposta), WS_RESPOSTA_UPGRADE, aceite);
+
+    c->pcb = pcb;
+    ws_parser_init(&c->parser);
+    tcp_arg(pcb, c);
+    tcp_recv(pcb, ws_recv);
+    tcp_sent(pcb, NULL);
+    tcp_poll(pcb, ws_poll, WS_POLL_INTERVALO);
+    tcp_err(pcb, ws_err);
+    // Comandos curtos: enviar cada ACK imediatamente em vez de esperar o Nagle
+    tcp_nagle_disable(pcb);
+    if (tcp_write(pcb, resposta, len, TCP_WRITE_FLAG_COPY) != ERR_OK) {
+        return ws_fechar(c);
+    }
+    tcp_output(pcb);
+    return ERR_OK;
+}
@@ -0,0 +1,24 @@
+#ifndef WS_SERVER_H
+#define WS_SERVER_H
+
+#include <stdbool.h>
+#include "lwip/tcp.h"
+
+#ifndef WS_MAX_CLIENTES
+#define WS_MAX_CLIENTES 4
+#endif
+
+#define WS_CHAVE_MAX 32 // Sec-WebSocket-Key: 16 bytes em base64 são 24 caracteres
+
+// Recebe o comando no formato dos parâmetros GET (ex.: "red=1&buzzer=0") e retorna
+// se algum parâmetro foi reconhecido; o ACK do quadro reflete esse resultado
+typedef bool (*ws_comando_fn)(const char *comando);
+
+void ws_servidor_init(ws_comando_fn tratar_comando);
+
+// Conclui o upgrade de uma requisição GET com Sec-WebSocket-Key.
+// ERR_MEM: sem vaga, o pcb continua com quem chamou. Qualquer outro valor: o pcb
+// passou a ser deste módulo e o valor deve ser devolvido pelo callback de recv.
+err_t ws_servidor_aceitar(struct tcp_pcb *pcb, const char *chave, size_t chave_len);
+
+#endif